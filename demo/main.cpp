@@ -1,11 +1,14 @@
 #include "../src/meshoptimizer.h"
+#include "../src/vertexcodec.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cfloat>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <map>
 
 #include "miniz.h"
 #include "objparser.h"
@@ -222,6 +225,12 @@ bool areMeshesEqual(const Mesh& lhs, const Mesh& rhs)
 	return lt.size() == rt.size() && memcmp(&lt[0], &rt[0], lt.size() * sizeof(Triangle)) == 0;
 }
 
+void parallelForSerial(void*, meshopt_ParallelTask task, void* task_data, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		task(task_data, i);
+}
+
 void optNone(Mesh& mesh)
 {
 	(void)mesh;
@@ -258,6 +267,12 @@ void optCacheFifo(Mesh& mesh)
 	meshopt_optimizeVertexCacheFifo(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), kCacheSize);
 }
 
+void optCacheParallel(Mesh& mesh)
+{
+	// partitions are optimized using parallelForSerial here; a real application would distribute them between worker threads
+	meshopt_optimizeVertexCacheParallel(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 8, parallelForSerial, 0);
+}
+
 void optOverdraw(Mesh& mesh)
 {
 	// use worst-case ACMR threshold so that overdraw optimizer can sort *all* triangles
@@ -457,6 +472,100 @@ void simplify(const Mesh& mesh)
 	}
 }
 
+void simplifyAttributes(const Mesh& mesh)
+{
+	double start = timestamp();
+
+	size_t target_index_count = size_t(mesh.indices.size() * 0.25f) / 3 * 3;
+	float target_error = 1e-2f;
+
+	// normals and texture coordinates follow the position in Vertex; weights balance attribute error against position error
+	const float attribute_weights[5] = {0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
+
+	std::vector<unsigned int> lod(mesh.indices.size());
+	lod.resize(meshopt_simplifyWithAttributes(&lod[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), &mesh.vertices[0].nx, sizeof(Vertex), attribute_weights, 5, target_index_count, target_error, 0));
+
+	double end = timestamp();
+
+	printf("%-9s: %d triangles => %d triangles in %.2f msec\n",
+	       "SimplifyA",
+	       int(mesh.indices.size() / 3), int(lod.size() / 3), (end - start) * 1000);
+}
+
+void simplifyChain(const Mesh& mesh)
+{
+	static const size_t lod_count = 4;
+
+	double start = timestamp();
+
+	// generate the same LOD levels as simplify() in one call; the levels are stored one after another
+	size_t target_index_counts[lod_count];
+	float target_errors[lod_count];
+
+	for (size_t i = 0; i < lod_count; ++i)
+	{
+		target_index_counts[i] = size_t(mesh.indices.size() * powf(0.7f, float(i + 1))) / 3 * 3;
+		target_errors[i] = 1e-3f;
+	}
+
+	std::vector<unsigned int> lods(mesh.indices.size() * lod_count);
+	size_t lod_index_counts[lod_count];
+	float lod_errors[lod_count];
+
+	lods.resize(meshopt_simplifyLodChain(&lods[0], lod_index_counts, lod_errors, &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 0, 0, 0, 0, target_index_counts, target_errors, lod_count, 0));
+
+	double end = timestamp();
+
+	for (size_t i = 1; i < lod_count; ++i)
+		assert(lod_index_counts[i] <= lod_index_counts[i - 1] && lod_errors[i] >= lod_errors[i - 1]);
+
+	printf("%-9s: %d triangles => %d LOD levels down to %d triangles (error %e) in %.2f msec\n",
+	       "SimplifyC",
+	       int(mesh.indices.size() / 3), int(lod_count), int(lod_index_counts[lod_count - 1] / 3), lod_errors[lod_count - 1], (end - start) * 1000);
+}
+
+void simplifyQueue(const Mesh& mesh)
+{
+	double start = timestamp();
+
+	size_t target_index_count = size_t(mesh.indices.size() * 0.25f) / 3 * 3;
+	float target_error = 1e-2f;
+
+	// priority queue schedules collapses one at a time in the order of increasing error instead of running collapse passes
+	std::vector<unsigned int> lod(mesh.indices.size());
+	lod.resize(meshopt_simplifyWithAttributes(&lod[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 0, 0, 0, 0, target_index_count, target_error, meshopt_SimplifyPriorityQueue));
+
+	double middle = timestamp();
+
+	// the default scheme with the same arguments, for comparison
+	std::vector<unsigned int> passes(mesh.indices.size());
+	passes.resize(meshopt_simplifyWithAttributes(&passes[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 0, 0, 0, 0, target_index_count, target_error, 0));
+
+	double end = timestamp();
+
+	printf("%-9s: %d triangles => %d triangles in %.2f msec (collapse passes: %d triangles in %.2f msec)\n",
+	       "SimplifyQ",
+	       int(mesh.indices.size() / 3), int(lod.size() / 3), (middle - start) * 1000, int(passes.size() / 3), (end - middle) * 1000);
+}
+
+void simplifyParallel(const Mesh& mesh)
+{
+	double start = timestamp();
+
+	size_t target_index_count = size_t(mesh.indices.size() * 0.25f) / 3 * 3;
+	float target_error = 1e-2f;
+
+	// partitions are simplified using parallelForSerial here; a real application would distribute them between worker threads
+	std::vector<unsigned int> lod(mesh.indices.size());
+	lod.resize(meshopt_simplifyParallel(&lod[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, target_error, 0, 8, parallelForSerial, 0));
+
+	double end = timestamp();
+
+	printf("%-9s: %d triangles => %d triangles in %.2f msec\n",
+	       "SimplifyP",
+	       int(mesh.indices.size() / 3), int(lod.size() / 3), (end - start) * 1000);
+}
+
 void optimize(const Mesh& mesh, const char* name, void (*optf)(Mesh& mesh))
 {
 	Mesh copy = mesh;
@@ -479,6 +588,128 @@ void optimize(const Mesh& mesh, const char* name, void (*optf)(Mesh& mesh))
 	printf("%-9s: ACMR %f ATVR %f (NV %f AMD %f Intel %f) Overfetch %f Overdraw %f in %.2f msec\n", name, vcs.acmr, vcs.atvr, vcs_nv.atvr, vcs_amd.atvr, vcs_intel.atvr, vfs.overfetch, os.overdraw, (end - start) * 1000);
 }
 
+struct PipelineTimings
+{
+	double last;
+	double stages[4];
+	int count;
+};
+
+void pipelineStage(void* context, const char*)
+{
+	PipelineTimings& timings = *static_cast<PipelineTimings*>(context);
+
+	double now = timestamp();
+
+	timings.stages[timings.count++] = now - timings.last;
+	timings.last = now;
+}
+
+void optimizePipeline(const Mesh& mesh)
+{
+	// reference: the same stages with separate calls, deduplicating first
+	std::vector<unsigned int> remap(mesh.vertices.size());
+
+	Mesh copy;
+	copy.indices.resize(mesh.indices.size());
+	copy.vertices.resize(mesh.vertices.size());
+
+	Mesh result = copy;
+
+	const float kThreshold = 1.05f;
+
+	double start = timestamp();
+	size_t unique = meshopt_generateVertexRemap(&remap[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex));
+	meshopt_remapIndexBuffer(&copy.indices[0], &mesh.indices[0], mesh.indices.size(), &remap[0]);
+	meshopt_remapVertexBuffer(&copy.vertices[0], &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex), &remap[0]);
+	copy.vertices.resize(unique);
+	optComplete(copy);
+	double middle = timestamp();
+
+	PipelineTimings timings = {};
+	timings.last = middle;
+
+	size_t vertex_count = meshopt_optimizeMesh(&result.indices[0], &result.vertices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex), &mesh.vertices[0].px, sizeof(Vertex), kThreshold, meshopt_OptimizeMeshDeduplicate, pipelineStage, &timings);
+	double end = timestamp();
+
+	result.vertices.resize(vertex_count);
+
+	assert(timings.count == 4);
+	assert(result.indices == copy.indices);
+
+	printf("Pipeline : dedup %.2f, cache %.2f, overdraw %.2f, fetch %.2f msec; total %.2f msec (separate calls %.2f msec)\n",
+	       timings.stages[0] * 1000, timings.stages[1] * 1000, timings.stages[2] * 1000, timings.stages[3] * 1000, (end - middle) * 1000, (middle - start) * 1000);
+}
+
+void optimizeBatch(const Mesh& mesh)
+{
+	// split the mesh into small unindexed chunks, similar to batches of foliage or debris meshes
+	const size_t kChunkTriangles = 128;
+	const float kThreshold = 1.05f;
+
+	std::vector<Vertex> soup(mesh.indices.size());
+
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+		soup[i] = mesh.vertices[mesh.indices[i]];
+
+	std::vector<unsigned int> soup_indices(soup.size());
+
+	for (size_t i = 0; i < soup.size(); i += kChunkTriangles * 3)
+		for (size_t j = i; j < soup.size() && j < i + kChunkTriangles * 3; ++j)
+			soup_indices[j] = unsigned(j - i);
+
+	std::vector<unsigned int> indices(soup.size());
+	std::vector<Vertex> vertices(soup.size());
+
+	std::vector<meshopt_BatchMesh> meshes;
+
+	for (size_t i = 0; i < soup.size(); i += kChunkTriangles * 3)
+	{
+		size_t count = std::min(soup.size() - i, kChunkTriangles * 3);
+
+		meshopt_BatchMesh bm = {&indices[i], &vertices[i], &soup_indices[i], count, &soup[i], count, &soup[i].px, 0};
+		meshes.push_back(bm);
+	}
+
+	double single = 1e9, batch = 1e9;
+
+	for (int attempt = 0; attempt < 5; ++attempt)
+	{
+		double t0 = timestamp();
+
+		for (size_t i = 0; i < meshes.size(); ++i)
+			meshes[i].result = meshopt_optimizeMesh(meshes[i].destination_indices, meshes[i].destination_vertices, meshes[i].indices, meshes[i].index_count, meshes[i].vertices, meshes[i].vertex_count, sizeof(Vertex), meshes[i].vertex_positions, sizeof(Vertex), kThreshold, meshopt_OptimizeMeshDeduplicate, 0, 0);
+
+		double t1 = timestamp();
+
+		// groups are processed using parallelForSerial here; a real application would distribute them between worker threads
+		meshopt_optimizeMeshBatch(&meshes[0], meshes.size(), sizeof(Vertex), sizeof(Vertex), kThreshold, meshopt_OptimizeMeshDeduplicate, 8, parallelForSerial, 0);
+
+		double t2 = timestamp();
+
+		single = std::min(single, t1 - t0);
+		batch = std::min(batch, t2 - t1);
+	}
+
+	std::vector<unsigned char> encoded(meshes.size() * meshopt_encodeIndexBufferBound(kChunkTriangles * 3, kChunkTriangles * 3));
+	std::vector<meshopt_BatchBuffer> buffers(meshes.size());
+
+	for (size_t i = 0; i < meshes.size(); ++i)
+	{
+		size_t bound = encoded.size() / meshes.size();
+
+		meshopt_BatchBuffer bb = {&encoded[i * bound], bound, meshes[i].destination_indices, meshes[i].index_count, 0};
+		buffers[i] = bb;
+	}
+
+	double t3 = timestamp();
+	size_t encoded_size = meshopt_encodeIndexBufferBatch(&buffers[0], buffers.size(), 8, parallelForSerial, 0);
+	double t4 = timestamp();
+
+	printf("Batch    : %d meshes, single calls %.2f msec, batch %.2f msec; encoded indices %.1f bits/triangle in %.2f msec\n",
+	       int(meshes.size()), single * 1000, batch * 1000, double(encoded_size * 8) / double(mesh.indices.size() / 3), (t4 - t3) * 1000);
+}
+
 template <typename T>
 size_t compress(const std::vector<T>& data)
 {
@@ -487,6 +718,178 @@ size_t compress(const std::vector<T>& data)
 	return tdefl_compress_mem_to_mem(&cbuf[0], cbuf.size(), &data[0], data.size() * sizeof(T), flags);
 }
 
+void optimizeCacheThroughput(const Mesh& mesh)
+{
+	std::vector<unsigned int> result(mesh.indices.size());
+	double cache = 1e9, fifo = 1e9;
+
+	// best of several runs to reduce timer noise on small meshes
+	for (int i = 0; i < 10; ++i)
+	{
+		double start = timestamp();
+		meshopt_optimizeVertexCache(&result[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+		double middle = timestamp();
+		meshopt_optimizeVertexCacheFifo(&result[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), kCacheSize);
+		double end = timestamp();
+
+		cache = std::min(cache, middle - start);
+		fifo = std::min(fifo, end - middle);
+	}
+
+	double triangles = double(mesh.indices.size() / 3);
+
+	printf("CacheSpd : Cache %.1f Mtri/s, CacheFifo %.1f Mtri/s\n", triangles / cache * 1e-6, triangles / fifo * 1e-6);
+}
+
+void optimizeCacheProfile(const Mesh& mesh)
+{
+	struct
+	{
+		const char* name;
+		unsigned int cache_size, warp_size, primgroup_size;
+	} profiles[] = {
+	    {"NV", 32, 32, 32},
+	    {"AMD", 14, 64, 128},
+	    {"Intel", 128, 0, 0},
+	};
+
+	const size_t profile_count = sizeof(profiles) / sizeof(profiles[0]);
+
+	std::vector<unsigned int> result(mesh.indices.size());
+	float atvr[profile_count];
+
+	double start = timestamp();
+
+	// each profile gets its own index buffer; the statistics are comparable to the NV/AMD/Intel numbers printed by optimize()
+	for (size_t i = 0; i < profile_count; ++i)
+	{
+		meshopt_optimizeVertexCacheProfile(&result[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), profiles[i].cache_size, profiles[i].warp_size, profiles[i].primgroup_size);
+
+		atvr[i] = meshopt_analyzeVertexCache(&result[0], result.size(), mesh.vertices.size(), profiles[i].cache_size, profiles[i].warp_size, profiles[i].primgroup_size).atvr;
+	}
+
+	double end = timestamp();
+
+	printf("CacheProf: ATVR NV %f AMD %f Intel %f in %.2f msec\n", atvr[0], atvr[1], atvr[2], (end - start) * 1000);
+}
+
+void optimizeOverdrawOctants(const Mesh& mesh)
+{
+	Mesh copy = mesh;
+	meshopt_optimizeVertexCache(&copy.indices[0], &copy.indices[0], copy.indices.size(), copy.vertices.size());
+
+	const float kThreshold = 1.05f;
+
+	std::vector<unsigned int> octants(copy.indices.size() * 8);
+
+	double start = timestamp();
+	meshopt_optimizeOverdrawOctants(&octants[0], &copy.indices[0], copy.indices.size(), &copy.vertices[0].px, copy.vertices.size(), sizeof(Vertex), kThreshold);
+	double end = timestamp();
+
+	// the renderer would pick the index buffer using meshopt_getOverdrawOctant for the current view direction every frame
+	float acmr_min = 3, acmr_max = 0;
+
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		float acmr = meshopt_analyzeVertexCache(&octants[i * copy.indices.size()], copy.indices.size(), copy.vertices.size(), kCacheSize, 0, 0).acmr;
+
+		acmr_min = std::min(acmr_min, acmr);
+		acmr_max = std::max(acmr_max, acmr);
+	}
+
+	printf("OverdrawO: 8 octant orders, ACMR %f..%f in %.2f msec\n", acmr_min, acmr_max, (end - start) * 1000);
+}
+
+void optimizeFetchPasses(const Mesh& mesh)
+{
+	Mesh copy = mesh;
+	meshopt_optimizeVertexCache(&copy.indices[0], &copy.indices[0], copy.indices.size(), copy.vertices.size());
+
+	// depth prepass draws in overdraw-sorted order and only fetches positions; the main pass draws in cache order and fetches all attributes
+	std::vector<unsigned int> prepass(copy.indices.size());
+	meshopt_optimizeOverdraw(&prepass[0], &copy.indices[0], copy.indices.size(), &copy.vertices[0].px, copy.vertices.size(), sizeof(Vertex), 1.05f);
+
+	const size_t strides[] = {sizeof(float) * 3, sizeof(Vertex) - sizeof(float) * 3};
+	const size_t kCacheLine = 64;
+
+	meshopt_VertexFetchPass passes[] = {
+	    {&prepass[0], prepass.size(), 1},
+	    {&copy.indices[0], copy.indices.size(), 3},
+	};
+
+	std::vector<unsigned int> remap(copy.vertices.size());
+	std::vector<unsigned int> remapped(prepass.size() + copy.indices.size());
+
+	meshopt_VertexFetchPass remapped_passes[] = {
+	    {&remapped[0], prepass.size(), 1},
+	    {&remapped[prepass.size()], copy.indices.size(), 3},
+	};
+
+	// baseline: first-use order of the main pass, which is what meshopt_optimizeVertexFetch would produce
+	meshopt_optimizeVertexFetchRemap(&remap[0], &copy.indices[0], copy.indices.size(), copy.vertices.size());
+	meshopt_remapIndexBuffer(&remapped[0], &prepass[0], prepass.size(), &remap[0]);
+	meshopt_remapIndexBuffer(&remapped[prepass.size()], &copy.indices[0], copy.indices.size(), &remap[0]);
+
+	meshopt_VertexFetchStatistics base = meshopt_analyzeVertexFetchPasses(remapped_passes, 2, copy.vertices.size(), strides, 2, kCacheLine);
+
+	double start = timestamp();
+	meshopt_optimizeVertexFetchPassesRemap(&remap[0], passes, 2, copy.vertices.size(), strides, 2, kCacheLine);
+	double end = timestamp();
+
+	meshopt_remapIndexBuffer(&remapped[0], &prepass[0], prepass.size(), &remap[0]);
+	meshopt_remapIndexBuffer(&remapped[prepass.size()], &copy.indices[0], copy.indices.size(), &remap[0]);
+
+	meshopt_VertexFetchStatistics opt = meshopt_analyzeVertexFetchPasses(remapped_passes, 2, copy.vertices.size(), strides, 2, kCacheLine);
+
+	printf("FetchPass: prepass+main %.1f KB (overfetch %f) => %.1f KB (overfetch %f) in %.2f msec\n",
+	       double(base.bytes_fetched) / 1024, base.overfetch, double(opt.bytes_fetched) / 1024, opt.overfetch, (end - start) * 1000);
+}
+
+void shadowIndex(const Mesh& mesh)
+{
+	Mesh copy = mesh;
+	meshopt_optimizeVertexCache(&copy.indices[0], &copy.indices[0], copy.indices.size(), copy.vertices.size());
+
+	std::vector<unsigned int> shadow(copy.indices.size());
+	std::vector<float> positions(copy.vertices.size() * 3);
+
+	double start = timestamp();
+	size_t unique = meshopt_generateShadowIndexBuffer(&shadow[0], &positions[0], &copy.indices[0], copy.indices.size(), &copy.vertices[0].px, copy.vertices.size(), sizeof(Vertex));
+	double end = timestamp();
+
+	// the number of vertex shader invocations is what shadow passes pay for
+	meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), kCacheSize, 0, 0);
+	meshopt_VertexCacheStatistics vcss = meshopt_analyzeVertexCache(&shadow[0], shadow.size(), unique, kCacheSize, 0, 0);
+
+	printf("Shadow   : %d vertices => %d positions, %d => %d invocations in %.2f msec\n",
+	       int(copy.vertices.size()), int(unique), vcs.vertices_transformed, vcss.vertices_transformed, (end - start) * 1000);
+}
+
+void analyzeOverdraw(const Mesh& mesh)
+{
+	meshopt_OverdrawStatistics os = {}, osp = {}, osh = {};
+	double reference = 1e9, blocked = 1e9, high = 1e9;
+
+	// best of several runs to reduce timer noise on small meshes
+	for (int i = 0; i < 3; ++i)
+	{
+		double start = timestamp();
+		os = meshopt_analyzeOverdraw(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+		double middle = timestamp();
+		// views are analyzed using parallelForSerial here; a real application would distribute them between worker threads
+		osp = meshopt_analyzeOverdrawParallel(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 256, parallelForSerial, 0);
+		double end = timestamp();
+		osh = meshopt_analyzeOverdrawParallel(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 1024, parallelForSerial, 0);
+		double endh = timestamp();
+
+		reference = std::min(reference, middle - start);
+		blocked = std::min(blocked, end - middle);
+		high = std::min(high, endh - end);
+	}
+
+	printf("OverdrawA: %f in %.2f msec; blocked %f in %.2f msec, at 1024px %f in %.2f msec\n", os.overdraw, reference * 1000, osp.overdraw, blocked * 1000, osh.overdraw, high * 1000);
+}
+
 void encodeIndex(const Mesh& mesh)
 {
 	double start = timestamp();
@@ -527,8 +930,49 @@ void encodeIndex(const Mesh& mesh)
 		}
 	}
 
-	printf("IdxCodec : %.1f bits/triangle (post-deflate %.1f bits/triangle); encode %.2f msec, decode %.2f msec (%.2f GB/s)\n",
+	{
+		// decode in chunks of 1024 triangles, as if the index data was streamed into a ring buffer
+		meshopt_Buffer<unsigned int> result2(mesh.indices.size());
+
+		meshopt_IndexDecoderState state;
+		meshopt_decodeIndexStreamBegin(&state, mesh.indices.size());
+
+		for (size_t i = 0; i < mesh.indices.size(); i += 3 * 1024)
+		{
+			size_t count = std::min(mesh.indices.size() - i, size_t(3 * 1024));
+
+			int res2 = meshopt_decodeIndexStream(&state, &result2[i], count, &buffer[0], buffer.size());
+			assert(res2 == 0);
+			(void)res2;
+		}
+
+		assert(memcmp(&result[0], &result2[0], mesh.indices.size() * sizeof(unsigned int)) == 0);
+	}
+
+	std::vector<unsigned char> abuffer(meshopt_encodeIndexBufferBound(mesh.indices.size(), mesh.vertices.size()));
+	abuffer.resize(meshopt_encodeIndexBufferAdaptive(&abuffer[0], abuffer.size(), &mesh.indices[0], mesh.indices.size()));
+	assert(abuffer.size() <= buffer.size());
+
+	{
+		meshopt_Buffer<unsigned int> result2(mesh.indices.size());
+		int res2 = meshopt_decodeIndexBuffer(&result2[0], mesh.indices.size(), &abuffer[0], abuffer.size());
+		assert(res2 == 0);
+		(void)res2;
+
+		assert(memcmp(&result[0], &result2[0], mesh.indices.size() * sizeof(unsigned int)) == 0);
+	}
+
+	// adaptive encoding only needs space for its own output, even if the static table produces more data
+	{
+		std::vector<unsigned char> abuffer2(abuffer.size());
+		size_t aresult = meshopt_encodeIndexBufferAdaptive(&abuffer2[0], abuffer2.size(), &mesh.indices[0], mesh.indices.size());
+		assert(aresult == abuffer.size() && abuffer2 == abuffer);
+		(void)aresult;
+	}
+
+	printf("IdxCodec : %.1f bits/triangle (adaptive %.1f, post-deflate %.1f bits/triangle); encode %.2f msec, decode %.2f msec (%.2f GB/s)\n",
 	       double(buffer.size() * 8) / double(mesh.indices.size() / 3),
+	       double(abuffer.size() * 8) / double(mesh.indices.size() / 3),
 	       double(csize * 8) / double(mesh.indices.size() / 3),
 	       (middle - start) * 1000,
 	       (end - middle) * 1000,
@@ -552,12 +996,14 @@ void encodeIndexCoverage()
 	{
 		std::vector<unsigned char> shortbuffer(i);
 		size_t result = meshopt_encodeIndexBuffer(i == 0 ? 0 : &shortbuffer[0], i, indices, index_count);
+		size_t aresult = meshopt_encodeIndexBufferAdaptive(i == 0 ? 0 : &shortbuffer[0], i, indices, index_count);
 		(void)result;
+		(void)aresult;
 
 		if (i == buffer.size())
-			assert(result == buffer.size());
+			assert(result == buffer.size() && aresult == buffer.size());
 		else
-			assert(result == 0);
+			assert(result == 0 && aresult == 0);
 	}
 
 	// check that decode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
@@ -575,6 +1021,27 @@ void encodeIndexCoverage()
 			assert(result < 0);
 	}
 
+	// check that resumable decoder produces the same data when decoding one triangle at a time
+	{
+		unsigned int chunked[index_count];
+
+		meshopt_IndexDecoderState state;
+		meshopt_decodeIndexStreamBegin(&state, index_count);
+
+		for (size_t i = 0; i < index_count; i += 3)
+		{
+			int result = meshopt_decodeIndexStream(&state, &chunked[i], 3, &buffer[0], buffer.size());
+			(void)result;
+
+			assert(result == 0);
+		}
+
+		int result = meshopt_decodeIndexBuffer(destination, index_count, &buffer[0], buffer.size());
+		(void)result;
+
+		assert(result == 0 && memcmp(chunked, destination, sizeof(destination)) == 0);
+	}
+
 	// check that decoder doesn't accept extra bytes after a valid stream
 	{
 		std::vector<unsigned char> largebuffer(buffer);
@@ -612,43 +1079,248 @@ void packVertex(const Mesh& mesh, const char* pvn)
 }
 
 template <typename PV>
-void encodeVertex(const Mesh& mesh, const char* pvn)
+void encodeVertexStream(const std::vector<PV>& pv)
 {
-	std::vector<PV> pv(mesh.vertices.size());
-	packMesh(pv, mesh.vertices);
+	std::vector<unsigned char> segmented(meshopt_encodeVertexBufferSegmentedBound(pv.size(), sizeof(PV)));
+	segmented.resize(meshopt_encodeVertexBufferSegmented(&segmented[0], segmented.size(), &pv[0], pv.size(), sizeof(PV)));
 
-	double start = timestamp();
+	meshopt_Buffer<PV> result(pv.size());
+	int res = meshopt_decodeVertexBufferParallel(&result[0], pv.size(), sizeof(PV), &segmented[0], segmented.size(), parallelForSerial, 0);
+	assert(res == 0);
+	(void)res;
 
-	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(PV)));
-	vbuf.resize(meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV)));
+	assert(memcmp(&pv[0], &result[0], pv.size() * sizeof(PV)) == 0);
 
-	double middle = timestamp();
+	// encode in chunks of 1000 vertices, which don't match block boundaries
+	std::vector<unsigned char> stream;
 
-	// using meshopt_Buffer instead of std::vector to avoid memset overhead
-	meshopt_Buffer<PV> result(mesh.vertices.size());
-	int res = meshopt_decodeVertexBuffer(&result[0], mesh.vertices.size(), sizeof(PV), &vbuf[0], vbuf.size());
-	assert(res == 0);
-	(void)res;
+	meshopt_VertexEncoderState encoder;
+	meshopt_encodeVertexStreamBegin(&encoder, sizeof(PV));
 
-	double end = timestamp();
+	for (size_t i = 0; i < pv.size(); i += 1000)
+	{
+		size_t count = std::min(pv.size() - i, size_t(1000));
 
-	assert(memcmp(&pv[0], &result[0], pv.size() * sizeof(PV)) == 0);
+		std::vector<unsigned char> chunk(meshopt_encodeVertexStreamBound(count, sizeof(PV)));
+		size_t written = 0;
+		res = meshopt_encodeVertexStream(&encoder, &chunk[0], chunk.size(), &written, &pv[i], count);
+		assert(res == 0);
 
-	size_t csize = compress(vbuf);
+		stream.insert(stream.end(), chunk.begin(), chunk.begin() + written);
+	}
 
-	printf("VtxCodec%1s: %.1f bits/vertex (post-deflate %.1f bits/vertex); encode %.2f msec, decode %.2f msec (%.2f GB/s)\n", pvn,
-	       double(vbuf.size() * 8) / double(mesh.vertices.size()),
-	       double(csize * 8) / double(mesh.vertices.size()),
-	       (middle - start) * 1000,
-	       (end - middle) * 1000,
-	       (double(result.size * sizeof(PV)) / (1 << 30)) / (end - middle));
-}
+	{
+		std::vector<unsigned char> chunk(meshopt_encodeVertexStreamBound(0, sizeof(PV)));
+		size_t written = 0;
+		res = meshopt_encodeVertexStreamEnd(&encoder, &chunk[0], chunk.size(), &written);
+		assert(res == 0);
 
-void encodeVertexCoverage()
-{
-	typedef PackedVertexOct PV;
+		stream.insert(stream.end(), chunk.begin(), chunk.begin() + written);
+	}
 
-	const PV vertices[] =
+	assert(stream == segmented);
+
+	// decode 4 KB network packets into a 1000-vertex ring buffer
+	meshopt_VertexDecoderState decoder;
+	meshopt_decodeVertexStreamBegin(&decoder, pv.size(), sizeof(PV));
+
+	std::vector<unsigned char> pending;
+	std::vector<PV> ring(1000);
+	size_t offset = 0, written = 0;
+
+	for (res = 0; res == 0;)
+	{
+		size_t packet = std::min(stream.size() - offset, size_t(4096));
+		pending.insert(pending.end(), stream.begin() + offset, stream.begin() + offset + packet);
+		offset += packet;
+
+		size_t produced = 0, consumed = 0;
+		res = meshopt_decodeVertexStream(&decoder, &ring[0], ring.size(), &produced, pending.empty() ? 0 : &pending[0], pending.size(), &consumed);
+		assert(res >= 0);
+
+		pending.erase(pending.begin(), pending.begin() + consumed);
+
+		// drain the ring buffer before decoding more vertices
+		while (produced > 0)
+		{
+			assert(memcmp(&ring[0], &pv[written], produced * sizeof(PV)) == 0);
+			written += produced;
+
+			res = meshopt_decodeVertexStream(&decoder, &ring[0], ring.size(), &produced, pending.empty() ? 0 : &pending[0], pending.size(), &consumed);
+			assert(res >= 0);
+
+			pending.erase(pending.begin(), pending.begin() + consumed);
+		}
+	}
+
+	assert(res == 1 && written == pv.size() && pending.empty() && offset == stream.size());
+}
+
+template <typename PV>
+void encodeVertex(const Mesh& mesh, const char* pvn)
+{
+	std::vector<PV> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	double start = timestamp();
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(PV)));
+	vbuf.resize(meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &pv[0], mesh.vertices.size(), sizeof(PV)));
+
+	double middle = timestamp();
+
+	// using meshopt_Buffer instead of std::vector to avoid memset overhead
+	meshopt_Buffer<PV> result(mesh.vertices.size());
+	int res = meshopt_decodeVertexBuffer(&result[0], mesh.vertices.size(), sizeof(PV), &vbuf[0], vbuf.size());
+	assert(res == 0);
+	(void)res;
+
+	double end = timestamp();
+
+	assert(memcmp(&pv[0], &result[0], pv.size() * sizeof(PV)) == 0);
+
+	encodeVertexStream(pv);
+
+	size_t csize = compress(vbuf);
+
+	printf("VtxCodec%1s: %.1f bits/vertex (post-deflate %.1f bits/vertex); encode %.2f msec, decode %.2f msec (%.2f GB/s, %s)\n", pvn,
+	       double(vbuf.size() * 8) / double(mesh.vertices.size()),
+	       double(csize * 8) / double(mesh.vertices.size()),
+	       (middle - start) * 1000,
+	       (end - middle) * 1000,
+	       (double(result.size * sizeof(PV)) / (1 << 30)) / (end - middle),
+	       meshopt_getVertexDecoderKernel());
+}
+
+template <typename PV>
+void encodeVertexLevel(const std::vector<PV>& pv, const char* pvn)
+{
+	size_t bits[3], cbits[3];
+	double encode[3], decode[3];
+
+	for (int level = 0; level <= 2; ++level)
+	{
+		double start = timestamp();
+
+		std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(pv.size(), sizeof(PV)));
+		vbuf.resize(meshopt_encodeVertexBufferLevel(&vbuf[0], vbuf.size(), &pv[0], pv.size(), sizeof(PV), level));
+
+		encode[level] = timestamp() - start;
+
+		meshopt_Buffer<PV> result(pv.size());
+
+		// decoding is short and timings are noisy, so we report the best of a few runs
+		decode[level] = 1e9;
+
+		for (int run = 0; run < 10; ++run)
+		{
+			double middle = timestamp();
+			int res = meshopt_decodeVertexBuffer(&result[0], pv.size(), sizeof(PV), &vbuf[0], vbuf.size());
+			assert(res == 0);
+			(void)res;
+			double end = timestamp();
+
+			decode[level] = std::min(decode[level], end - middle);
+		}
+
+		assert(memcmp(&pv[0], &result[0], pv.size() * sizeof(PV)) == 0);
+
+		bits[level] = vbuf.size() * 8;
+		cbits[level] = compress(vbuf) * 8;
+	}
+
+	printf("VtxLevel%1s: %.1f/%.1f/%.1f bits/vertex (post-deflate %.1f/%.1f/%.1f); encode %.2f/%.2f/%.2f msec, decode %.2f/%.2f/%.2f msec\n", pvn,
+	       double(bits[0]) / double(pv.size()), double(bits[1]) / double(pv.size()), double(bits[2]) / double(pv.size()),
+	       double(cbits[0]) / double(pv.size()), double(cbits[1]) / double(pv.size()), double(cbits[2]) / double(pv.size()),
+	       encode[0] * 1000, encode[1] * 1000, encode[2] * 1000,
+	       decode[0] * 1000, decode[1] * 1000, decode[2] * 1000);
+}
+
+void encodeVertexLevels(const Mesh& mesh)
+{
+	std::vector<PackedVertex> pv(mesh.vertices.size());
+	packMesh(pv, mesh.vertices);
+
+	encodeVertexLevel(pv, "");
+	encodeVertexLevel(mesh.vertices, "F");
+}
+
+void encodeFilters(const Mesh& mesh)
+{
+	size_t vertex_count = mesh.vertices.size();
+
+	std::vector<float> normals(vertex_count * 4);
+	std::vector<float> positions(vertex_count * 3);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const Vertex& v = mesh.vertices[i];
+
+		normals[i * 4 + 0] = v.nx;
+		normals[i * 4 + 1] = v.ny;
+		normals[i * 4 + 2] = v.nz;
+		normals[i * 4 + 3] = 0;
+
+		positions[i * 3 + 0] = v.px;
+		positions[i * 3 + 1] = v.py;
+		positions[i * 3 + 2] = v.pz;
+	}
+
+	// raw normals are 3 floats; the 4th component is only used by the filter
+	std::vector<float> normals3(vertex_count * 3);
+	for (size_t i = 0; i < vertex_count; ++i)
+		memcpy(&normals3[i * 3], &normals[i * 4], 12);
+
+	std::vector<unsigned char> nraw(meshopt_encodeVertexBufferBound(vertex_count, 12));
+	nraw.resize(meshopt_encodeVertexBuffer(&nraw[0], nraw.size(), &normals3[0], vertex_count, 12));
+
+	std::vector<signed char> oct(vertex_count * 4);
+	meshopt_encodeFilterOct(&oct[0], vertex_count, 4, 8, &normals[0]);
+
+	std::vector<unsigned char> noct(meshopt_encodeVertexBufferBound(vertex_count, 4));
+	noct.resize(meshopt_encodeVertexBuffer(&noct[0], noct.size(), &oct[0], vertex_count, 4));
+
+	std::vector<unsigned char> praw(meshopt_encodeVertexBufferBound(vertex_count, 12));
+	praw.resize(meshopt_encodeVertexBuffer(&praw[0], praw.size(), &positions[0], vertex_count, 12));
+
+	std::vector<unsigned int> exp(vertex_count * 3);
+	meshopt_encodeFilterExp(&exp[0], vertex_count, 12, 15, &positions[0]);
+
+	std::vector<unsigned char> pexp(meshopt_encodeVertexBufferBound(vertex_count, 12));
+	pexp.resize(meshopt_encodeVertexBuffer(&pexp[0], pexp.size(), &exp[0], vertex_count, 12));
+
+	meshopt_Buffer<unsigned int> result(vertex_count * 3);
+
+	double fused = 1e9, separate = 1e9;
+
+	for (int attempt = 0; attempt < 10; ++attempt)
+	{
+		double t0 = timestamp();
+		int rf = meshopt_decodeVertexBufferFiltered(&result[0], vertex_count, 12, &pexp[0], pexp.size(), meshopt_FilterExp, 0, 0);
+		double t1 = timestamp();
+		int rs = meshopt_decodeVertexBuffer(&result[0], vertex_count, 12, &pexp[0], pexp.size());
+		meshopt_decodeFilterExp(&result[0], vertex_count, 12);
+		double t2 = timestamp();
+
+		assert(rf == 0 && rs == 0);
+		(void)rf;
+		(void)rs;
+
+		fused = std::min(fused, t1 - t0);
+		separate = std::min(separate, t2 - t1);
+	}
+
+	printf("Filters  : normals %.1f => %.1f bits/vertex (oct8), positions %.1f => %.1f bits/vertex (exp15); exp decode %.3f msec fused, %.3f msec separate\n",
+	       double(nraw.size() * 8) / double(vertex_count), double(noct.size() * 8) / double(vertex_count),
+	       double(praw.size() * 8) / double(vertex_count), double(pexp.size() * 8) / double(vertex_count),
+	       fused * 1000, separate * 1000);
+}
+
+void encodeVertexCoverage()
+{
+	typedef PackedVertexOct PV;
+
+	const PV vertices[] =
 	    {
 	        {0, 0, 0, 0, 0, 0, 0},
 	        {300, 0, 0, 0, 0, 500, 0},
@@ -710,6 +1382,259 @@ void encodeVertexCoverage()
 
 		assert(result < 0);
 	}
+
+	// check that strided decoding writes vertices to the right locations and doesn't touch the bytes in between
+	{
+		const size_t stride = sizeof(PV) + 4;
+
+		unsigned char interleaved[vertex_count * stride];
+		memset(interleaved, 0xcd, sizeof(interleaved));
+
+		int result = meshopt_decodeVertexBufferStrided(interleaved, vertex_count, sizeof(PV), stride, &buffer[0], buffer.size());
+		(void)result;
+
+		assert(result == 0);
+
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			assert(memcmp(&interleaved[i * stride], &vertices[i], sizeof(PV)) == 0);
+			assert(interleaved[i * stride + sizeof(PV)] == 0xcd && interleaved[i * stride + stride - 1] == 0xcd);
+		}
+	}
+
+	// check that segmented streams can be decoded by both decoders and that parallel decoder is memory-safe
+	std::vector<unsigned char> segmented(meshopt_encodeVertexBufferSegmentedBound(vertex_count, sizeof(PV)));
+	segmented.resize(meshopt_encodeVertexBufferSegmented(&segmented[0], segmented.size(), vertices, vertex_count, sizeof(PV)));
+
+	for (size_t i = 0; i <= segmented.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(segmented.begin(), segmented.begin() + i);
+		int result = meshopt_decodeVertexBufferParallel(destination, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i, parallelForSerial, 0);
+		(void)result;
+
+		if (i == segmented.size())
+			assert(result == 0 && memcmp(destination, vertices, sizeof(vertices)) == 0);
+		else
+			assert(result < 0);
+	}
+
+	{
+		int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), &segmented[0], segmented.size());
+		(void)result;
+
+		assert(result == 0 && memcmp(destination, vertices, sizeof(vertices)) == 0);
+	}
+
+	// check that streaming encoder produces the same data as segmented encoder when fed one vertex at a time
+	{
+		meshopt_VertexEncoderState state;
+		meshopt_encodeVertexStreamBegin(&state, sizeof(PV));
+
+		std::vector<unsigned char> stream(meshopt_encodeVertexStreamBound(0, sizeof(PV)) * (vertex_count + 1));
+		size_t stream_size = 0;
+
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			size_t written = 0;
+			int result = meshopt_encodeVertexStream(&state, &stream[stream_size], stream.size() - stream_size, &written, &vertices[i], 1);
+			(void)result;
+
+			assert(result == 0);
+			stream_size += written;
+		}
+
+		size_t written = 0;
+		int result = meshopt_encodeVertexStreamEnd(&state, &stream[stream_size], stream.size() - stream_size, &written);
+		(void)result;
+
+		assert(result == 0);
+		stream_size += written;
+
+		assert(stream_size == segmented.size() && memcmp(&stream[0], &segmented[0], stream_size) == 0);
+	}
+
+	// check that streaming decoder can consume data one byte at a time and produce data one vertex at a time
+	{
+		meshopt_VertexDecoderState state;
+		meshopt_decodeVertexStreamBegin(&state, vertex_count, sizeof(PV));
+
+		size_t offset = 0, pending = 0, written = 0;
+		int result = 0;
+
+		while (result == 0 && offset + pending <= segmented.size())
+		{
+			// reallocate the buffer to make sure ASAN can verify that decoder doesn't read past the available data
+			std::vector<unsigned char> chunk(segmented.begin() + offset, segmented.begin() + offset + pending);
+
+			size_t produced = 0, consumed = 0;
+			result = meshopt_decodeVertexStream(&state, &destination[written], written < vertex_count ? 1 : 0, &produced, pending == 0 ? 0 : &chunk[0], pending, &consumed);
+
+			written += produced;
+			offset += consumed;
+			pending = pending - consumed + (produced == 0 && consumed == 0);
+		}
+
+		assert(result == 1 && offset == segmented.size() && written == vertex_count);
+		assert(memcmp(destination, vertices, sizeof(vertices)) == 0);
+	}
+}
+
+void encodeVertexLevelCoverage()
+{
+	typedef PackedVertex PV;
+
+	// 16-bit positions that cross byte boundaries and float-like texture coordinates give every predictor a chance to win
+	PV vertices[64];
+
+	for (size_t i = 0; i < 64; ++i)
+	{
+		PV v = {(unsigned short)(i * 300), (unsigned short)(65000 - i * 250), (unsigned short)(i * i), 0, (unsigned char)i, (unsigned char)(255 - i), 0, 0, (unsigned short)(i * 1000), (unsigned short)(31 - i)};
+		vertices[i] = v;
+	}
+
+	const size_t vertex_count = sizeof(vertices) / sizeof(vertices[0]);
+
+	std::vector<unsigned char> plain(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	plain.resize(meshopt_encodeVertexBuffer(&plain[0], plain.size(), vertices, vertex_count, sizeof(PV)));
+
+	for (int level = 0; level <= 2; ++level)
+	{
+		std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+		buffer.resize(meshopt_encodeVertexBufferLevel(&buffer[0], buffer.size(), vertices, vertex_count, sizeof(PV), level));
+
+		// level 0 must match the regular encoder, and other predictors are chosen for this data since they make it meaningfully smaller
+		if (level == 0)
+			assert(buffer == plain);
+		else
+			assert(buffer.size() < plain.size() && buffer[1] != 0);
+
+		// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+		for (size_t i = 0; i <= buffer.size(); ++i)
+		{
+			std::vector<unsigned char> shortbuffer(i);
+			size_t result = meshopt_encodeVertexBufferLevel(i == 0 ? 0 : &shortbuffer[0], i, vertices, vertex_count, sizeof(PV), level);
+			(void)result;
+
+			if (i == buffer.size())
+				assert(result == buffer.size() && shortbuffer == buffer);
+			else
+				assert(result == 0);
+		}
+
+		// check that decode is memory-safe and that all decoders accept the data
+		PV destination[vertex_count];
+
+		for (size_t i = 0; i <= buffer.size(); ++i)
+		{
+			std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+			int result = meshopt_decodeVertexBuffer(destination, vertex_count, sizeof(PV), i == 0 ? 0 : &shortbuffer[0], i);
+			(void)result;
+
+			if (i == buffer.size())
+				assert(result == 0 && memcmp(destination, vertices, sizeof(vertices)) == 0);
+			else
+				assert(result < 0);
+		}
+
+		int result = meshopt_decodeVertexBufferParallel(destination, vertex_count, sizeof(PV), &buffer[0], buffer.size(), parallelForSerial, 0);
+		assert(result == 0 && memcmp(destination, vertices, sizeof(vertices)) == 0);
+
+		result = meshopt_decodeVertexBufferFiltered(destination, vertex_count, sizeof(PV), &buffer[0], buffer.size(), meshopt_FilterNone, 0, 0);
+		assert(result == 0 && memcmp(destination, vertices, sizeof(vertices)) == 0);
+		(void)result;
+	}
+
+	// blocks that other predictors don't make meaningfully smaller fall back to byte deltas; here 16-bit deltas help pz/pw, which is a small part of the otherwise random block
+	unsigned char noise[64 * sizeof(PV)];
+	unsigned int seed = 42;
+
+	for (size_t i = 0; i < sizeof(noise); ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		noise[i] = (unsigned char)(seed >> 24);
+	}
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		memcpy(&noise[i * sizeof(PV) + 4], &vertices[i].pz, 4);
+
+	std::vector<unsigned char> noiseplain(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	noiseplain.resize(meshopt_encodeVertexBuffer(&noiseplain[0], noiseplain.size(), noise, vertex_count, sizeof(PV)));
+
+	std::vector<unsigned char> noiselevel(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	noiselevel.resize(meshopt_encodeVertexBufferLevel(&noiselevel[0], noiselevel.size(), noise, vertex_count, sizeof(PV), 2));
+
+	assert(noiselevel.size() == noiseplain.size() + 1 && noiselevel[1] == 0);
+
+	unsigned char noisedecoded[sizeof(noise)];
+	int noiseres = meshopt_decodeVertexBuffer(noisedecoded, vertex_count, sizeof(PV), &noiselevel[0], noiselevel.size());
+	assert(noiseres == 0 && memcmp(noisedecoded, noise, sizeof(noise)) == 0);
+	(void)noiseres;
+}
+
+void vertexKernelCoverage()
+{
+	const size_t strides[] = {4, 8, 12, 16, 32, 64, 256};
+	const size_t counts[] = {1, 15, 16, 17, 100, 255, 1000, 5000};
+
+	std::vector<unsigned char> data(5000 * 256);
+
+	// mix smooth and noisy bytes so that every byte group encoding gets used
+	unsigned int seed = 42;
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		data[i] = (unsigned char)((i % 7 < 3) ? (i / 256) + (seed >> 30) : (i % 7 < 5) ? (seed >> 28) : (seed >> 24));
+	}
+
+	const char* kernels[4];
+	size_t kernel_count = meshopt_getVertexEncoderKernels(kernels, 4);
+	assert(kernel_count >= 1 && kernel_count <= 4);
+	assert(strcmp(kernels[0], meshopt_getVertexEncoderKernel()) == 0);
+	assert(strcmp(kernels[kernel_count - 1], "scalar") == 0);
+
+	const char* decoders[4];
+	size_t decoder_count = meshopt_getVertexDecoderKernels(decoders, 4);
+	assert(decoder_count >= 1 && decoder_count <= 4);
+	assert(strcmp(decoders[0], meshopt_getVertexDecoderKernel()) == 0);
+
+	for (size_t si = 0; si < sizeof(strides) / sizeof(strides[0]); ++si)
+		for (size_t ci = 0; ci < sizeof(counts) / sizeof(counts[0]); ++ci)
+			for (int level = 0; level <= 2; level += 2)
+			{
+				size_t stride = strides[si], count = counts[ci];
+
+				std::vector<unsigned char> expected(meshopt_encodeVertexBufferBound(count, stride));
+				expected.resize(meshopt_encodeVertexBufferLevel(&expected[0], expected.size(), &data[0], count, stride, level));
+				assert(!expected.empty());
+
+				for (size_t ki = 0; ki < kernel_count; ++ki)
+				{
+					std::vector<unsigned char> result(meshopt_encodeVertexBufferBound(count, stride));
+					result.resize(meshopt_encodeVertexBufferKernel(kernels[ki], &result[0], result.size(), &data[0], count, stride, level));
+
+					assert(result == expected);
+				}
+
+				for (size_t ki = 0; ki < decoder_count; ++ki)
+				{
+					std::vector<unsigned char> decoded(count * stride);
+					int res = meshopt_decodeVertexBufferKernel(decoders[ki], &decoded[0], count, stride, &expected[0], expected.size());
+					assert(res == 0 && memcmp(&decoded[0], &data[0], count * stride) == 0);
+					(void)res;
+				}
+			}
+
+	unsigned char buffer[64];
+	size_t size = meshopt_encodeVertexBufferKernel("unknown", buffer, sizeof(buffer), &data[0], 1, 4, 0);
+	assert(size == 0);
+	(void)size;
+	(void)kernel_count;
+
+	int res = meshopt_decodeVertexBufferKernel("unknown", &data[0], 1, 4, buffer, sizeof(buffer));
+	assert(res == -4);
+	(void)res;
+	(void)decoder_count;
 }
 
 void stripify(const Mesh& mesh)
@@ -736,6 +1661,1442 @@ void stripify(const Mesh& mesh)
 	       (end - start) * 1000);
 }
 
+void meshlets(const Mesh& mesh)
+{
+	const size_t max_vertices = 64;
+	const size_t max_triangles = 124;
+
+	double start = timestamp();
+
+	// index buffer is expected to be optimized for vertex cache, which keeps the meshlets compact
+	std::vector<meshopt_Meshlet> meshlets(meshopt_buildMeshletsBound(mesh.indices.size(), max_vertices, max_triangles));
+	std::vector<unsigned int> meshlet_vertices(meshlets.size() * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(meshlets.size() * max_triangles * 3);
+
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), max_vertices, max_triangles));
+
+	double middle = timestamp();
+
+	std::vector<meshopt_Bounds> bounds(meshlets.size());
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+
+		bounds[i] = meshopt_computeMeshletBounds(&meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset], m.triangle_count, &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	}
+
+	double end = timestamp();
+
+	size_t vertices = 0, triangles = 0, not_full = 0;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		vertices += meshlets[i].vertex_count;
+		triangles += meshlets[i].triangle_count;
+		not_full += meshlets[i].vertex_count < max_vertices && meshlets[i].triangle_count < max_triangles;
+	}
+
+	printf("Meshlets : %d meshlets (avg vertices %.1f, avg triangles %.1f, not full %d) in %.2f msec, bounds in %.2f msec\n",
+	       int(meshlets.size()), double(vertices) / double(meshlets.size()), double(triangles) / double(meshlets.size()), int(not_full),
+	       (middle - start) * 1000, (end - middle) * 1000);
+
+	// estimate backface culling efficiency by looking at the mesh from 6 directions around its bounding box
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+	{
+		const float* v = &mesh.vertices[i].px;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			minv[k] = std::min(minv[k], v[k]);
+			maxv[k] = std::max(maxv[k], v[k]);
+		}
+	}
+
+	float extent = std::max(maxv[0] - minv[0], std::max(maxv[1] - minv[1], maxv[2] - minv[2]));
+
+	size_t rejected = 0;
+
+	for (int view = 0; view < 6; ++view)
+	{
+		float camera[3] = {(minv[0] + maxv[0]) / 2, (minv[1] + maxv[1]) / 2, (minv[2] + maxv[2]) / 2};
+		camera[view / 2] += (view % 2 ? -2 : 2) * extent;
+
+		for (size_t i = 0; i < meshlets.size(); ++i)
+		{
+			const meshopt_Bounds& b = bounds[i];
+
+			float d[3] = {b.cone_apex[0] - camera[0], b.cone_apex[1] - camera[1], b.cone_apex[2] - camera[2]};
+			float dl = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+			rejected += d[0] * b.cone_axis[0] + d[1] * b.cone_axis[1] + d[2] * b.cone_axis[2] >= b.cone_cutoff * dl;
+		}
+	}
+
+	printf("ConeCull : rejected %.1f%% of meshlets on average from 6 views\n", double(rejected) / double(meshlets.size() * 6) * 100);
+}
+
+static char gArena[4 << 20];
+static size_t gArenaOffset = 0;
+static size_t gArenaPeak = 0;
+static int gArenaLive = 0;
+
+void* arenaAllocate(size_t size)
+{
+	assert(gArenaOffset + size <= sizeof(gArena));
+
+	void* result = gArena + gArenaOffset;
+	gArenaOffset += (size + 15) & ~size_t(15);
+	gArenaPeak = std::max(gArenaPeak, gArenaOffset);
+	gArenaLive++;
+
+	return result;
+}
+
+void arenaDeallocate(void* ptr)
+{
+	assert(ptr >= gArena && ptr < gArena + sizeof(gArena));
+	(void)ptr;
+
+	assert(gArenaLive > 0);
+	gArenaLive--;
+}
+
+void allocatorCoverage()
+{
+	Mesh mesh = generatePlane(20);
+
+	std::vector<unsigned short> indices(mesh.indices.begin(), mesh.indices.end());
+	std::vector<unsigned int> lod(mesh.indices.size());
+
+	meshopt_setAllocator(arenaAllocate, arenaDeallocate);
+
+	// every call must release all of its temporary memory before returning, so the arena can be reset in between
+	meshopt_optimizeVertexCache(&indices[0], &indices[0], indices.size(), mesh.vertices.size());
+	assert(gArenaLive == 0 && gArenaPeak > 0);
+	gArenaOffset = 0;
+
+	meshopt_analyzeOverdraw(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	assert(gArenaLive == 0);
+	gArenaOffset = 0;
+
+	lod.resize(meshopt_simplify(&lod[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), mesh.indices.size() / 4, 1e-2f));
+	assert(gArenaLive == 0 && lod.size() < mesh.indices.size());
+	gArenaOffset = 0;
+
+	meshopt_setAllocator(operator new, operator delete);
+}
+
+struct InstrumentationStats
+{
+	size_t events;
+	size_t starts;
+	size_t lods;
+	size_t collapses;
+	size_t dead_ends;
+	size_t clusters;
+	size_t bytes_read;
+	size_t bytes_written;
+};
+
+void instrumentationCallback(void* context, const meshopt_InstrumentationEvent* event)
+{
+	InstrumentationStats& stats = *static_cast<InstrumentationStats*>(context);
+
+	stats.events++;
+	stats.starts += strcmp(event->stage, "start") == 0;
+	stats.bytes_read += event->bytes_read;
+	stats.bytes_written += event->bytes_written;
+
+	if (strcmp(event->function, "simplify") == 0 && strcmp(event->stage, "collapse") == 0)
+	{
+		stats.lods++;
+		stats.collapses += event->collapses;
+	}
+
+	if (strcmp(event->function, "optimizeVertexCache") == 0 && strcmp(event->stage, "optimize") == 0)
+		stats.dead_ends += event->iterations;
+
+	if (strcmp(event->function, "optimizeOverdraw") == 0 && strcmp(event->stage, "sort") == 0)
+		stats.clusters += event->iterations;
+}
+
+void instrumentationCoverage()
+{
+	Mesh mesh = generatePlane(20);
+
+	std::vector<unsigned int> indices(mesh.indices.size());
+	std::vector<unsigned int> lod(mesh.indices.size());
+
+	InstrumentationStats stats = {};
+	meshopt_setInstrumentation(instrumentationCallback, &stats);
+
+	lod.resize(meshopt_simplify(&lod[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), mesh.indices.size() / 4, 1e-2f));
+	assert(stats.starts == 1 && stats.events == 5);
+	assert(stats.lods == 1 && stats.collapses > 0);
+
+	meshopt_optimizeVertexCache(&indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+	assert(stats.starts == 2 && stats.events == 8 && stats.dead_ends > 0);
+
+	meshopt_optimizeOverdraw(&indices[0], &indices[0], indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 1.05f);
+	assert(stats.starts == 3 && stats.events == 12 && stats.clusters > 0);
+
+	// codecs report sizes of the data they consume and produce
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(indices.size(), mesh.vertices.size()));
+	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &indices[0], indices.size()));
+	assert(stats.starts == 4 && stats.events == 14);
+	assert(stats.bytes_read == indices.size() * 4 && stats.bytes_written == buffer.size());
+
+	int rc = meshopt_decodeIndexBuffer(&indices[0], indices.size(), 4, &buffer[0], buffer.size());
+	assert(rc == 0 && stats.events == 16);
+	assert(stats.bytes_read == indices.size() * 4 + buffer.size() && stats.bytes_written == buffer.size() + indices.size() * 4);
+
+	// failed decoding only reports the start event
+	rc = meshopt_decodeIndexBuffer(&indices[0], indices.size(), 4, &buffer[0], buffer.size() - 1);
+	assert(rc < 0 && stats.starts == 6 && stats.events == 17);
+	(void)rc;
+
+	// disabling instrumentation stops reporting
+	meshopt_setInstrumentation(0, 0);
+
+	meshopt_optimizeVertexCache(&indices[0], &indices[0], indices.size(), mesh.vertices.size());
+	assert(stats.events == 17);
+}
+
+void remapCoverage()
+{
+	Mesh mesh = generatePlane(200);
+
+	std::vector<Vertex> soup(mesh.indices.size());
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+		soup[i] = mesh.vertices[mesh.indices[i]];
+
+	std::vector<unsigned int> expected(soup.size() * 4);
+	std::vector<unsigned int> remap(soup.size() * 4);
+
+	// unindexed input, specialized vertex size
+	size_t unique = meshopt_generateVertexRemap(&expected[0], (unsigned int*)0, soup.size(), &soup[0], soup.size(), sizeof(Vertex));
+	assert(unique == mesh.vertices.size());
+
+	size_t result = meshopt_generateVertexRemapParallel(&remap[0], (unsigned int*)0, soup.size(), &soup[0], soup.size(), sizeof(Vertex), 8, parallelForSerial, 0);
+	assert(result == unique);
+	assert(memcmp(&remap[0], &expected[0], soup.size() * sizeof(unsigned int)) == 0);
+
+	result = meshopt_generateVertexRemapParallel(&remap[0], (unsigned int*)0, soup.size(), &soup[0], soup.size(), sizeof(Vertex), 8, 0, 0);
+	assert(result == unique);
+	assert(memcmp(&remap[0], &expected[0], soup.size() * sizeof(unsigned int)) == 0);
+
+	// indexed input with duplicate and unreferenced vertices, generic vertex size (each 8-byte vertex is a quarter of Vertex)
+	std::vector<unsigned int> indices(mesh.indices.size());
+	for (size_t i = 0; i < indices.size(); ++i)
+		indices[i] = unsigned(i * 4 + i % 3);
+
+	size_t vertex_count = soup.size() * 4;
+
+	unique = meshopt_generateVertexRemap(&expected[0], &indices[0], indices.size(), &soup[0], vertex_count, 8);
+	result = meshopt_generateVertexRemapParallel(&remap[0], &indices[0], indices.size(), &soup[0], vertex_count, 8, 8, parallelForSerial, 0);
+	assert(result == unique);
+	assert(memcmp(&remap[0], &expected[0], vertex_count * sizeof(unsigned int)) == 0);
+	(void)result;
+
+	// split streams: positions are tightly packed, normals and texture coordinates are read from the interleaved buffer
+	std::vector<float> positions(soup.size() * 3);
+	for (size_t i = 0; i < soup.size(); ++i)
+		memcpy(&positions[i * 3], &soup[i].px, 3 * sizeof(float));
+
+	meshopt_Stream streams[] = {
+	    {&positions[0], 3 * sizeof(float), 3 * sizeof(float)},
+	    {&soup[0].nx, 3 * sizeof(float), sizeof(Vertex)},
+	    {&soup[0].tx, 2 * sizeof(float), sizeof(Vertex)},
+	};
+
+	unique = meshopt_generateVertexRemap(&expected[0], (unsigned int*)0, soup.size(), &soup[0], soup.size(), sizeof(Vertex));
+	size_t unique_multi = meshopt_generateVertexRemapMulti(&remap[0], (unsigned int*)0, soup.size(), soup.size(), streams, sizeof(streams) / sizeof(streams[0]));
+	assert(unique_multi == unique);
+	(void)unique_multi;
+	assert(memcmp(&remap[0], &expected[0], soup.size() * sizeof(unsigned int)) == 0);
+
+	std::vector<Vertex> vertices(unique);
+	meshopt_remapVertexBuffer(&vertices[0], &soup[0], soup.size(), sizeof(Vertex), &remap[0]);
+
+	std::vector<float> normals(unique * 3);
+	meshopt_remapVertexBufferStrided(&normals[0], &soup[0].nx, soup.size(), 3 * sizeof(float), sizeof(Vertex), &remap[0]);
+
+	meshopt_remapVertexBuffer(&positions[0], &positions[0], soup.size(), 3 * sizeof(float), &remap[0]);
+
+	for (size_t i = 0; i < unique; ++i)
+	{
+		assert(memcmp(&positions[i * 3], &vertices[i].px, 3 * sizeof(float)) == 0);
+		assert(memcmp(&normals[i * 3], &vertices[i].nx, 3 * sizeof(float)) == 0);
+	}
+}
+
+void shadowIndexCoverage()
+{
+	Mesh mesh = generatePlane(50);
+
+	// split the plane along a texture seam: the second half of the triangles references copies of the vertices with different texture coordinates
+	size_t vertex_count = mesh.vertices.size();
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		Vertex v = mesh.vertices[i];
+		v.tx += 1;
+		mesh.vertices.push_back(v);
+	}
+
+	for (size_t i = mesh.indices.size() / 2; i < mesh.indices.size(); ++i)
+		mesh.indices[i] += unsigned(vertex_count);
+
+	optRandomShuffle(mesh);
+
+	std::vector<unsigned int> shadow(mesh.indices.size());
+	std::vector<float> positions(mesh.vertices.size() * 3);
+
+	size_t unique = meshopt_generateShadowIndexBuffer(&shadow[0], &positions[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	assert(unique == vertex_count);
+
+	// shadow mesh has the same triangles once the other attributes are stripped
+	Mesh expected = mesh;
+
+	for (size_t i = 0; i < expected.vertices.size(); ++i)
+	{
+		Vertex v = {expected.vertices[i].px, expected.vertices[i].py, expected.vertices[i].pz, 0, 0, 0, 0, 0};
+		expected.vertices[i] = v;
+	}
+
+	Mesh result;
+	result.indices = shadow;
+
+	for (size_t i = 0; i < unique; ++i)
+	{
+		Vertex v = {positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2], 0, 0, 0, 0, 0};
+		result.vertices.push_back(v);
+	}
+
+	assert(isMeshValid(result));
+	assert(areMeshesEqual(expected, result));
+
+	// compacted positions are in first-use order and the index buffer is optimized for vertex cache
+	unsigned int next_vertex = 0;
+
+	for (size_t i = 0; i < shadow.size(); ++i)
+	{
+		assert(shadow[i] <= next_vertex);
+		next_vertex += shadow[i] == next_vertex;
+	}
+
+	meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), kCacheSize, 0, 0);
+	meshopt_VertexCacheStatistics vcss = meshopt_analyzeVertexCache(&shadow[0], shadow.size(), unique, kCacheSize, 0, 0);
+
+	assert(vcss.vertices_transformed < vcs.vertices_transformed / 2);
+	(void)vcs;
+	(void)vcss;
+
+	// without a compacted stream the index buffer references one vertex per position; in-place, 16-bit
+	std::vector<unsigned short> indices16(mesh.indices.begin(), mesh.indices.end());
+	size_t result_unique = meshopt_generateShadowIndexBuffer(&indices16[0], (float*)0, &indices16[0], indices16.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	assert(result_unique == unique);
+
+	Mesh original = expected;
+	original.indices.assign(indices16.begin(), indices16.end());
+
+	std::vector<unsigned char> referenced(mesh.vertices.size());
+	size_t referenced_count = 0;
+
+	for (size_t i = 0; i < original.indices.size(); ++i)
+	{
+		referenced_count += referenced[original.indices[i]] == 0;
+		referenced[original.indices[i]] = 1;
+	}
+
+	assert(referenced_count == unique);
+
+	assert(areMeshesEqual(expected, original));
+
+	// unindexed input
+	std::vector<Vertex> soup(mesh.indices.size());
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+		soup[i] = mesh.vertices[mesh.indices[i]];
+
+	std::vector<float> soup_positions(soup.size() * 3);
+	result_unique = meshopt_generateShadowIndexBuffer(&shadow[0], &soup_positions[0], (unsigned int*)0, soup.size(), &soup[0].px, soup.size(), sizeof(Vertex));
+	assert(result_unique == unique);
+	assert(memcmp(&soup_positions[0], &positions[0], unique * 3 * sizeof(float)) == 0);
+	(void)result_unique;
+}
+
+void optimizeCacheCoverage()
+{
+	Mesh mesh = generatePlane(200);
+
+	std::vector<unsigned int> expected(mesh.indices.size());
+	meshopt_optimizeVertexCache(&expected[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	Mesh copy = mesh;
+	meshopt_optimizeVertexCacheParallel(&copy.indices[0], &copy.indices[0], copy.indices.size(), copy.vertices.size(), 8, parallelForSerial, 0);
+
+	assert(isMeshValid(copy));
+	assert(areMeshesEqual(mesh, copy));
+
+	// partitions don't share the cache so the result is slightly worse than that of the serial optimizer
+	meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), kCacheSize, 0, 0);
+	meshopt_VertexCacheStatistics vcs_serial = meshopt_analyzeVertexCache(&expected[0], expected.size(), mesh.vertices.size(), kCacheSize, 0, 0);
+
+	assert(vcs.acmr < vcs_serial.acmr * 1.02f);
+	(void)vcs_serial;
+
+	// parallel_for is optional and doesn't affect the result
+	std::vector<unsigned int> result(mesh.indices.size());
+	meshopt_optimizeVertexCacheParallel(&result[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 8, 0, 0);
+
+	assert(result == copy.indices);
+
+	// shuffled input doesn't have enough locality for contiguous partitions, so they are rebuilt from mesh connectivity
+	Mesh shuffled = mesh;
+	optRandomShuffle(shuffled);
+
+	meshopt_optimizeVertexCacheParallel(&result[0], &shuffled.indices[0], shuffled.indices.size(), shuffled.vertices.size(), 8, parallelForSerial, 0);
+	shuffled.indices.swap(result);
+
+	assert(isMeshValid(shuffled));
+	assert(areMeshesEqual(mesh, shuffled));
+
+	vcs = meshopt_analyzeVertexCache(&shuffled.indices[0], shuffled.indices.size(), shuffled.vertices.size(), kCacheSize, 0, 0);
+	assert(vcs.acmr < vcs_serial.acmr * 1.1f);
+
+	// small meshes are optimized serially
+	std::vector<unsigned short> small(mesh.indices.begin(), mesh.indices.begin() + 3000);
+	std::vector<unsigned short> small_expected(small.size());
+	meshopt_optimizeVertexCache(&small_expected[0], &small[0], small.size(), mesh.vertices.size());
+	meshopt_optimizeVertexCacheParallel(&small[0], &small[0], small.size(), mesh.vertices.size(), 8, parallelForSerial, 0);
+
+	assert(small == small_expected);
+}
+
+void optimizeCacheProfileCoverage()
+{
+	Mesh mesh = generatePlane(50);
+
+	std::vector<unsigned int> expected(mesh.indices.size());
+	meshopt_optimizeVertexCache(&expected[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	unsigned int profiles[][3] = {{32, 32, 32}, {14, 64, 128}, {128, 0, 0}, {16, 0, 0}};
+
+	for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); ++i)
+	{
+		unsigned int cache_size = profiles[i][0], warp_size = profiles[i][1], primgroup_size = profiles[i][2];
+
+		Mesh copy = mesh;
+		meshopt_optimizeVertexCacheProfile(&copy.indices[0], &copy.indices[0], copy.indices.size(), copy.vertices.size(), cache_size, warp_size, primgroup_size);
+
+		assert(isMeshValid(copy));
+		assert(areMeshesEqual(mesh, copy));
+
+		// the result is never worse than that of meshopt_optimizeVertexCache according to the same model
+		meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), cache_size, warp_size, primgroup_size);
+		meshopt_VertexCacheStatistics vcs_expected = meshopt_analyzeVertexCache(&expected[0], expected.size(), mesh.vertices.size(), cache_size, warp_size, primgroup_size);
+
+		assert(vcs.vertices_transformed <= vcs_expected.vertices_transformed);
+		(void)vcs;
+		(void)vcs_expected;
+
+		// 16-bit indices go through the template wrapper
+		std::vector<unsigned short> indices16(mesh.indices.begin(), mesh.indices.end());
+		meshopt_optimizeVertexCacheProfile(&indices16[0], &indices16[0], indices16.size(), mesh.vertices.size(), cache_size, warp_size, primgroup_size);
+
+		assert(std::equal(indices16.begin(), indices16.end(), copy.indices.begin()));
+	}
+}
+
+void analyzeOverdrawCoverage()
+{
+	Mesh mesh = generatePlane(50);
+
+	// fold the plane so that each view sees several layers
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		mesh.vertices[i].pz = sinf(mesh.vertices[i].px * 0.5f) * cosf(mesh.vertices[i].py * 0.3f) * 10;
+
+	meshopt_OverdrawStatistics expected = meshopt_analyzeOverdraw(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	assert(expected.overdraw > 1.1f);
+
+	// coverage uses the same fixed point setup; depth is interpolated differently, so depth test results can differ slightly
+	meshopt_OverdrawStatistics os = meshopt_analyzeOverdrawParallel(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 256, parallelForSerial, 0);
+	assert(os.pixels_covered * 1000 >= expected.pixels_covered * 999 && os.pixels_covered * 999 <= expected.pixels_covered * 1000);
+	assert(fabsf(os.overdraw - expected.overdraw) < expected.overdraw * 0.01f);
+
+	// serial fallback and the 16-bit variant produce the same results
+	meshopt_OverdrawStatistics oss = meshopt_analyzeOverdrawParallel(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 256, 0, 0);
+	assert(oss.pixels_covered == os.pixels_covered && oss.pixels_shaded == os.pixels_shaded);
+
+	std::vector<unsigned short> indices(mesh.indices.begin(), mesh.indices.end());
+	meshopt_OverdrawStatistics os16 = meshopt_analyzeOverdrawParallel(&indices[0], indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 256, parallelForSerial, 0);
+	assert(os16.pixels_covered == os.pixels_covered && os16.pixels_shaded == os.pixels_shaded);
+
+	// higher resolution covers proportionally more pixels with similar overdraw
+	meshopt_OverdrawStatistics osh = meshopt_analyzeOverdrawParallel(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 1024, parallelForSerial, 0);
+	assert(osh.pixels_covered > os.pixels_covered * 15 && osh.pixels_covered < os.pixels_covered * 17);
+	assert(fabsf(osh.overdraw - os.overdraw) < os.overdraw * 0.05f);
+	(void)expected;
+	(void)os;
+	(void)oss;
+	(void)os16;
+	(void)osh;
+
+	// viewport sizes that are not a multiple of the block size are supported
+	for (unsigned int size = 1; size <= 9; ++size)
+	{
+		meshopt_OverdrawStatistics osn = meshopt_analyzeOverdrawParallel(&mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), size, 0, 0);
+		assert(osn.pixels_covered > 0 && osn.pixels_covered <= size * size * 6);
+		(void)osn;
+	}
+}
+
+void optimizeOverdrawOctantsCoverage()
+{
+	Mesh mesh = generatePlane(50);
+
+	// fold the plane so that different views see different layers first
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		mesh.vertices[i].pz = sinf(mesh.vertices[i].px * 0.5f) * cosf(mesh.vertices[i].py * 0.3f) * 10;
+
+	meshopt_optimizeVertexCache(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	size_t index_count = mesh.indices.size();
+
+	std::vector<unsigned int> octants(index_count * 8);
+	meshopt_optimizeOverdrawOctants(&octants[0], &mesh.indices[0], index_count, &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 3.f);
+
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		Mesh copy = mesh;
+		copy.indices.assign(octants.begin() + i * index_count, octants.begin() + (i + 1) * index_count);
+
+		assert(isMeshValid(copy));
+		assert(areMeshesEqual(mesh, copy));
+
+		// octant is selected from the signs of view direction components
+		float view[3] = {(i & 1) ? -1.f : 1.f, (i & 2) ? -0.5f : 0.5f, (i & 4) ? -0.25f : 0.25f};
+		unsigned int octant = meshopt_getOverdrawOctant(view[0], view[1], view[2]);
+		assert(octant == i);
+		(void)octant;
+
+		// triangles are sorted front to back, so the first half of the buffer is closer to the camera on average
+		float depth[2] = {};
+
+		for (size_t j = 0; j < index_count; ++j)
+		{
+			const Vertex& v = copy.vertices[copy.indices[j]];
+
+			depth[j * 2 >= index_count] += v.px * view[0] + v.py * view[1] + v.pz * view[2];
+		}
+
+		assert(depth[0] < depth[1]);
+	}
+
+	// 16-bit variant produces the same orders, and in-place optimization writes all 8 buffers
+	std::vector<unsigned short> indices16(index_count * 8);
+	std::copy(mesh.indices.begin(), mesh.indices.end(), indices16.begin());
+
+	meshopt_optimizeOverdrawOctants(&indices16[0], &indices16[0], index_count, &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 3.f);
+
+	for (size_t i = 0; i < index_count * 8; ++i)
+		assert(indices16[i] == octants[i]);
+}
+
+void optimizeFetchPassesCoverage()
+{
+	Mesh mesh = generatePlane(100);
+	optRandomShuffle(mesh);
+
+	// a single pass that fetches a single stream with 64-byte lines matches meshopt_analyzeVertexFetch
+	const size_t stride = sizeof(Vertex);
+	meshopt_VertexFetchPass pass = {&mesh.indices[0], mesh.indices.size(), 1};
+
+	meshopt_VertexFetchStatistics vfs = meshopt_analyzeVertexFetch(&mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), sizeof(Vertex));
+	meshopt_VertexFetchStatistics vfsp = meshopt_analyzeVertexFetchPasses(&pass, 1, mesh.vertices.size(), &stride, 1, 64);
+
+	assert(vfs.bytes_fetched == vfsp.bytes_fetched);
+	assert(vfs.overfetch == vfsp.overfetch);
+	(void)vfs;
+	(void)vfsp;
+
+	std::vector<unsigned int> expected(mesh.vertices.size());
+	std::vector<unsigned int> remap(mesh.vertices.size());
+
+	// on a single pass the result is never worse than meshopt_optimizeVertexFetchRemap
+	size_t unique = meshopt_optimizeVertexFetchRemap(&expected[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+	size_t result = meshopt_optimizeVertexFetchPassesRemap(&remap[0], &pass, 1, mesh.vertices.size(), &stride, 1, 64);
+	assert(result == unique);
+
+	std::vector<unsigned int> expected_indices(mesh.indices.size());
+	meshopt_remapIndexBuffer(&expected_indices[0], &mesh.indices[0], mesh.indices.size(), &expected[0]);
+
+	std::vector<unsigned int> result_indices(mesh.indices.size());
+	meshopt_remapIndexBuffer(&result_indices[0], &mesh.indices[0], mesh.indices.size(), &remap[0]);
+
+	meshopt_VertexFetchStatistics vfs_expected = meshopt_analyzeVertexFetch(&expected_indices[0], expected_indices.size(), unique, sizeof(Vertex));
+	meshopt_VertexFetchStatistics vfs_result = meshopt_analyzeVertexFetch(&result_indices[0], result_indices.size(), unique, sizeof(Vertex));
+
+	assert(vfs_result.bytes_fetched <= vfs_expected.bytes_fetched);
+	(void)vfs_expected;
+	(void)vfs_result;
+
+	// prepass fetches positions in reverse order, main pass fetches positions and attributes
+	meshopt_optimizeVertexCache(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	std::vector<unsigned int> prepass(mesh.indices.rbegin(), mesh.indices.rend());
+
+	const size_t strides[] = {12, 20};
+	meshopt_VertexFetchPass passes[] = {
+	    {&prepass[0], prepass.size(), 1},
+	    {&mesh.indices[0], mesh.indices.size(), 3},
+	};
+
+	unique = meshopt_optimizeVertexFetchPassesRemap(&remap[0], passes, 2, mesh.vertices.size(), strides, 2, 32);
+	assert(unique == mesh.vertices.size());
+
+	// remap is a permutation
+	std::vector<unsigned char> seen(unique);
+
+	for (size_t i = 0; i < remap.size(); ++i)
+	{
+		assert(remap[i] < unique && !seen[remap[i]]);
+		seen[remap[i]] = 1;
+	}
+
+	std::vector<unsigned int> remapped(prepass.size() + mesh.indices.size());
+	meshopt_VertexFetchPass remapped_passes[] = {
+	    {&remapped[0], prepass.size(), 1},
+	    {&remapped[prepass.size()], mesh.indices.size(), 3},
+	};
+
+	meshopt_remapIndexBuffer(&remapped[0], &prepass[0], prepass.size(), &remap[0]);
+	meshopt_remapIndexBuffer(&remapped[prepass.size()], &mesh.indices[0], mesh.indices.size(), &remap[0]);
+
+	size_t bytes = meshopt_analyzeVertexFetchPasses(remapped_passes, 2, unique, strides, 2, 32).bytes_fetched;
+
+	// the result is never worse than the first-use order of either pass
+	for (int k = 0; k < 2; ++k)
+	{
+		std::vector<unsigned int> combined(passes[k].indices, passes[k].indices + passes[k].index_count);
+		combined.insert(combined.end(), passes[1 - k].indices, passes[1 - k].indices + passes[1 - k].index_count);
+
+		meshopt_optimizeVertexFetchRemap(&expected[0], &combined[0], combined.size(), mesh.vertices.size());
+
+		meshopt_remapIndexBuffer(&remapped[0], &prepass[0], prepass.size(), &expected[0]);
+		meshopt_remapIndexBuffer(&remapped[prepass.size()], &mesh.indices[0], mesh.indices.size(), &expected[0]);
+
+		meshopt_VertexFetchStatistics vfs_first = meshopt_analyzeVertexFetchPasses(remapped_passes, 2, unique, strides, 2, 32);
+		assert(bytes <= vfs_first.bytes_fetched);
+		(void)vfs_first;
+	}
+
+	(void)bytes;
+
+	// vertices that aren't referenced by any pass are not remapped
+	meshopt_VertexFetchPass partial = {&prepass[0], 3, 1};
+	result = meshopt_optimizeVertexFetchPassesRemap(&remap[0], &partial, 1, mesh.vertices.size(), strides, 2, 64);
+	assert(result == 3);
+
+	size_t remapped_count = 0;
+
+	for (size_t i = 0; i < remap.size(); ++i)
+	{
+		assert(remap[i] == ~0u || remap[i] < 3);
+		remapped_count += remap[i] != ~0u;
+	}
+
+	assert(remapped_count == 3);
+
+	// no passes
+	result = meshopt_optimizeVertexFetchPassesRemap(&remap[0], passes, 0, mesh.vertices.size(), strides, 2, 64);
+	assert(result == 0);
+	(void)result;
+
+	meshopt_VertexFetchStatistics vfs_empty = meshopt_analyzeVertexFetchPasses(passes, 0, mesh.vertices.size(), strides, 2, 64);
+	assert(vfs_empty.bytes_fetched == 0);
+	(void)vfs_empty;
+}
+
+void optimizeMeshCoverage()
+{
+	Mesh mesh = generatePlane(50);
+
+	// fold the plane so that overdraw optimization has something to do
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		mesh.vertices[i].pz = sinf(mesh.vertices[i].px * 0.5f) * cosf(mesh.vertices[i].py * 0.3f) * 10;
+
+	const float kThreshold = 1.05f;
+
+	// unindexed triangle soup exercises deduplication
+	std::vector<Vertex> soup(mesh.indices.size());
+	std::vector<unsigned int> soup_indices(mesh.indices.size());
+
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+	{
+		soup[i] = mesh.vertices[mesh.indices[i]];
+		soup_indices[i] = unsigned(i);
+	}
+
+	// reference: deduplicate and optimize using separate calls
+	std::vector<unsigned int> remap(soup.size());
+	size_t unique = meshopt_generateVertexRemap(&remap[0], &soup_indices[0], soup_indices.size(), &soup[0], soup.size(), sizeof(Vertex));
+	assert(unique == mesh.vertices.size());
+
+	Mesh expected;
+	expected.indices.resize(soup_indices.size());
+	expected.vertices.resize(unique);
+	meshopt_remapIndexBuffer(&expected.indices[0], &soup_indices[0], soup_indices.size(), &remap[0]);
+	meshopt_remapVertexBuffer(&expected.vertices[0], &soup[0], soup.size(), sizeof(Vertex), &remap[0]);
+	optComplete(expected);
+
+	Mesh result;
+	result.indices.resize(soup_indices.size());
+	result.vertices.resize(soup.size());
+
+	size_t vertex_count = meshopt_optimizeMesh(&result.indices[0], &result.vertices[0], &soup_indices[0], soup_indices.size(), &soup[0], soup.size(), sizeof(Vertex), &soup[0].px, sizeof(Vertex), kThreshold, meshopt_OptimizeMeshDeduplicate, 0, 0);
+	result.vertices.resize(vertex_count);
+
+	assert(vertex_count == unique);
+	assert(result.indices == expected.indices);
+	assert(memcmp(&result.vertices[0], &expected.vertices[0], unique * sizeof(Vertex)) == 0);
+
+	// positions can also be stored outside of the vertex data, and deduplication supports in-place optimization
+	std::vector<float> soup_positions(soup.size() * 4);
+
+	for (size_t i = 0; i < soup.size(); ++i)
+		memcpy(&soup_positions[i * 4], &soup[i].px, sizeof(float) * 3);
+
+	std::vector<unsigned int> inplace_indices = soup_indices;
+	std::vector<Vertex> inplace_vertices = soup;
+
+	vertex_count = meshopt_optimizeMesh(&inplace_indices[0], &inplace_vertices[0], &inplace_indices[0], inplace_indices.size(), &inplace_vertices[0], inplace_vertices.size(), sizeof(Vertex), &soup_positions[0], sizeof(float) * 4, kThreshold, meshopt_OptimizeMeshDeduplicate, 0, 0);
+
+	assert(vertex_count == unique);
+	assert(inplace_indices == expected.indices);
+	assert(memcmp(&inplace_vertices[0], &expected.vertices[0], unique * sizeof(Vertex)) == 0);
+
+	inplace_indices = soup_indices;
+	inplace_vertices = soup;
+
+	vertex_count = meshopt_optimizeMesh(&inplace_indices[0], &inplace_vertices[0], &inplace_indices[0], inplace_indices.size(), &inplace_vertices[0], inplace_vertices.size(), sizeof(Vertex), &inplace_vertices[0].px, sizeof(Vertex), kThreshold, meshopt_OptimizeMeshDeduplicate, 0, 0);
+
+	assert(vertex_count == unique);
+	assert(inplace_indices == expected.indices);
+	assert(memcmp(&inplace_vertices[0], &expected.vertices[0], unique * sizeof(Vertex)) == 0);
+
+	// without deduplication the pipeline matches optComplete, including in-place optimization
+	Mesh reference = mesh;
+	optComplete(reference);
+
+	Mesh copy = mesh;
+	vertex_count = meshopt_optimizeMesh(&copy.indices[0], &copy.vertices[0], &copy.indices[0], copy.indices.size(), &copy.vertices[0], copy.vertices.size(), sizeof(Vertex), &copy.vertices[0].px, sizeof(Vertex), kThreshold, 0, 0, 0);
+
+	assert(vertex_count == reference.vertices.size());
+	assert(copy.indices == reference.indices);
+	assert(memcmp(&copy.vertices[0], &reference.vertices[0], vertex_count * sizeof(Vertex)) == 0);
+
+	// 16-bit variant
+	std::vector<unsigned short> indices16(mesh.indices.begin(), mesh.indices.end());
+	std::vector<Vertex> vertices16(mesh.vertices.size());
+
+	vertex_count = meshopt_optimizeMesh(&indices16[0], &vertices16[0], &indices16[0], indices16.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex), &mesh.vertices[0].px, sizeof(Vertex), kThreshold, 0, 0, 0);
+
+	assert(vertex_count == reference.vertices.size());
+	assert(std::equal(indices16.begin(), indices16.end(), reference.indices.begin()));
+}
+
+void containerCoverage()
+{
+	Mesh mesh = generatePlane(10);
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(Vertex)));
+	vbuf.resize(meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+
+	std::vector<unsigned char> ibuf(meshopt_encodeIndexBufferBound(mesh.indices.size(), mesh.vertices.size()));
+	ibuf.resize(meshopt_encodeIndexBuffer(&ibuf[0], ibuf.size(), &mesh.indices[0], mesh.indices.size()));
+
+	std::vector<unsigned char> sbuf(meshopt_encodeVertexBufferSegmentedBound(mesh.vertices.size(), sizeof(Vertex)));
+	sbuf.resize(meshopt_encodeVertexBufferSegmented(&sbuf[0], sbuf.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+
+	meshopt_ContainerChunk chunks[3] = {
+	    {meshopt_ChunkVertexBuffer, 0, unsigned(mesh.vertices.size()), sizeof(Vertex), 0, unsigned(vbuf.size()), {0, 0, 0}, {10, 10, 0}},
+	    {meshopt_ChunkIndexBuffer, 0, unsigned(mesh.indices.size()), 0, 0, unsigned(ibuf.size()), {0, 0, 0}, {10, 10, 0}},
+	    {meshopt_ChunkVertexBuffer, 0, unsigned(mesh.vertices.size()), sizeof(Vertex), 0, unsigned(sbuf.size()), {-1, -2, -3}, {1, 2, 3}},
+	};
+
+	const unsigned char* data[3] = {&vbuf[0], &ibuf[0], &sbuf[0]};
+
+	size_t bound = meshopt_encodeContainerBound(chunks, 3);
+	assert(bound == 16 + 3 * 48 + vbuf.size() + ibuf.size() + sbuf.size());
+
+	std::vector<unsigned char> container(bound);
+
+	size_t size = meshopt_encodeContainer(&container[0], bound - 1, chunks, data, 3);
+	assert(size == 0);
+
+	// containers that don't fit in 32 bits are rejected before any data is written, even if the buffer is large enough
+	if (sizeof(size_t) > 4)
+	{
+		meshopt_ContainerChunk huge[3] = {chunks[0], chunks[1], chunks[2]};
+		huge[2].length = ~0u;
+
+		size = meshopt_encodeContainer(&container[0], ~size_t(0), huge, data, 3);
+		assert(size == 0);
+	}
+
+	size = meshopt_encodeContainer(&container[0], bound, chunks, data, 3);
+	assert(size == bound);
+
+	assert(chunks[0].version == 0 && chunks[2].version == 1);
+	assert(chunks[0].offset == 16 + 3 * 48 && chunks[1].offset == chunks[0].offset + vbuf.size());
+
+	size_t chunk_count = meshopt_getContainerChunkCount(&container[0], container.size());
+	assert(chunk_count == 3);
+
+	// chunks can be decoded in any order; each decode only touches the header, the table entry and the chunk data
+	for (int i = 2; i >= 0; --i)
+	{
+		meshopt_ContainerChunk chunk;
+		int res = meshopt_getContainerChunk(&chunk, &container[0], container.size(), i);
+		assert(res == 0);
+		assert(memcmp(&chunk, &chunks[i], sizeof(chunk)) == 0);
+		assert(memcmp(&container[chunk.offset], data[i], chunk.length) == 0);
+
+		if (chunk.type == meshopt_ChunkVertexBuffer)
+		{
+			std::vector<Vertex> vertices(chunk.count);
+			res = meshopt_decodeContainerChunk(&vertices[0], 0, &container[0], container.size(), i);
+			assert(res == 0);
+			assert(memcmp(&vertices[0], &mesh.vertices[0], mesh.vertices.size() * sizeof(Vertex)) == 0);
+		}
+		else
+		{
+			// the index codec may rotate triangles, so the reference is the decoded chunk data
+			std::vector<unsigned int> expected(chunk.count);
+			res = meshopt_decodeIndexBuffer(&expected[0], chunk.count, 4, data[i], chunk.length);
+			assert(res == 0);
+
+			std::vector<unsigned int> indices(chunk.count);
+			res = meshopt_decodeContainerChunk(&indices[0], 4, &container[0], container.size(), i);
+			assert(res == 0);
+			assert(indices == expected);
+
+			std::vector<unsigned short> indices16(chunk.count);
+			res = meshopt_decodeContainerChunk(&indices16[0], 2, &container[0], container.size(), i);
+			assert(res == 0);
+			assert(std::equal(indices16.begin(), indices16.end(), expected.begin()));
+		}
+
+		(void)res;
+	}
+
+	meshopt_ContainerChunk chunk;
+	int res = meshopt_getContainerChunk(&chunk, &container[0], container.size(), 3);
+	assert(res == -2);
+
+	// truncated files are rejected before any chunk data is accessed
+	chunk_count = meshopt_getContainerChunkCount(&container[0], container.size() - 1);
+	assert(chunk_count == 0);
+	chunk_count = meshopt_getContainerChunkCount(&container[0], 15);
+	assert(chunk_count == 0);
+	res = meshopt_getContainerChunk(&chunk, &container[0], container.size() - 1, 0);
+	assert(res == -1);
+
+	// corrupted magic and chunk data
+	std::vector<unsigned char> copy = container;
+	copy[0] = 'X';
+	chunk_count = meshopt_getContainerChunkCount(&copy[0], copy.size());
+	assert(chunk_count == 0);
+
+	copy = container;
+	copy[chunks[1].offset] = 0;
+	std::vector<unsigned int> indices(mesh.indices.size());
+	res = meshopt_decodeContainerChunk(&indices[0], 4, &copy[0], copy.size(), 1);
+	assert(res == -6);
+
+	// corrupted table entries: type, length, vertex size and index count
+	copy = container;
+	copy[16 + 1 * 48 + 0] = 7;
+	res = meshopt_getContainerChunk(&chunk, &copy[0], copy.size(), 1);
+	assert(res == -3);
+
+	copy = container;
+	copy[16 + 1 * 48 + 23] = 0xff;
+	res = meshopt_getContainerChunk(&chunk, &copy[0], copy.size(), 1);
+	assert(res == -4);
+
+	copy = container;
+	copy[16 + 0 * 48 + 12] = 3;
+	res = meshopt_decodeContainerChunk(&mesh.vertices[0], 0, &copy[0], copy.size(), 0);
+	assert(res == -5);
+
+	copy = container;
+	copy[16 + 1 * 48 + 8] += 1;
+	res = meshopt_decodeContainerChunk(&indices[0], 4, &copy[0], copy.size(), 1);
+	assert(res == -5);
+
+	// empty containers are valid
+	unsigned char empty[16];
+	size = meshopt_encodeContainer(empty, sizeof(empty), 0, 0, 0);
+	assert(size == 16);
+	chunk_count = meshopt_getContainerChunkCount(empty, sizeof(empty));
+	assert(chunk_count == 0);
+
+	(void)size;
+	(void)chunk_count;
+	(void)res;
+}
+
+void filterCoverage()
+{
+	const size_t kCount = 1000;
+
+	std::vector<float> normals(kCount * 4), quats(kCount * 4), values(kCount * 3);
+
+	unsigned int seed = 42;
+
+	for (size_t i = 0; i < kCount; ++i)
+	{
+		float v[4];
+
+		for (int k = 0; k < 4; ++k)
+		{
+			seed = seed * 1664525 + 1013904223;
+			v[k] = float(seed >> 8) / float(1 << 24) * 2 - 1;
+		}
+
+		float nl = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+		float ql = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]);
+
+		for (int k = 0; k < 3; ++k)
+			normals[i * 4 + k] = v[k] / nl;
+
+		normals[i * 4 + 3] = v[3];
+
+		for (int k = 0; k < 4; ++k)
+			quats[i * 4 + k] = v[k] / ql;
+
+		for (int k = 0; k < 3; ++k)
+			values[i * 3 + k] = v[k] * 1000;
+	}
+
+	// round trip precision
+	std::vector<signed char> oct8(kCount * 4);
+	meshopt_encodeFilterOct(&oct8[0], kCount, 4, 8, &normals[0]);
+	meshopt_decodeFilterOct(&oct8[0], kCount, 4);
+
+	std::vector<short> oct16(kCount * 4);
+	meshopt_encodeFilterOct(&oct16[0], kCount, 8, 16, &normals[0]);
+	meshopt_decodeFilterOct(&oct16[0], kCount, 8);
+
+	std::vector<short> quat(kCount * 4);
+	meshopt_encodeFilterQuat(&quat[0], kCount, 8, 12, &quats[0]);
+	meshopt_decodeFilterQuat(&quat[0], kCount, 8);
+
+	std::vector<float> exp(kCount * 3);
+	meshopt_encodeFilterExp(&exp[0], kCount, 12, 16, &values[0]);
+	meshopt_decodeFilterExp(&exp[0], kCount, 12);
+
+	for (size_t i = 0; i < kCount; ++i)
+	{
+		float dot = 0;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			assert(fabsf(oct8[i * 4 + k] / 127.f - normals[i * 4 + k]) < 0.02f);
+			assert(fabsf(oct16[i * 4 + k] / 32767.f - normals[i * 4 + k]) < 1e-4f);
+		}
+
+		assert(oct8[i * 4 + 3] == meshopt_quantizeSnorm(normals[i * 4 + 3], 8));
+		assert(oct16[i * 4 + 3] == meshopt_quantizeSnorm(normals[i * 4 + 3], 16));
+
+		for (int k = 0; k < 4; ++k)
+			dot += quat[i * 4 + k] / 32767.f * quats[i * 4 + k];
+
+		assert(fabsf(dot) > 0.9999f);
+
+		for (int k = 0; k < 3; ++k)
+			assert(fabsf(exp[i * 3 + k] - values[i * 3 + k]) < 0.05f);
+	}
+
+	// small integers are represented exactly
+	float ints[4] = {0, 1, -7, 1000};
+	meshopt_encodeFilterExp(ints, 1, 16, 12, ints);
+	meshopt_decodeFilterExp(ints, 1, 16);
+	assert(ints[0] == 0 && ints[1] == 1 && ints[2] == -7 && ints[3] == 1000);
+
+	// fused decoding matches separate decode and filter calls, including partial blocks and segmented streams
+	const size_t counts[] = {1, 3, 255, 257, kCount};
+	const unsigned int filters[] = {meshopt_FilterOct, meshopt_FilterOct, meshopt_FilterQuat, meshopt_FilterExp};
+	const size_t strides[] = {4, 8, 8, 12};
+
+	for (size_t f = 0; f < 4; ++f)
+		for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+			for (int segmented = 0; segmented < 2; ++segmented)
+			{
+				size_t count = counts[c];
+				size_t stride = strides[f];
+
+				std::vector<unsigned char> data(count * stride);
+
+				if (f < 2)
+					meshopt_encodeFilterOct(&data[0], count, stride, 8 + int(f) * 4, &normals[0]);
+				else if (f == 2)
+					meshopt_encodeFilterQuat(&data[0], count, stride, 12, &quats[0]);
+				else
+					meshopt_encodeFilterExp(&data[0], count, stride, 15, &values[0]);
+
+				std::vector<unsigned char> buffer(meshopt_encodeVertexBufferSegmentedBound(count, stride));
+				buffer.resize(segmented ? meshopt_encodeVertexBufferSegmented(&buffer[0], buffer.size(), &data[0], count, stride) : meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], count, stride));
+
+				std::vector<unsigned char> expected(count * stride);
+				int res = meshopt_decodeVertexBuffer(&expected[0], count, stride, &buffer[0], buffer.size());
+				assert(res == 0);
+
+				if (filters[f] == meshopt_FilterOct)
+					meshopt_decodeFilterOct(&expected[0], count, stride);
+				else if (filters[f] == meshopt_FilterQuat)
+					meshopt_decodeFilterQuat(&expected[0], count, stride);
+				else
+					meshopt_decodeFilterExp(&expected[0], count, stride);
+
+				std::vector<unsigned char> result(count * stride);
+				res = meshopt_decodeVertexBufferFiltered(&result[0], count, stride, &buffer[0], buffer.size(), filters[f], 0, 0);
+				assert(res == 0);
+				assert(result == expected);
+
+				std::vector<unsigned char> resultp(count * stride);
+				res = meshopt_decodeVertexBufferFiltered(&resultp[0], count, stride, &buffer[0], buffer.size(), filters[f], parallelForSerial, 0);
+				assert(res == 0);
+				assert(resultp == expected);
+
+				// without a filter the result matches meshopt_decodeVertexBuffer
+				res = meshopt_decodeVertexBufferFiltered(&result[0], count, stride, &buffer[0], buffer.size(), meshopt_FilterNone, 0, 0);
+				assert(res == 0);
+				res = meshopt_decodeVertexBuffer(&expected[0], count, stride, &buffer[0], buffer.size());
+				assert(res == 0);
+				assert(result == expected);
+
+				// errors are reported the same way as meshopt_decodeVertexBuffer
+				res = meshopt_decodeVertexBufferFiltered(&result[0], count, stride, &buffer[0], buffer.size() - 1, filters[f], 0, 0);
+				assert(res != 0);
+
+				// unknown filters are rejected
+				res = meshopt_decodeVertexBufferFiltered(&result[0], count, stride, &buffer[0], buffer.size(), ~0u, 0, 0);
+				assert(res != 0);
+				(void)res;
+			}
+}
+
+void batchCoverage()
+{
+	const float kThreshold = 1.05f;
+
+	// meshes of different sizes, including an empty one, so that groups get different amounts of work
+	std::vector<Mesh> sources;
+
+	for (unsigned int i = 0; i < 20; ++i)
+		sources.push_back(generatePlane(1 + (i * 7) % 13));
+
+	// a mesh that doesn't fit in one run of the batch overdraw sort, between meshes that are sorted together
+	sources.insert(sources.begin() + 10, generatePlane(60));
+
+	sources.push_back(Mesh());
+
+	for (int dedup = 0; dedup < 2; ++dedup)
+	{
+		unsigned int options = dedup ? meshopt_OptimizeMeshDeduplicate : 0;
+
+		std::vector<Mesh> expected = sources;
+
+		for (size_t i = 0; i < expected.size(); ++i)
+			if (!expected[i].indices.empty())
+			{
+				size_t vertex_count = meshopt_optimizeMesh(&expected[i].indices[0], &expected[i].vertices[0], &sources[i].indices[0], sources[i].indices.size(), &sources[i].vertices[0], sources[i].vertices.size(), sizeof(Vertex), &sources[i].vertices[0].px, sizeof(Vertex), kThreshold, options, 0, 0);
+				expected[i].vertices.resize(vertex_count);
+			}
+
+		const size_t partitions[] = {1, 3, 100};
+
+		for (size_t p = 0; p < sizeof(partitions) / sizeof(partitions[0]); ++p)
+		{
+			std::vector<Mesh> results = sources;
+			std::vector<meshopt_BatchMesh> meshes(sources.size());
+
+			for (size_t i = 0; i < sources.size(); ++i)
+			{
+				meshopt_BatchMesh bm = {};
+
+				if (!sources[i].indices.empty())
+				{
+					bm.destination_indices = &results[i].indices[0];
+					bm.destination_vertices = &results[i].vertices[0];
+					bm.indices = &sources[i].indices[0];
+					bm.index_count = sources[i].indices.size();
+					bm.vertices = &sources[i].vertices[0];
+					bm.vertex_count = sources[i].vertices.size();
+					bm.vertex_positions = &sources[i].vertices[0].px;
+				}
+
+				bm.result = ~size_t(0);
+				meshes[i] = bm;
+			}
+
+			meshopt_optimizeMeshBatch(&meshes[0], meshes.size(), sizeof(Vertex), sizeof(Vertex), kThreshold, options, partitions[p], parallelForSerial, 0);
+
+			for (size_t i = 0; i < sources.size(); ++i)
+			{
+				assert(meshes[i].result == expected[i].vertices.size());
+				assert(results[i].indices == expected[i].indices);
+				assert(meshes[i].result == 0 || memcmp(&results[i].vertices[0], &expected[i].vertices[0], meshes[i].result * sizeof(Vertex)) == 0);
+			}
+		}
+	}
+
+	// encoded data must match single calls
+	std::vector<std::vector<unsigned char> > ibufs(sources.size() - 1), vbufs(sources.size() - 1);
+	std::vector<meshopt_BatchBuffer> ib(sources.size() - 1), vb(sources.size() - 1);
+
+	for (size_t i = 0; i + 1 < sources.size(); ++i)
+	{
+		const Mesh& m = sources[i];
+
+		ibufs[i].resize(meshopt_encodeIndexBufferBound(m.indices.size(), m.vertices.size()));
+		vbufs[i].resize(meshopt_encodeVertexBufferBound(m.vertices.size(), sizeof(Vertex)));
+
+		meshopt_BatchBuffer ibb = {&ibufs[i][0], ibufs[i].size(), &m.indices[0], m.indices.size(), 0};
+		meshopt_BatchBuffer vbb = {&vbufs[i][0], vbufs[i].size(), &m.vertices[0], m.vertices.size(), 0};
+
+		ib[i] = ibb;
+		vb[i] = vbb;
+	}
+
+	size_t itotal = meshopt_encodeIndexBufferBatch(&ib[0], ib.size(), 4, parallelForSerial, 0);
+	size_t vtotal = meshopt_encodeVertexBufferBatch(&vb[0], vb.size(), sizeof(Vertex), 4, 0, 0);
+
+	size_t isum = 0, vsum = 0;
+
+	for (size_t i = 0; i < ib.size(); ++i)
+	{
+		const Mesh& m = sources[i];
+
+		std::vector<unsigned char> ibuf(ibufs[i].size()), vbuf(vbufs[i].size());
+
+		size_t isize = meshopt_encodeIndexBuffer(&ibuf[0], ibuf.size(), &m.indices[0], m.indices.size());
+		size_t vsize = meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &m.vertices[0], m.vertices.size(), sizeof(Vertex));
+
+		assert(ib[i].result == isize && memcmp(&ibuf[0], &ibufs[i][0], isize) == 0);
+		assert(vb[i].result == vsize && memcmp(&vbuf[0], &vbufs[i][0], vsize) == 0);
+
+		isum += isize;
+		vsum += vsize;
+	}
+
+	assert(itotal == isum);
+	assert(vtotal == vsum);
+
+	// a single buffer without enough space fails the batch but the other buffers are still encoded
+	ib[3].buffer_size = 1;
+
+	itotal = meshopt_encodeIndexBufferBatch(&ib[0], ib.size(), 4, parallelForSerial, 0);
+	assert(itotal == 0);
+	assert(ib[3].result == 0);
+	assert(ib[4].result != 0);
+
+	// empty batches are valid
+	itotal = meshopt_encodeIndexBufferBatch(0, 0, 4, 0, 0);
+	assert(itotal == 0);
+	(void)itotal;
+	(void)vtotal;
+	meshopt_optimizeMeshBatch(0, 0, sizeof(Vertex), sizeof(Vertex), kThreshold, 0, 4, 0, 0);
+}
+
+void stripifyCoverage()
+{
+	Mesh mesh = generatePlane(200);
+	meshopt_optimizeVertexCache(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	std::vector<unsigned int> expected(mesh.indices.size() / 3 * 4);
+	expected.resize(meshopt_stripify(&expected[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size()));
+
+	meshopt_VertexCacheStatistics vcs_source = meshopt_analyzeVertexCache(&mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), kCacheSize, 0, 0);
+
+	// both stitching modes preserve triangles and their winding, and threshold of 1 preserves source cache efficiency
+	for (int restart = 0; restart < 2; ++restart)
+	{
+		std::vector<unsigned int> strip(mesh.indices.size() / 3 * 5);
+		strip.resize(meshopt_stripifyCache(&strip[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), restart ? ~0u : 0, kCacheSize, 1.f));
+
+		assert(restart || std::find(strip.begin(), strip.end(), ~0u) == strip.end());
+
+		Mesh copy = mesh;
+		copy.indices.resize(meshopt_unstripify(&copy.indices[0], &strip[0], strip.size()));
+
+		assert(isMeshValid(copy));
+		assert(areMeshesEqual(mesh, copy));
+
+		meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), kCacheSize, 0, 0);
+		assert(vcs.acmr <= vcs_source.acmr);
+		(void)vcs;
+	}
+
+	(void)vcs_source;
+
+	// looser threshold allows shorter strips than meshopt_stripify
+	std::vector<unsigned int> loose(mesh.indices.size() / 3 * 4);
+	loose.resize(meshopt_stripifyCache(&loose[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), ~0u, kCacheSize, 1.5f));
+
+	assert(loose.size() < expected.size());
+
+	// 16-bit index buffers use the 16-bit restart index
+	std::vector<unsigned short> indices16(mesh.indices.begin(), mesh.indices.end());
+	std::vector<unsigned short> strip16(indices16.size() / 3 * 4);
+	strip16.resize(meshopt_stripifyCache(&strip16[0], &indices16[0], indices16.size(), mesh.vertices.size(), 0xffff, kCacheSize, 1.5f));
+
+	assert(strip16.size() == loose.size());
+
+	for (size_t i = 0; i < loose.size(); ++i)
+		assert(strip16[i] == (loose[i] == ~0u ? 0xffff : loose[i]));
+
+	// parallel stripification only loses strips at partition boundaries
+	std::vector<unsigned int> strip(mesh.indices.size() / 3 * 4);
+	strip.resize(meshopt_stripifyParallel(&strip[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 8, parallelForSerial, 0));
+
+	assert(strip.size() < expected.size() * 101 / 100);
+
+	Mesh copy = mesh;
+	copy.indices.resize(meshopt_unstripify(&copy.indices[0], &strip[0], strip.size()));
+
+	assert(isMeshValid(copy));
+	assert(areMeshesEqual(mesh, copy));
+
+	// parallel_for is optional and doesn't affect the result
+	std::vector<unsigned int> result(mesh.indices.size() / 3 * 4);
+	result.resize(meshopt_stripifyParallel(&result[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 8, 0, 0));
+
+	assert(result == strip);
+
+	// small meshes are stripified serially
+	result.resize(mesh.indices.size() / 3 * 4);
+	result.resize(meshopt_stripifyParallel(&result[0], &mesh.indices[0], 3000, mesh.vertices.size(), 8, parallelForSerial, 0));
+
+	strip.resize(mesh.indices.size() / 3 * 4);
+	strip.resize(meshopt_stripify(&strip[0], &mesh.indices[0], 3000, mesh.vertices.size()));
+
+	assert(result == strip);
+}
+
+void simplifyCoverage()
+{
+	Mesh mesh = generatePlane(100);
+
+	// bend the plane so that simplification has to trade triangles for error
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		mesh.vertices[i].pz = sinf(mesh.vertices[i].px * 0.1f) * cosf(mesh.vertices[i].py * 0.15f) * 4;
+
+	size_t target_index_count = mesh.indices.size() / 4 / 3 * 3;
+	float target_error = 1e-2f;
+
+	// attribute_count of 0 produces the same result as meshopt_simplify
+	std::vector<unsigned int> expected(mesh.indices.size());
+	expected.resize(meshopt_simplify(&expected[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, target_error));
+
+	std::vector<unsigned int> lod(mesh.indices.size());
+	lod.resize(meshopt_simplifyWithAttributes(&lod[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 0, 0, 0, 0, target_index_count, target_error, 0));
+
+	assert(lod.size() < mesh.indices.size());
+	assert(lod == expected);
+
+	// priority queue reaches the target when the error isn't limiting and keeps indices valid
+	Mesh queue = mesh;
+	queue.indices.resize(meshopt_simplifyWithAttributes(&queue.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 0, 0, 0, 0, target_index_count, 1.f, meshopt_SimplifyPriorityQueue));
+
+	assert(isMeshValid(queue));
+	assert(queue.indices.size() > 0 && queue.indices.size() <= target_index_count);
+
+	// LOD chain levels shrink while their error never decreases
+	static const size_t lod_count = 4;
+
+	size_t target_index_counts[lod_count];
+
+	for (size_t i = 0; i < lod_count; ++i)
+		target_index_counts[i] = (mesh.indices.size() >> (i + 1)) / 3 * 3;
+
+	std::vector<unsigned int> lods(mesh.indices.size() * lod_count);
+	size_t lod_index_counts[lod_count];
+	float lod_errors[lod_count];
+
+	size_t lod_total = meshopt_simplifyLodChain(&lods[0], lod_index_counts, lod_errors, &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), 0, 0, 0, 0, target_index_counts, 0, lod_count, 0);
+
+	size_t lod_offset = 0;
+
+	for (size_t i = 0; i < lod_count; ++i)
+	{
+		assert(lod_index_counts[i] > 0 && lod_index_counts[i] <= target_index_counts[i]);
+		assert(i == 0 || (lod_index_counts[i] <= lod_index_counts[i - 1] && lod_errors[i] >= lod_errors[i - 1]));
+
+		Mesh level = mesh;
+		level.indices.assign(lods.begin() + lod_offset, lods.begin() + lod_offset + lod_index_counts[i]);
+		assert(isMeshValid(level));
+
+		lod_offset += lod_index_counts[i];
+	}
+
+	assert(lod_offset == lod_total);
+	(void)lod_total;
+
+	// parallel simplification splits the grid into partitions and reaches close to the target
+	Mesh parallel = mesh;
+	parallel.indices.resize(meshopt_simplifyParallel(&parallel.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, 1.f, 0, 8, parallelForSerial, 0));
+
+	assert(isMeshValid(parallel));
+	assert(parallel.indices.size() <= target_index_count && parallel.indices.size() >= target_index_count * 9 / 10);
+
+	// edges used by a single triangle can only be on the grid border, otherwise there is a crack at a partition seam
+	std::map<std::pair<unsigned int, unsigned int>, int> edges;
+
+	for (size_t i = 0; i < parallel.indices.size(); i += 3)
+		for (int e = 0; e < 3; ++e)
+		{
+			unsigned int a = parallel.indices[i + e], b = parallel.indices[i + (e + 1) % 3];
+			edges[std::make_pair(std::min(a, b), std::max(a, b))]++;
+		}
+
+	for (std::map<std::pair<unsigned int, unsigned int>, int>::iterator it = edges.begin(); it != edges.end(); ++it)
+	{
+		const Vertex& a = mesh.vertices[it->first.first];
+		const Vertex& b = mesh.vertices[it->first.second];
+
+		bool border = (a.px == b.px && (a.px == 0 || a.px == 100)) || (a.py == b.py && (a.py == 0 || a.py == 100));
+
+		assert(it->second == 2 || (it->second == 1 && border));
+		(void)border;
+	}
+}
+
+void meshletsCoverage()
+{
+	Mesh mesh = generatePlane(50);
+
+	// bend the plane so that meshlets get different normal cones
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		mesh.vertices[i].pz = sinf(mesh.vertices[i].px * 0.2f) * cosf(mesh.vertices[i].py * 0.3f) * 4;
+
+	meshopt_optimizeVertexCache(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	const size_t max_vertices = 32;
+	const size_t max_triangles = 32;
+
+	std::vector<meshopt_Meshlet> meshlets(meshopt_buildMeshletsBound(mesh.indices.size(), max_vertices, max_triangles));
+	std::vector<unsigned int> meshlet_vertices(meshlets.size() * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(meshlets.size() * max_triangles * 3, 0xcd);
+
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), max_vertices, max_triangles));
+
+	// meshlets preserve the triangle order and respect the limits
+	std::vector<unsigned int> indices;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+
+		assert(m.vertex_count <= max_vertices && m.triangle_count <= max_triangles && m.triangle_count > 0);
+		assert(m.triangle_offset % 4 == 0);
+
+		for (size_t j = 0; j < m.triangle_count * 3; ++j)
+		{
+			unsigned char local = meshlet_triangles[m.triangle_offset + j];
+			assert(local < m.vertex_count);
+
+			indices.push_back(meshlet_vertices[m.vertex_offset + local]);
+		}
+	}
+
+	assert(indices == mesh.indices);
+
+	// vertex limited meshlets have triangle counts that need padding, which is zeroed
+	std::vector<meshopt_Meshlet> small(meshopt_buildMeshletsBound(mesh.indices.size(), 4, 4));
+	std::vector<unsigned int> small_vertices(small.size() * 4);
+	std::vector<unsigned char> small_triangles(small.size() * 4 * 3, 0xcd);
+
+	small.resize(meshopt_buildMeshlets(&small[0], &small_vertices[0], &small_triangles[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 4, 4));
+
+	size_t padded = 0;
+
+	for (size_t i = 0; i < small.size(); ++i)
+		for (size_t j = small[i].triangle_count * 3; j & 3; ++j)
+		{
+			assert(small_triangles[small[i].triangle_offset + j] == 0);
+			padded++;
+		}
+
+	assert(padded > 0);
+	(void)padded;
+
+	// 16-bit indices go through the template wrapper
+	std::vector<unsigned short> indices16(mesh.indices.begin(), mesh.indices.end());
+	std::vector<meshopt_Meshlet> meshlets16(meshlets.size());
+	size_t meshlet_count16 = meshopt_buildMeshlets(&meshlets16[0], &meshlet_vertices[0], &meshlet_triangles[0], &indices16[0], indices16.size(), mesh.vertices.size(), max_vertices, max_triangles);
+	assert(meshlet_count16 == meshlets.size());
+	(void)meshlet_count16;
+
+	// bounds contain all meshlet vertices, and the cone only rejects meshlets that are entirely backfacing
+	float cameras[][3] = {{25, 25, 100}, {25, 25, -100}, {-100, 25, 0}, {25, 200, 10}};
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+		meshopt_Bounds bounds = meshopt_computeMeshletBounds(&meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset], m.triangle_count, &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+
+		for (size_t j = 0; j < m.vertex_count; ++j)
+		{
+			const Vertex& v = mesh.vertices[meshlet_vertices[m.vertex_offset + j]];
+			float dx = v.px - bounds.center[0], dy = v.py - bounds.center[1], dz = v.pz - bounds.center[2];
+
+			assert(sqrtf(dx * dx + dy * dy + dz * dz) <= bounds.radius * 1.0001f + 1e-5f);
+			(void)dx;
+			(void)dy;
+			(void)dz;
+		}
+
+		for (size_t c = 0; c < sizeof(cameras) / sizeof(cameras[0]); ++c)
+		{
+			const float* camera = cameras[c];
+
+			float d[3] = {bounds.cone_apex[0] - camera[0], bounds.cone_apex[1] - camera[1], bounds.cone_apex[2] - camera[2]};
+			float dl = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+			if (d[0] * bounds.cone_axis[0] + d[1] * bounds.cone_axis[1] + d[2] * bounds.cone_axis[2] < bounds.cone_cutoff * dl)
+				continue;
+
+			for (size_t j = 0; j < m.triangle_count; ++j)
+			{
+				const Vertex& v0 = mesh.vertices[meshlet_vertices[m.vertex_offset + meshlet_triangles[m.triangle_offset + j * 3 + 0]]];
+				const Vertex& v1 = mesh.vertices[meshlet_vertices[m.vertex_offset + meshlet_triangles[m.triangle_offset + j * 3 + 1]]];
+				const Vertex& v2 = mesh.vertices[meshlet_vertices[m.vertex_offset + meshlet_triangles[m.triangle_offset + j * 3 + 2]]];
+
+				float e1[3] = {v1.px - v0.px, v1.py - v0.py, v1.pz - v0.pz};
+				float e2[3] = {v2.px - v0.px, v2.py - v0.py, v2.pz - v0.pz};
+				float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+
+				assert(n[0] * (v0.px - camera[0]) + n[1] * (v0.py - camera[1]) + n[2] * (v0.pz - camera[2]) >= 0);
+				(void)n;
+			}
+		}
+	}
+
+	// degenerate clusters are always rejected
+	unsigned int degenerate[] = {0, 0, 1};
+	meshopt_Bounds bounds = meshopt_computeClusterBounds(degenerate, 3, &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+	assert(bounds.radius == 0 && bounds.cone_cutoff == 0);
+	(void)bounds;
+}
+
 bool loadMesh(Mesh& mesh, const char* path)
 {
 	if (path)
@@ -773,23 +3134,39 @@ void process(const char* path)
 	optimize(mesh, "Random", optRandomShuffle);
 	optimize(mesh, "Cache", optCache);
 	optimize(mesh, "CacheFifo", optCacheFifo);
+	optimize(mesh, "CacheP", optCacheParallel);
 	optimize(mesh, "Overdraw", optOverdraw);
 	optimize(mesh, "Fetch", optFetch);
 	optimize(mesh, "FetchMap", optFetchRemap);
 	optimize(mesh, "Complete", optComplete);
+	optimizePipeline(mesh);
+	optimizeBatch(mesh);
+	optimizeCacheProfile(mesh);
+	optimizeCacheThroughput(mesh);
+	optimizeOverdrawOctants(mesh);
+	optimizeFetchPasses(mesh);
+	shadowIndex(mesh);
+	analyzeOverdraw(mesh);
 
 	Mesh copy = mesh;
 	meshopt_optimizeVertexCache(&copy.indices[0], &copy.indices[0], copy.indices.size(), copy.vertices.size());
 	meshopt_optimizeVertexFetch(&copy.vertices[0], &copy.indices[0], copy.indices.size(), &copy.vertices[0], copy.vertices.size(), sizeof(Vertex));
 
 	stripify(copy);
+	meshlets(copy);
 
 	encodeIndex(copy);
 	packVertex<PackedVertex>(copy, "");
 	encodeVertex<PackedVertex>(copy, "");
 	encodeVertex<PackedVertexOct>(copy, "O");
+	encodeVertexLevels(copy);
+	encodeFilters(copy);
 
 	simplify(mesh);
+	simplifyAttributes(mesh);
+	simplifyQueue(mesh);
+	simplifyChain(mesh);
+	simplifyParallel(mesh);
 }
 
 void processDev(const char* path)
@@ -805,6 +3182,24 @@ void processCoverage()
 {
 	encodeIndexCoverage();
 	encodeVertexCoverage();
+	encodeVertexLevelCoverage();
+	vertexKernelCoverage();
+	allocatorCoverage();
+	instrumentationCoverage();
+	remapCoverage();
+	shadowIndexCoverage();
+	optimizeCacheCoverage();
+	optimizeCacheProfileCoverage();
+	stripifyCoverage();
+	simplifyCoverage();
+	meshletsCoverage();
+	analyzeOverdrawCoverage();
+	optimizeOverdrawOctantsCoverage();
+	optimizeFetchPassesCoverage();
+	optimizeMeshCoverage();
+	batchCoverage();
+	containerCoverage();
+	filterCoverage();
 }
 
 int main(int argc, char** argv)
@@ -0,0 +1,214 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+// The container is a header, a table of chunk entries and the encoded data of each chunk
+// All table fields are stored as 32-bit little-endian values, so that the table can be read from a memory-mapped file on any platform
+namespace meshopt
+{
+
+const unsigned char kContainerMagic[4] = {'M', 'O', 'P', 'C'};
+const unsigned int kContainerVersion = 0;
+
+const size_t kContainerHeaderSize = 16;
+const size_t kContainerEntrySize = 48;
+
+static void writeU32(unsigned char* data, unsigned int v)
+{
+	data[0] = static_cast<unsigned char>(v);
+	data[1] = static_cast<unsigned char>(v >> 8);
+	data[2] = static_cast<unsigned char>(v >> 16);
+	data[3] = static_cast<unsigned char>(v >> 24);
+}
+
+static unsigned int readU32(const unsigned char* data)
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | (unsigned(data[3]) << 24);
+}
+
+static void writeF32(unsigned char* data, float v)
+{
+	unsigned int u;
+	memcpy(&u, &v, sizeof(u));
+	writeU32(data, u);
+}
+
+static float readF32(const unsigned char* data)
+{
+	unsigned int u = readU32(data);
+	float v;
+	memcpy(&v, &u, sizeof(v));
+	return v;
+}
+
+static void writeChunk(unsigned char* data, const meshopt_ContainerChunk& chunk)
+{
+	writeU32(data + 0, chunk.type);
+	writeU32(data + 4, chunk.version);
+	writeU32(data + 8, chunk.count);
+	writeU32(data + 12, chunk.size);
+	writeU32(data + 16, chunk.offset);
+	writeU32(data + 20, chunk.length);
+
+	for (int k = 0; k < 3; ++k)
+	{
+		writeF32(data + 24 + k * 4, chunk.bounds_min[k]);
+		writeF32(data + 36 + k * 4, chunk.bounds_max[k]);
+	}
+}
+
+static void readChunk(meshopt_ContainerChunk& chunk, const unsigned char* data)
+{
+	chunk.type = readU32(data + 0);
+	chunk.version = readU32(data + 4);
+	chunk.count = readU32(data + 8);
+	chunk.size = readU32(data + 12);
+	chunk.offset = readU32(data + 16);
+	chunk.length = readU32(data + 20);
+
+	for (int k = 0; k < 3; ++k)
+	{
+		chunk.bounds_min[k] = readF32(data + 24 + k * 4);
+		chunk.bounds_max[k] = readF32(data + 36 + k * 4);
+	}
+}
+
+static bool readHeader(size_t& chunk_count, const unsigned char* buffer, size_t buffer_size)
+{
+	if (buffer_size < kContainerHeaderSize || memcmp(buffer, kContainerMagic, 4) != 0)
+		return false;
+
+	if (readU32(buffer + 4) != kContainerVersion)
+		return false;
+
+	chunk_count = readU32(buffer + 8);
+
+	// the recorded size guards against truncated files; the table has to fit as well
+	if (readU32(buffer + 12) > buffer_size || chunk_count > (buffer_size - kContainerHeaderSize) / kContainerEntrySize)
+		return false;
+
+	return true;
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeContainerBound(const meshopt_ContainerChunk* chunks, size_t chunk_count)
+{
+	using namespace meshopt;
+
+	size_t result = kContainerHeaderSize + chunk_count * kContainerEntrySize;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+		result += chunks[i].length;
+
+	return result;
+}
+
+size_t meshopt_encodeContainer(unsigned char* buffer, size_t buffer_size, meshopt_ContainerChunk* chunks, const unsigned char* const* chunk_data, size_t chunk_count)
+{
+	using namespace meshopt;
+
+	size_t total_size = meshopt_encodeContainerBound(chunks, chunk_count);
+
+	// offsets and sizes are stored as 32-bit values
+	if (total_size != unsigned(total_size))
+		return 0;
+
+	if (buffer_size < total_size)
+		return 0;
+
+	size_t offset = kContainerHeaderSize + chunk_count * kContainerEntrySize;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		meshopt_ContainerChunk& chunk = chunks[i];
+
+		assert(chunk.type == meshopt_ChunkVertexBuffer || chunk.type == meshopt_ChunkIndexBuffer);
+		assert(chunk.type == meshopt_ChunkIndexBuffer || (chunk.size > 0 && chunk.size <= 256 && chunk.size % 4 == 0));
+		assert(chunk.type == meshopt_ChunkVertexBuffer || chunk.count % 3 == 0);
+		// chunk data must start with the header byte of the matching codec (0xa0 for vertex buffers, 0xe0 for index buffers)
+		assert(chunk.length > 0 && (chunk_data[i][0] & 0xf0) == (chunk.type == meshopt_ChunkVertexBuffer ? 0xa0 : 0xe0));
+
+		// the codec version is recorded in the table so that readers can skip unsupported chunks without touching their data
+		chunk.version = chunk_data[i][0] & 0xf;
+		chunk.offset = unsigned(offset);
+
+		memcpy(buffer + offset, chunk_data[i], chunk.length);
+		writeChunk(buffer + kContainerHeaderSize + i * kContainerEntrySize, chunk);
+
+		offset += chunk.length;
+	}
+
+	assert(offset == total_size);
+
+	memcpy(buffer, kContainerMagic, 4);
+	writeU32(buffer + 4, kContainerVersion);
+	writeU32(buffer + 8, unsigned(chunk_count));
+	writeU32(buffer + 12, unsigned(total_size));
+
+	return total_size;
+}
+
+size_t meshopt_getContainerChunkCount(const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	size_t chunk_count = 0;
+
+	return readHeader(chunk_count, buffer, buffer_size) ? chunk_count : 0;
+}
+
+int meshopt_getContainerChunk(meshopt_ContainerChunk* chunk, const unsigned char* buffer, size_t buffer_size, size_t index)
+{
+	using namespace meshopt;
+
+	size_t chunk_count = 0;
+
+	if (!readHeader(chunk_count, buffer, buffer_size))
+		return -1;
+
+	if (index >= chunk_count)
+		return -2;
+
+	readChunk(*chunk, buffer + kContainerHeaderSize + index * kContainerEntrySize);
+
+	if (chunk->type != meshopt_ChunkVertexBuffer && chunk->type != meshopt_ChunkIndexBuffer)
+		return -3;
+
+	if (chunk->offset > buffer_size || chunk->length > buffer_size - chunk->offset)
+		return -4;
+
+	return 0;
+}
+
+int meshopt_decodeContainerChunk(void* destination, size_t index_size, const unsigned char* buffer, size_t buffer_size, size_t index)
+{
+	using namespace meshopt;
+
+	meshopt_ContainerChunk chunk;
+
+	int rc = meshopt_getContainerChunk(&chunk, buffer, buffer_size, index);
+	if (rc != 0)
+		return rc;
+
+	const unsigned char* data = buffer + chunk.offset;
+
+	if (chunk.type == meshopt_ChunkVertexBuffer)
+	{
+		if (chunk.size == 0 || chunk.size > 256 || chunk.size % 4 != 0)
+			return -5;
+
+		return meshopt_decodeVertexBuffer(destination, chunk.count, chunk.size, data, chunk.length) == 0 ? 0 : -6;
+	}
+	else
+	{
+		assert(index_size == 2 || index_size == 4);
+
+		if (chunk.count % 3 != 0)
+			return -5;
+
+		return meshopt_decodeIndexBuffer(destination, chunk.count, index_size, data, chunk.length) == 0 ? 0 : -6;
+	}
+}
@@ -144,28 +144,317 @@ static int getCodeAuxIndex(unsigned char v, const unsigned char* table)
 	return -1;
 }
 
-static void writeTriangle(void* destination, size_t offset, size_t index_size, unsigned int a, unsigned int b, unsigned int c)
+template <typename T>
+static void writeTriangle(T* destination, size_t offset, unsigned int a, unsigned int b, unsigned int c)
 {
-	if (index_size == 2)
+	destination[offset + 0] = static_cast<T>(a);
+	destination[offset + 1] = static_cast<T>(b);
+	destination[offset + 2] = static_cast<T>(c);
+}
+
+template <typename T>
+static int decodeIndexBuffer(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size, meshopt_IndexDecoderState& state)
+{
+	// decoder state is kept in locals during decoding so that the compiler can keep it in registers
+	EdgeFifo edgefifo;
+	memcpy(edgefifo, state.edgefifo, sizeof(edgefifo));
+
+	VertexFifo vertexfifo;
+	memcpy(vertexfifo, state.vertexfifo, sizeof(vertexfifo));
+
+	size_t edgefifooffset = state.edgefifooffset;
+	size_t vertexfifooffset = state.vertexfifooffset;
+
+	unsigned int next = state.next;
+	unsigned int last = state.last;
+
+	// every triangle pushes edge a-c last, and edge triangles with fe=0 are very common in vertex cache optimized meshes
+	// keeping that edge in registers avoids a store-to-load dependency through edgefifo on the critical path
+	unsigned int lasta = state.lasta, lastc = state.lastc;
+
+	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
+	const unsigned char* code = buffer + 1 + state.index_offset / 3;
+	const unsigned char* data = buffer + state.data_offset;
+	const unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+	const unsigned char* codeaux_table = data_safe_end;
+
+	for (size_t i = 0; i < index_count; i += 3)
 	{
-		static_cast<unsigned short*>(destination)[offset + 0] = static_cast<unsigned short>(a);
-		static_cast<unsigned short*>(destination)[offset + 1] = static_cast<unsigned short>(b);
-		static_cast<unsigned short*>(destination)[offset + 2] = static_cast<unsigned short>(c);
+		// make sure we have enough data to read for a triangle
+		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
+		// after this we can be sure we can read without extra bounds checks
+		if (data > data_safe_end)
+			return -2;
+
+		unsigned char codetri = *code++;
+
+		if (codetri < 0xf0 && (codetri & 15) != 15)
+		{
+			int fe = codetri >> 4;
+
+			// fifo reads are wrapped around 16 entry buffer; the most recent edge is kept in registers (see lasta/lastc)
+			unsigned int a = (fe == 0) ? lasta : edgefifo[(edgefifooffset - 1 - fe) & 15][0];
+			unsigned int b = (fe == 0) ? lastc : edgefifo[(edgefifooffset - 1 - fe) & 15][1];
+
+			int fec = codetri & 15;
+
+			// note: this is the most common path in the entire decoder
+			// inside this if we try to stay branchless (by using cmov/etc.) since these aren't predictable
+			unsigned int cf = vertexfifo[(vertexfifooffset - 1 - fec) & 15];
+			unsigned int c = (fec == 0) ? next : cf;
+
+			int fec0 = fec == 0;
+			next += fec0;
+
+			// output triangle
+			writeTriangle(destination, i, a, b, c);
+
+			// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+			pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+
+			lasta = a, lastc = c;
+		}
+		else if (codetri >= 0xf0 && codetri < 0xfe)
+		{
+			unsigned char codeaux = codeaux_table[codetri & 15];
+
+			// note: table can't contain feb/fec=15
+			int feb = codeaux >> 4;
+			int fec = codeaux & 15;
+
+			// fifo reads are wrapped around 16 entry buffer
+			// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
+			unsigned int a = next++;
+
+			unsigned int bf = vertexfifo[(vertexfifooffset - feb) & 15];
+			unsigned int b = (feb == 0) ? next : bf;
+
+			int feb0 = feb == 0;
+			next += feb0;
+
+			unsigned int cf = vertexfifo[(vertexfifooffset - fec) & 15];
+			unsigned int c = (fec == 0) ? next : cf;
+
+			int fec0 = fec == 0;
+			next += fec0;
+
+			// output triangle
+			writeTriangle(destination, i, a, b, c);
+
+			// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+			pushVertexFifo(vertexfifo, a, vertexfifooffset);
+			pushVertexFifo(vertexfifo, b, vertexfifooffset, feb0);
+			pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+
+			pushEdgeFifo(edgefifo, b, a, edgefifooffset);
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+
+			lasta = a, lastc = c;
+		}
+		else if (codetri < 0xf0)
+		{
+			int fe = codetri >> 4;
+
+			// fifo reads are wrapped around 16 entry buffer
+			unsigned int a = edgefifo[(edgefifooffset - 1 - fe) & 15][0];
+			unsigned int b = edgefifo[(edgefifooffset - 1 - fe) & 15][1];
+
+			unsigned int c = 0;
+
+			// note that we need to update the last index since free indices are delta-encoded
+			last = c = decodeIndex(data, next, last);
+
+			// output triangle
+			writeTriangle(destination, i, a, b, c);
+
+			// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+			pushVertexFifo(vertexfifo, c, vertexfifooffset);
+
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+
+			lasta = a, lastc = c;
+		}
+		else
+		{
+			// slow path: read a full byte for codeaux instead of using a table lookup
+			unsigned char codeaux = *data++;
+
+			int fea = codetri == 0xfe ? 0 : 15;
+			int feb = codeaux >> 4;
+			int fec = codeaux & 15;
+
+			// fifo reads are wrapped around 16 entry buffer
+			// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
+			unsigned int a = (fea == 0) ? next++ : 0;
+			unsigned int b = (feb == 0) ? next++ : vertexfifo[(vertexfifooffset - feb) & 15];
+			unsigned int c = (fec == 0) ? next++ : vertexfifo[(vertexfifooffset - fec) & 15];
+
+			// note that we need to update the last index since free indices are delta-encoded
+			if (fea == 15)
+				last = a = decodeIndex(data, next, last);
+
+			if (feb == 15)
+				last = b = decodeIndex(data, next, last);
+
+			if (fec == 15)
+				last = c = decodeIndex(data, next, last);
+
+			// output triangle
+			writeTriangle(destination, i, a, b, c);
+
+			// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+			pushVertexFifo(vertexfifo, a, vertexfifooffset);
+			pushVertexFifo(vertexfifo, b, vertexfifooffset, (feb == 0) | (feb == 15));
+			pushVertexFifo(vertexfifo, c, vertexfifooffset, (fec == 0) | (fec == 15));
+
+			pushEdgeFifo(edgefifo, b, a, edgefifooffset);
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+
+			lasta = a, lastc = c;
+		}
 	}
+
+	memcpy(state.edgefifo, edgefifo, sizeof(edgefifo));
+	memcpy(state.vertexfifo, vertexfifo, sizeof(vertexfifo));
+
+	state.edgefifooffset = edgefifooffset;
+	state.vertexfifooffset = vertexfifooffset;
+
+	state.next = next;
+	state.last = last;
+	state.lasta = lasta;
+	state.lastc = lastc;
+
+	state.index_offset += index_count;
+	state.data_offset = data - buffer;
+
+	// we should've read all data bytes and stopped at the boundary between data and codeaux table
+	if (state.index_offset == state.index_count && data != data_safe_end)
+		return -3;
+
+	return 0;
+}
+
+static int decodeIndexStream(meshopt_IndexDecoderState& state, void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+
+	if (index_count > state.index_count - state.index_offset)
+		return -2;
+
+	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
+	if (buffer_size < 1 + state.index_count / 3 + 16)
+		return -2;
+
+	if (buffer[0] != kIndexHeader)
+		return -1;
+
+	if (index_size == 2)
+		return decodeIndexBuffer(static_cast<unsigned short*>(destination), index_count, buffer, buffer_size, state);
 	else
+		return decodeIndexBuffer(static_cast<unsigned int*>(destination), index_count, buffer, buffer_size, state);
+}
+
+static void buildCodeAuxTable(unsigned char* table, const unsigned int* counts)
+{
+	bool used[256] = {};
+
+	// pick 14 most frequent values greedily; this is optimal since each table hit saves exactly one byte
+	for (size_t i = 0; i < 14; ++i)
 	{
-		static_cast<unsigned int*>(destination)[offset + 0] = a;
-		static_cast<unsigned int*>(destination)[offset + 1] = b;
-		static_cast<unsigned int*>(destination)[offset + 2] = c;
+		int best = -1;
+
+		for (int v = 0; v < 256; ++v)
+			if (!used[v] && counts[v] > 0 && (best < 0 || counts[v] > counts[best]))
+				best = v;
+
+		if (best < 0)
+			break;
+
+		table[i] = static_cast<unsigned char>(best);
+		used[best] = true;
 	}
 }
 
-} // namespace meshopt
-
-size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+// gathers codeaux statistics without producing output; fifo updates must match encodeIndexBuffer, and table contents don't affect fifo state so the statistics are exact
+static void countCodeAux(unsigned int* codeaux_counts, const unsigned int* indices, size_t index_count)
 {
-	using namespace meshopt;
+	assert(index_count % 3 == 0);
+
+	EdgeFifo edgefifo;
+	memset(edgefifo, -1, sizeof(edgefifo));
+
+	VertexFifo vertexfifo;
+	memset(vertexfifo, -1, sizeof(vertexfifo));
+
+	size_t edgefifooffset = 0;
+	size_t vertexfifooffset = 0;
+
+	unsigned int next = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		int fer = getEdgeFifo(edgefifo, indices[i + 0], indices[i + 1], indices[i + 2], edgefifooffset);
+
+		if (fer >= 0 && (fer >> 2) < 15)
+		{
+			const unsigned int* order = kTriangleIndexOrder[fer & 3];
+
+			unsigned int a = indices[i + order[0]], b = indices[i + order[1]], c = indices[i + order[2]];
+
+			int fc = getVertexFifo(vertexfifo, c, vertexfifooffset);
+			int fec = (fc >= 1 && fc < 15) ? fc : (c == next) ? (next++, 0) : 15;
+
+			if (fec == 0 || fec == 15)
+				pushVertexFifo(vertexfifo, c, vertexfifooffset);
+
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+		}
+		else
+		{
+			int rotation = rotateTriangle(indices[i + 0], indices[i + 1], indices[i + 2], next);
+			const unsigned int* order = kTriangleIndexOrder[rotation];
+
+			unsigned int a = indices[i + order[0]], b = indices[i + order[1]], c = indices[i + order[2]];
+
+			int fb = getVertexFifo(vertexfifo, b, vertexfifooffset);
+			int fc = getVertexFifo(vertexfifo, c, vertexfifooffset);
+
+			int fea = (a == next) ? (next++, 0) : 15;
+			int feb = (fb >= 0 && fb < 14) ? (fb + 1) : (b == next) ? (next++, 0) : 15;
+			int fec = (fc >= 0 && fc < 14) ? (fc + 1) : (c == next) ? (next++, 0) : 15;
+
+			// only codeaux values that can be encoded using the table are counted
+			if (fea == 0 && feb != 15 && fec != 15)
+				codeaux_counts[(feb << 4) | fec]++;
+
+			if (fea == 0 || fea == 15)
+				pushVertexFifo(vertexfifo, a, vertexfifooffset);
+
+			if (feb == 0 || feb == 15)
+				pushVertexFifo(vertexfifo, b, vertexfifooffset);
+
+			if (fec == 0 || fec == 15)
+				pushVertexFifo(vertexfifo, c, vertexfifooffset);
+
+			pushEdgeFifo(edgefifo, b, a, edgefifooffset);
+			pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+			pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+		}
+	}
+}
 
+static size_t encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, const unsigned char* codeaux_table)
+{
 	assert(index_count % 3 == 0);
 
 	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
@@ -190,10 +479,6 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	unsigned char* data = code + index_count / 3;
 	unsigned char* data_safe_end = buffer + buffer_size - 16;
 
-	// use static encoding table; it's possible to pack the result and then build an optimal table and repack
-	// for now we keep it simple and use the table that has been generated based on symbol frequency on a training mesh set
-	const unsigned char* codeaux_table = kCodeAuxEncodingTable;
-
 	for (size_t i = 0; i < index_count; i += 3)
 	{
 		// make sure we have enough space to write a triangle
@@ -308,194 +593,97 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	return data - buffer;
 }
 
-size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+} // namespace meshopt
+
+size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
 {
-	assert(index_count % 3 == 0);
+	using namespace meshopt;
 
-	// compute number of bits required for each index
-	unsigned int vertex_bits = 1;
+	meshopt_Instrumentation<void>::report("encodeIndexBuffer", "start", index_count);
 
-	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
-		vertex_bits++;
+	// use static encoding table that has been generated based on symbol frequency on a training mesh set
+	size_t result = encodeIndexBuffer(buffer, buffer_size, indices, index_count, kCodeAuxEncodingTable);
 
-	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
-	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
+	if (result)
+		meshopt_Instrumentation<void>::report("encodeIndexBuffer", "encode", index_count, 0, 0, index_count * sizeof(unsigned int), result);
 
-	return 1 + (index_count / 3) * (2 + 3 * vertex_groups) + 16;
+	return result;
 }
 
-int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+size_t meshopt_encodeIndexBufferAdaptive(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
 {
 	using namespace meshopt;
 
-	assert(index_count % 3 == 0);
-	assert(index_size == 2 || index_size == 4);
-
-	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
-	if (buffer_size < 1 + index_count / 3 + 16)
-		return -2;
+	meshopt_Instrumentation<void>::report("encodeIndexBufferAdaptive", "start", index_count);
 
-	if (buffer[0] != kIndexHeader)
-		return -1;
+	// the first pass only gathers codeaux statistics, so buffer only needs enough space for the final output
+	unsigned int codeaux_counts[256] = {};
+	countCodeAux(codeaux_counts, indices, index_count);
 
-	EdgeFifo edgefifo;
-	memset(edgefifo, -1, sizeof(edgefifo));
+	// if the data has fewer than 14 distinct values, the rest of the table keeps the static entries
+	unsigned char codeaux_table[16];
+	memcpy(codeaux_table, kCodeAuxEncodingTable, 16);
 
-	VertexFifo vertexfifo;
-	memset(vertexfifo, -1, sizeof(vertexfifo));
+	buildCodeAuxTable(codeaux_table, codeaux_counts);
 
-	size_t edgefifooffset = 0;
-	size_t vertexfifooffset = 0;
-
-	unsigned int next = 0;
-	unsigned int last = 0;
+	size_t result = encodeIndexBuffer(buffer, buffer_size, indices, index_count, codeaux_table);
 
-	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
-	const unsigned char* code = buffer + 1;
-	const unsigned char* data = code + index_count / 3;
-	const unsigned char* data_safe_end = buffer + buffer_size - 16;
-
-	const unsigned char* codeaux_table = data_safe_end;
+	if (result)
+		meshopt_Instrumentation<void>::report("encodeIndexBufferAdaptive", "encode", index_count, 0, 0, index_count * sizeof(unsigned int), result);
 
-	for (size_t i = 0; i < index_count; i += 3)
-	{
-		// make sure we have enough data to read for a triangle
-		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
-		// after this we can be sure we can read without extra bounds checks
-		if (data > data_safe_end)
-			return -2;
-
-		unsigned char codetri = *code++;
-
-		if (codetri < 0xf0)
-		{
-			int fe = codetri >> 4;
-
-			// fifo reads are wrapped around 16 entry buffer
-			unsigned int a = edgefifo[(edgefifooffset - 1 - fe) & 15][0];
-			unsigned int b = edgefifo[(edgefifooffset - 1 - fe) & 15][1];
-
-			int fec = codetri & 15;
-
-			// note: this is the most common path in the entire decoder
-			// inside this if we try to stay branchless (by using cmov/etc.) since these aren't predictable
-			if (fec != 15)
-			{
-				// fifo reads are wrapped around 16 entry buffer
-				unsigned int cf = vertexfifo[(vertexfifooffset - 1 - fec) & 15];
-				unsigned int c = (fec == 0) ? next : cf;
-
-				int fec0 = fec == 0;
-				next += fec0;
-
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
-
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
-
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-			else
-			{
-				unsigned int c = 0;
-
-				// note that we need to update the last index since free indices are delta-encoded
-				last = c = decodeIndex(data, next, last);
-
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
-
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset);
-
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-		}
-		else
-		{
-			// fast path: read codeaux from the table
-			if (codetri < 0xfe)
-			{
-				unsigned char codeaux = codeaux_table[codetri & 15];
-
-				// note: table can't contain feb/fec=15
-				int feb = codeaux >> 4;
-				int fec = codeaux & 15;
-
-				// fifo reads are wrapped around 16 entry buffer
-				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
-				unsigned int a = next++;
-
-				unsigned int bf = vertexfifo[(vertexfifooffset - feb) & 15];
-				unsigned int b = (feb == 0) ? next : bf;
+	return result;
+}
 
-				int feb0 = feb == 0;
-				next += feb0;
+size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+{
+	assert(index_count % 3 == 0);
 
-				unsigned int cf = vertexfifo[(vertexfifooffset - fec) & 15];
-				unsigned int c = (fec == 0) ? next : cf;
+	// compute number of bits required for each index
+	unsigned int vertex_bits = 1;
 
-				int fec0 = fec == 0;
-				next += fec0;
+	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
+		vertex_bits++;
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
+	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, a, vertexfifooffset);
-				pushVertexFifo(vertexfifo, b, vertexfifooffset, feb0);
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+	return 1 + (index_count / 3) * (2 + 3 * vertex_groups) + 16;
+}
 
-				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-			else
-			{
-				// slow path: read a full byte for codeaux instead of using a table lookup
-				unsigned char codeaux = *data++;
+int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
 
-				int fea = codetri == 0xfe ? 0 : 15;
-				int feb = codeaux >> 4;
-				int fec = codeaux & 15;
+	meshopt_Instrumentation<void>::report("decodeIndexBuffer", "start", index_count);
 
-				// fifo reads are wrapped around 16 entry buffer
-				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
-				unsigned int a = (fea == 0) ? next++ : 0;
-				unsigned int b = (feb == 0) ? next++ : vertexfifo[(vertexfifooffset - feb) & 15];
-				unsigned int c = (fec == 0) ? next++ : vertexfifo[(vertexfifooffset - fec) & 15];
+	meshopt_IndexDecoderState state;
+	meshopt_decodeIndexStreamBegin(&state, index_count);
 
-				// note that we need to update the last index since free indices are delta-encoded
-				if (fea == 15)
-					last = a = decodeIndex(data, next, last);
+	int rc = decodeIndexStream(state, destination, index_count, index_size, buffer, buffer_size);
 
-				if (feb == 15)
-					last = b = decodeIndex(data, next, last);
+	if (rc == 0)
+		meshopt_Instrumentation<void>::report("decodeIndexBuffer", "decode", index_count, 0, 0, buffer_size, index_count * index_size);
 
-				if (fec == 15)
-					last = c = decodeIndex(data, next, last);
+	return rc;
+}
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+void meshopt_decodeIndexStreamBegin(meshopt_IndexDecoderState* state, size_t index_count)
+{
+	assert(index_count % 3 == 0);
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, a, vertexfifooffset);
-				pushVertexFifo(vertexfifo, b, vertexfifooffset, (feb == 0) | (feb == 15));
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, (fec == 0) | (fec == 15));
+	memset(state, 0, sizeof(meshopt_IndexDecoderState));
+	memset(state->edgefifo, -1, sizeof(state->edgefifo));
+	memset(state->vertexfifo, -1, sizeof(state->vertexfifo));
 
-				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-		}
-	}
+	state->index_count = index_count;
+	state->data_offset = 1 + index_count / 3;
+	state->lasta = ~0u;
+	state->lastc = ~0u;
+}
 
-	// we should've read all data bytes and stopped at the boundary between data and codeaux table
-	if (data != data_safe_end)
-		return -3;
+int meshopt_decodeIndexStream(meshopt_IndexDecoderState* state, void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
 
-	return 0;
+	return decodeIndexStream(*state, destination, index_count, index_size, buffer, buffer_size);
 }
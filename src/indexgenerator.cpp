@@ -1,5 +1,6 @@
 // This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
 #include "meshoptimizer.h"
+#include "parallel.h"
 
 #include <assert.h>
 #include <string.h>
@@ -7,43 +8,49 @@
 namespace meshopt
 {
 
-struct VertexHasher
+static unsigned int hashUpdate4(unsigned int h, const char* key, size_t len)
 {
-	const char* vertices;
-	size_t vertex_stride;
-	size_t vertex_size;
+	// MurmurHash2
+	const unsigned int m = 0x5bd1e995;
+	const int r = 24;
 
-	size_t hash(unsigned int index) const
+	while (len >= 4)
 	{
-		// MurmurHash2
-		const unsigned int m = 0x5bd1e995;
-		const int r = 24;
+		unsigned int k = *reinterpret_cast<const unsigned int*>(key);
 
-		unsigned int h = 0;
-		const char* key = vertices + index * vertex_stride;
-		size_t len = vertex_size;
+		k *= m;
+		k ^= k >> r;
+		k *= m;
 
-		while (len >= 4)
-		{
-			unsigned int k = *reinterpret_cast<const unsigned int*>(key);
+		h *= m;
+		h ^= k;
 
-			k *= m;
-			k ^= k >> r;
-			k *= m;
+		key += 4;
+		len -= 4;
+	}
 
-			h *= m;
-			h ^= k;
+	return h;
+}
 
-			key += 4;
-			len -= 4;
-		}
+// Size is the vertex size when known at compile time for common vertex formats, which lets the compiler unroll hashing and comparison; 0 uses vertex_size
+template <size_t Size>
+struct VertexHasher
+{
+	const char* vertices;
+	size_t vertex_size;
 
-		return h;
+	size_t hash(unsigned int index) const
+	{
+		size_t size = Size ? Size : vertex_size;
+
+		return hashUpdate4(0, vertices + index * size, size);
 	}
 
 	bool equal(unsigned int lhs, unsigned int rhs) const
 	{
-		return memcmp(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride, vertex_size) == 0;
+		size_t size = Size ? Size : vertex_size;
+
+		return memcmp(vertices + lhs * size, vertices + rhs * size, size) == 0;
 	}
 };
 
@@ -83,19 +90,189 @@ static T* hashLookup(T* table, size_t buckets, const Hash& hash, const T& key, c
 	return 0;
 }
 
-} // namespace meshopt
+struct VertexStreamHasher
+{
+	const meshopt_Stream* streams;
+	size_t stream_count;
 
-size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+	size_t hash(unsigned int index) const
+	{
+		unsigned int h = 0;
+
+		for (size_t i = 0; i < stream_count; ++i)
+		{
+			const meshopt_Stream& s = streams[i];
+			const char* data = static_cast<const char*>(s.data);
+
+			h = hashUpdate4(h, data + index * s.stride, s.size);
+		}
+
+		return h;
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		for (size_t i = 0; i < stream_count; ++i)
+		{
+			const meshopt_Stream& s = streams[i];
+			const char* data = static_cast<const char*>(s.data);
+
+			if (memcmp(data + lhs * s.stride, data + rhs * s.stride, s.size) != 0)
+				return false;
+		}
+
+		return true;
+	}
+};
+
+template <size_t Size>
+struct RemapHasher
 {
-	using namespace meshopt;
+	const char* vertices;
+	size_t vertex_size;
+	const unsigned int* hashes;
 
-	assert(indices || index_count == vertex_count);
-	assert(index_count % 3 == 0);
-	assert(vertex_size > 0 && vertex_size <= 256);
+	size_t hash(unsigned int index) const
+	{
+		return hashes[index];
+	}
 
-	memset(destination, -1, vertex_count * sizeof(unsigned int));
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		size_t size = Size ? Size : vertex_size;
+
+		return memcmp(vertices + lhs * size, vertices + rhs * size, size) == 0;
+	}
+};
+
+struct RemapPartitionData
+{
+	const char* vertices;
+	size_t vertex_count;
+	size_t vertex_size;
+
+	// vertices are split into partition_count chunks by index, and into partition_count partitions by the top bits of the hash
+	size_t partition_count;
+	int partition_shift;
+
+	unsigned int* hashes;
+	unsigned int* histogram; // [chunk * partition_count + partition]
+	unsigned int* partition_offsets; // partition_count + 1 entries, into order
+	unsigned int* table_offsets; // partition_count + 1 entries, into table
 
-	VertexHasher hasher = {static_cast<const char*>(vertices), vertex_size, vertex_size};
+	unsigned int* order; // vertices sorted by partition, in ascending index order within a partition
+	unsigned int* table;
+	unsigned int* canonical; // lowest index of a binary equivalent vertex
+
+	unsigned int* destination;
+};
+
+template <size_t Size>
+static void remapHashChunk(void* task_data, size_t index)
+{
+	RemapPartitionData& data = *static_cast<RemapPartitionData*>(task_data);
+
+	size_t begin = index * data.vertex_count / data.partition_count;
+	size_t end = (index + 1) * data.vertex_count / data.partition_count;
+
+	VertexHasher<Size> hasher = {data.vertices, data.vertex_size};
+
+	unsigned int* histogram = data.histogram + index * data.partition_count;
+	memset(histogram, 0, data.partition_count * sizeof(unsigned int));
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int h = unsigned(hasher.hash(unsigned(i)));
+
+		data.hashes[i] = h;
+		histogram[h >> data.partition_shift]++;
+	}
+}
+
+static void remapScatterChunk(void* task_data, size_t index)
+{
+	RemapPartitionData& data = *static_cast<RemapPartitionData*>(task_data);
+
+	size_t begin = index * data.vertex_count / data.partition_count;
+	size_t end = (index + 1) * data.vertex_count / data.partition_count;
+
+	// histogram contains the starting offset of each partition for this chunk at this point
+	unsigned int* offsets = data.histogram + index * data.partition_count;
+
+	for (size_t i = begin; i < end; ++i)
+		data.order[offsets[data.hashes[i] >> data.partition_shift]++] = unsigned(i);
+}
+
+template <size_t Size>
+static void remapPartition(void* task_data, size_t index)
+{
+	RemapPartitionData& data = *static_cast<RemapPartitionData*>(task_data);
+
+	RemapHasher<Size> hasher = {data.vertices, data.vertex_size, data.hashes};
+
+	unsigned int* table = data.table + data.table_offsets[index];
+	size_t table_size = data.table_offsets[index + 1] - data.table_offsets[index];
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	// since vertices are visited in ascending order, the first vertex of each class to be inserted is the one with the lowest index
+	for (size_t i = data.partition_offsets[index]; i < data.partition_offsets[index + 1]; ++i)
+	{
+		unsigned int vertex = data.order[i];
+		unsigned int* entry = hashLookup(table, table_size, hasher, vertex, ~0u);
+
+		if (*entry == ~0u)
+			*entry = vertex;
+
+		data.canonical[vertex] = *entry;
+	}
+}
+
+static void remapCountChunk(void* task_data, size_t index)
+{
+	RemapPartitionData& data = *static_cast<RemapPartitionData*>(task_data);
+
+	size_t begin = index * data.vertex_count / data.partition_count;
+	size_t end = (index + 1) * data.vertex_count / data.partition_count;
+
+	unsigned int count = 0;
+
+	for (size_t i = begin; i < end; ++i)
+		count += data.canonical[i] == i;
+
+	data.histogram[index] = count;
+}
+
+static void remapAssignCanonicalChunk(void* task_data, size_t index)
+{
+	RemapPartitionData& data = *static_cast<RemapPartitionData*>(task_data);
+
+	size_t begin = index * data.vertex_count / data.partition_count;
+	size_t end = (index + 1) * data.vertex_count / data.partition_count;
+
+	// histogram contains the number of canonical vertices in all preceding chunks at this point
+	unsigned int next_vertex = data.histogram[index];
+
+	for (size_t i = begin; i < end; ++i)
+		if (data.canonical[i] == i)
+			data.destination[i] = next_vertex++;
+}
+
+static void remapAssignChunk(void* task_data, size_t index)
+{
+	RemapPartitionData& data = *static_cast<RemapPartitionData*>(task_data);
+
+	size_t begin = index * data.vertex_count / data.partition_count;
+	size_t end = (index + 1) * data.vertex_count / data.partition_count;
+
+	for (size_t i = begin; i < end; ++i)
+		if (data.canonical[i] != i)
+			data.destination[i] = data.destination[data.canonical[i]];
+}
+
+template <typename Hasher>
+static size_t generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hasher& hasher)
+{
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
 
 	size_t table_size = hashBuckets(vertex_count);
 	meshopt_Buffer<unsigned int> table(table_size);
@@ -132,6 +309,224 @@ size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int
 	return next_vertex;
 }
 
+} // namespace meshopt
+
+size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	const char* vertex_data = static_cast<const char*>(vertices);
+
+	switch (vertex_size)
+	{
+	case 12:
+	{
+		VertexHasher<12> hasher = {vertex_data, vertex_size};
+		return generateVertexRemap(destination, indices, index_count, vertex_count, hasher);
+	}
+	case 16:
+	{
+		VertexHasher<16> hasher = {vertex_data, vertex_size};
+		return generateVertexRemap(destination, indices, index_count, vertex_count, hasher);
+	}
+	case 20:
+	{
+		VertexHasher<20> hasher = {vertex_data, vertex_size};
+		return generateVertexRemap(destination, indices, index_count, vertex_count, hasher);
+	}
+	case 24:
+	{
+		VertexHasher<24> hasher = {vertex_data, vertex_size};
+		return generateVertexRemap(destination, indices, index_count, vertex_count, hasher);
+	}
+	case 32:
+	{
+		VertexHasher<32> hasher = {vertex_data, vertex_size};
+		return generateVertexRemap(destination, indices, index_count, vertex_count, hasher);
+	}
+	default:
+	{
+		VertexHasher<0> hasher = {vertex_data, vertex_size};
+		return generateVertexRemap(destination, indices, index_count, vertex_count, hasher);
+	}
+	}
+}
+
+size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(stream_count > 0 && stream_count <= 16);
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		assert(streams[i].size > 0 && streams[i].size <= 256);
+		assert(streams[i].size <= streams[i].stride);
+	}
+
+	VertexStreamHasher hasher = {streams, stream_count};
+
+	return generateVertexRemap(destination, indices, index_count, vertex_count, hasher);
+}
+
+size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	// partitions need to be large enough to amortize the synchronization; partition count is rounded down to a power of two
+	const size_t kMinPartitionVertices = 16384;
+	const size_t kMaxPartitions = 256;
+
+	size_t partitions = 1;
+	int partition_bits = 0;
+
+	while (partitions * 2 <= partition_count && partitions * 2 <= kMaxPartitions && partitions * 2 * kMinPartitionVertices <= vertex_count)
+	{
+		partitions *= 2;
+		partition_bits++;
+	}
+
+	if (partitions <= 1)
+		return meshopt_generateVertexRemap(destination, indices, index_count, vertices, vertex_count, vertex_size);
+
+	meshopt_Buffer<unsigned int> hashes(vertex_count);
+	meshopt_Buffer<unsigned int> histogram(partitions * partitions);
+	meshopt_Buffer<unsigned int> partition_offsets(partitions + 1);
+	meshopt_Buffer<unsigned int> table_offsets(partitions + 1);
+	meshopt_Buffer<unsigned int> order(vertex_count);
+	meshopt_Buffer<unsigned int> canonical(vertex_count);
+
+	RemapPartitionData data = {};
+	data.vertices = static_cast<const char*>(vertices);
+	data.vertex_count = vertex_count;
+	data.vertex_size = vertex_size;
+	data.partition_count = partitions;
+	data.partition_shift = 32 - partition_bits;
+	data.hashes = hashes.data;
+	data.histogram = histogram.data;
+	data.partition_offsets = partition_offsets.data;
+	data.table_offsets = table_offsets.data;
+	data.order = order.data;
+	data.canonical = canonical.data;
+	data.destination = destination;
+
+	// common vertex sizes use specialized tasks, see VertexHasher
+	meshopt_ParallelTask hash_task = remapHashChunk<0>;
+	meshopt_ParallelTask partition_task = remapPartition<0>;
+
+	switch (vertex_size)
+	{
+	case 12:
+		hash_task = remapHashChunk<12>;
+		partition_task = remapPartition<12>;
+		break;
+	case 16:
+		hash_task = remapHashChunk<16>;
+		partition_task = remapPartition<16>;
+		break;
+	case 20:
+		hash_task = remapHashChunk<20>;
+		partition_task = remapPartition<20>;
+		break;
+	case 24:
+		hash_task = remapHashChunk<24>;
+		partition_task = remapPartition<24>;
+		break;
+	case 32:
+		hash_task = remapHashChunk<32>;
+		partition_task = remapPartition<32>;
+		break;
+	}
+
+	runTasks(parallel_for, context, hash_task, &data, partitions);
+
+	// convert per-chunk histograms to scatter offsets, partition-major so that each partition is contiguous in ascending vertex order
+	size_t offset = 0;
+	size_t table_size = 0;
+
+	for (size_t p = 0; p < partitions; ++p)
+	{
+		partition_offsets[p] = unsigned(offset);
+		table_offsets[p] = unsigned(table_size);
+
+		for (size_t c = 0; c < partitions; ++c)
+		{
+			unsigned int count = histogram[c * partitions + p];
+			histogram[c * partitions + p] = unsigned(offset);
+			offset += count;
+		}
+
+		table_size += hashBuckets(offset - partition_offsets[p]);
+	}
+
+	assert(offset == vertex_count);
+	partition_offsets[partitions] = unsigned(offset);
+	table_offsets[partitions] = unsigned(table_size);
+
+	runTasks(parallel_for, context, remapScatterChunk, &data, partitions);
+
+	meshopt_Buffer<unsigned int> table(table_size);
+	data.table = table.data;
+
+	runTasks(parallel_for, context, partition_task, &data, partitions);
+
+	if (!indices)
+	{
+		// for unindexed input, each class first appears at its canonical vertex, so ids are ranks of canonical vertices
+		runTasks(parallel_for, context, remapCountChunk, &data, partitions);
+
+		unsigned int next_vertex = 0;
+
+		for (size_t c = 0; c < partitions; ++c)
+		{
+			unsigned int count = histogram[c];
+			histogram[c] = next_vertex;
+			next_vertex += count;
+		}
+
+		runTasks(parallel_for, context, remapAssignCanonicalChunk, &data, partitions);
+		runTasks(parallel_for, context, remapAssignChunk, &data, partitions);
+
+		return next_vertex;
+	}
+
+	// for indexed input, ids are assigned in order of first use of each class; hashes are reused to store the id of each canonical vertex
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+	memset(hashes.data, -1, vertex_count * sizeof(unsigned int));
+
+	unsigned int next_vertex = 0;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		assert(index < vertex_count);
+
+		if (destination[index] == ~0u)
+		{
+			unsigned int& id = hashes[canonical[index]];
+
+			if (id == ~0u)
+				id = next_vertex++;
+
+			destination[index] = id;
+		}
+	}
+
+	assert(next_vertex <= vertex_count);
+
+	return next_vertex;
+}
+
 void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, const unsigned int* remap)
 {
 	assert(vertex_size > 0 && vertex_size <= 256);
@@ -157,6 +552,23 @@ void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t v
 	}
 }
 
+void meshopt_remapVertexBufferStrided(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride, const unsigned int* remap)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size <= vertex_stride);
+	assert(destination != vertices);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		if (remap[i] != ~0u)
+		{
+			assert(remap[i] < vertex_count);
+
+			memcpy(static_cast<char*>(destination) + remap[i] * vertex_size, static_cast<const char*>(vertices) + i * vertex_stride, vertex_size);
+		}
+	}
+}
+
 void meshopt_remapIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* remap)
 {
 	assert(index_count % 3 == 0);
@@ -169,3 +581,63 @@ void meshopt_remapIndexBuffer(unsigned int* destination, const unsigned int* ind
 		destination[i] = remap[index];
 	}
 }
+
+size_t meshopt_generateShadowIndexBuffer(unsigned int* destination, float* destination_positions, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	// vertices are equivalent when their positions are binary equivalent, regardless of the other attributes
+	meshopt_Stream stream = {vertex_positions, sizeof(float) * 3, vertex_positions_stride};
+	VertexStreamHasher hasher = {&stream, 1};
+
+	meshopt_Buffer<unsigned int> remap(vertex_count);
+	size_t unique_positions = generateVertexRemap(remap.data, indices, index_count, vertex_count, hasher);
+
+	// remapping is element-wise and vertex cache optimization supports in-place operation, so destination may alias indices
+	meshopt_remapIndexBuffer(destination, indices, index_count, remap.data);
+	meshopt_optimizeVertexCache(destination, destination, index_count, unique_positions);
+
+	if (destination_positions)
+	{
+		// renumber positions in first-use order of the optimized index buffer and compose both remap tables, so that positions are gathered once
+		meshopt_Buffer<unsigned int> fetch_remap(unique_positions);
+		meshopt_optimizeVertexFetchRemap(fetch_remap.data, destination, index_count, unique_positions);
+		meshopt_remapIndexBuffer(destination, destination, index_count, fetch_remap.data);
+
+		size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+		// duplicate vertices write the same bytes to the same place
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			if (remap[i] != ~0u)
+			{
+				const float* v = vertex_positions + i * vertex_stride_float;
+				float* r = destination_positions + fetch_remap[remap[i]] * 3;
+
+				r[0] = v[0];
+				r[1] = v[1];
+				r[2] = v[2];
+			}
+		}
+	}
+	else
+	{
+		// without a compacted stream, each position is referenced through the first vertex that has it so that the original vertex buffer can be used
+		meshopt_Buffer<unsigned int> canonical(unique_positions);
+		memset(canonical.data, -1, unique_positions * sizeof(unsigned int));
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			if (remap[i] != ~0u && canonical[remap[i]] == ~0u)
+				canonical[remap[i]] = unsigned(i);
+
+		for (size_t i = 0; i < index_count; ++i)
+			destination[i] = canonical[destination[i]];
+	}
+
+	return unique_positions;
+}
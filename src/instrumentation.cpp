@@ -0,0 +1,8 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+void meshopt_setInstrumentation(meshopt_InstrumentationCallback callback, void* context)
+{
+	meshopt_Instrumentation<void>::callback = callback;
+	meshopt_Instrumentation<void>::context = context;
+}
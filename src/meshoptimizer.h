@@ -24,6 +24,13 @@
 extern "C" {
 #endif
 
+/**
+ * Parallel task interface used by meshopt_generateVertexRemapParallel, meshopt_optimizeVertexCacheParallel, meshopt_decodeVertexBufferParallel, meshopt_simplifyParallel, meshopt_stripifyParallel, meshopt_analyzeOverdrawParallel and the batch functions
+ * parallel_for must call task(task_data, i) for every i in [0..count) - possibly concurrently from multiple threads - and return after all calls complete
+ */
+typedef void (*meshopt_ParallelTask)(void* task_data, size_t index);
+typedef void (*meshopt_ParallelFor)(void* context, meshopt_ParallelTask task, void* task_data, size_t count);
+
 /**
  * Generates a vertex remap table from the vertex buffer and an optional index buffer and returns number of unique vertices
  * As a result, all vertices that are binary equivalent map to the same (new) location, with no gaps in the resulting sequence.
@@ -33,6 +40,37 @@ extern "C" {
  */
 MESHOPTIMIZER_API size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size);
 
+/**
+ * Parallel vertex remap generator
+ * Generates the same remap table as meshopt_generateVertexRemap, but hashes and deduplicates vertices in partition_count tasks using parallel_for
+ * partition_count is rounded down to a power of two and reduced for small meshes; parallel_for can be NULL, in which case the tasks run serially
+ * Final id assignment is serial for indexed input; for unindexed input (indices is NULL) all work is done in parallel
+ */
+MESHOPTIMIZER_API size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t partition_count, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Vertex attribute stream for meshopt_generateVertexRemapMulti and meshopt_remapVertexBufferStrided
+ * Vertex i of the stream occupies size bytes starting at data + i * stride; stride must be at least size
+ */
+struct meshopt_Stream
+{
+	const void* data;
+	size_t size;
+	size_t stride;
+};
+
+/**
+ * Multi-stream vertex remap generator
+ * Generates a vertex remap table similarly to meshopt_generateVertexRemap for vertices that are split across multiple streams; two vertices are equivalent when they are binary equivalent in all streams
+ * This produces the same table as meshopt_generateVertexRemap would for a buffer with all streams interleaved, without creating an interleaved copy
+ * Each stream can then be remapped with meshopt_remapVertexBuffer (or meshopt_remapVertexBufferStrided if the source stream is not tightly packed)
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * indices can be NULL if the input is unindexed
+ * stream_count must be in [1..16]
+ */
+MESHOPTIMIZER_API size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count);
+
 /**
  * Generates vertex buffer from the source vertex buffer and remap table generated by generateVertexRemap
  *
@@ -41,6 +79,14 @@ MESHOPTIMIZER_API size_t meshopt_generateVertexRemap(unsigned int* destination,
  */
 MESHOPTIMIZER_API void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, const unsigned int* remap);
 
+/**
+ * Strided vertex buffer remapper
+ * Generates a tightly packed vertex buffer similarly to meshopt_remapVertexBuffer, reading source vertices vertex_stride bytes apart
+ * This can be used to extract and remap one stream from an interleaved vertex buffer; vertex_stride must be at least vertex_size
+ * Note that unlike meshopt_remapVertexBuffer, in-place remapping is not supported
+ */
+MESHOPTIMIZER_API void meshopt_remapVertexBufferStrided(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride, const unsigned int* remap);
+
 /**
  * Generate index buffer from the source index buffer and remap table generated by generateVertexRemap
  *
@@ -49,6 +95,19 @@ MESHOPTIMIZER_API void meshopt_remapVertexBuffer(void* destination, const void*
  */
 MESHOPTIMIZER_API void meshopt_remapIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* remap);
 
+/**
+ * Shadow index buffer generator
+ * Generates an index buffer for passes that only need positions, such as shadow and depth prepass rendering, where vertices that share a position are merged even if other attributes differ (e.g. at UV or normal seams)
+ * Vertices are merged when their positions are binary equivalent; the resulting index buffer is optimized with meshopt_optimizeVertexCache
+ * Returns the number of unique positions
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements); it can be the same as indices
+ * destination_positions must contain enough space for the compacted position stream (unique position count * 3 floats, at most vertex_count * 3); in this case destination indexes this stream and is also optimized with meshopt_optimizeVertexFetch
+ * destination_positions can be NULL, in which case destination indexes the original vertices, using the referenced vertex with the lowest index for each position
+ * indices can be NULL if the input is unindexed
+ */
+MESHOPTIMIZER_API size_t meshopt_generateShadowIndexBuffer(unsigned int* destination, float* destination_positions, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+
 /**
  * Vertex transform cache optimizer
  * Reorders indices to reduce the number of GPU vertex shader invocations
@@ -57,6 +116,17 @@ MESHOPTIMIZER_API void meshopt_remapIndexBuffer(unsigned int* destination, const
  */
 MESHOPTIMIZER_API void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count);
 
+/**
+ * Parallel vertex transform cache optimizer
+ * Reorders indices similarly to meshopt_optimizeVertexCache, but splits the mesh into up to partition_count partitions with the same number of triangles that are optimized concurrently using parallel_for and concatenated
+ * Partitions are contiguous in input order, or are rebuilt from mesh connectivity with an extra serial pass if the input order has poor locality
+ * The cache state is not carried across partitions, so the results can be slightly worse than those of meshopt_optimizeVertexCache
+ * Partitions have at least 16384 triangles, so small meshes are optimized on the calling thread; parallel_for can be NULL, in which case the partitions are optimized serially
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_API void meshopt_optimizeVertexCacheParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Vertex transform cache optimizer for FIFO caches
  * Reorders indices to reduce the number of GPU vertex shader invocations
@@ -67,6 +137,16 @@ MESHOPTIMIZER_API void meshopt_optimizeVertexCache(unsigned int* destination, co
  */
 MESHOPTIMIZER_API void meshopt_optimizeVertexCacheFifo(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size);
 
+/**
+ * Vertex transform cache optimizer for a specific GPU model
+ * Reorders indices to minimize the number of vertex shader invocations estimated by meshopt_analyzeVertexCache with the same cache_size, warp_size and primgroup_size
+ * Runs several optimizers, including a variant of meshopt_optimizeVertexCache that accounts for cache flushes between warps, and keeps the best result; takes ~3x longer than meshopt_optimizeVertexCache
+ * Results are never worse than those of meshopt_optimizeVertexCache according to the model; example profiles are 32, 32, 32 (NVidia), 14, 64, 128 (AMD) and 128, 0, 0 (Intel)
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ */
+MESHOPTIMIZER_API void meshopt_optimizeVertexCacheProfile(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size, unsigned int warp_size, unsigned int primgroup_size);
+
 /**
  * Overdraw optimizer
  * Reorders indices to reduce the number of GPU vertex shader invocations and the pixel overdraw
@@ -78,6 +158,23 @@ MESHOPTIMIZER_API void meshopt_optimizeVertexCacheFifo(unsigned int* destination
  */
 MESHOPTIMIZER_API void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold);
 
+/**
+ * View-dependent overdraw optimizer
+ * Generates 8 index buffers, one per octant of view directions, that sort triangle clusters front to back for views from that octant
+ * All buffers use the same clusters as meshopt_optimizeOverdraw with the same threshold, so vertex cache efficiency is identical; only cluster order differs
+ *
+ * destination must contain enough space for 8 index buffers (index_count * 8 elements); the buffer for octant i starts at destination + index_count * i
+ * indices must contain index data that is the result of optimizeVertexCache (*not* the original mesh indices!)
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
+ */
+MESHOPTIMIZER_API void meshopt_optimizeOverdrawOctants(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold);
+
+/**
+ * Returns the octant [0..8) of the index buffer generated by meshopt_optimizeOverdrawOctants that should be used for rendering
+ * view is the camera forward direction in mesh space; for perspective cameras use the direction from the camera position to the mesh center
+ */
+MESHOPTIMIZER_API unsigned int meshopt_getOverdrawOctant(float view_x, float view_y, float view_z);
+
 /**
  * Vertex fetch cache optimizer
  * Generates vertex remap to reduce the amount of GPU memory fetches during vertex processing
@@ -96,6 +193,94 @@ MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetchRemap(unsigned int* destinat
  */
 MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetch(void* destination, unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size);
 
+/**
+ * Render pass descriptor for meshopt_optimizeVertexFetchPassesRemap and meshopt_analyzeVertexFetchPasses
+ * Each pass draws index_count indices and fetches the vertex streams whose bits are set in stream_mask (bit k selects stream k)
+ * Passes may use different index buffers over the same vertices, for example a depth prepass that only fetches positions
+ */
+struct meshopt_VertexFetchPass
+{
+	const unsigned int* indices;
+	size_t index_count;
+	unsigned int stream_mask;
+};
+
+/**
+ * Multi-pass vertex fetch cache optimizer
+ * Generates vertex remap that minimizes the total number of bytes fetched across all passes, with vertex data split into separate streams of different strides
+ * Evaluates first-use orders that start with each pass or interleave all passes, with small windows optionally sorted by last use so that vertices which are not reused later share cache lines, and picks the cheapest order according to meshopt_analyzeVertexFetchPasses
+ * In total over all passes, the result is never worse than meshopt_optimizeVertexFetchRemap on the index buffers of all passes concatenated in order according to this model; the order is picked by the total, so individual passes may fetch more; each candidate is analyzed separately, so this is ~10x slower than meshopt_optimizeVertexFetchRemap per pass
+ * The resulting remap table should be applied to each index buffer and each vertex stream
+ * Returns the number of vertices referenced by any pass; vertices that are not referenced are remapped to ~0u
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * stream_strides contains stream_count strides in bytes; stream_count must be in [1..32] range
+ * cache_line_size is the size of the memory transaction in bytes and must be in [1..4096] range; typical values are 32, 64 or 128
+ */
+MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetchPassesRemap(unsigned int* destination, const struct meshopt_VertexFetchPass* passes, size_t pass_count, size_t vertex_count, const size_t* stream_strides, size_t stream_count, size_t cache_line_size);
+
+/**
+ * Mesh optimization options for meshopt_optimizeMesh
+ * meshopt_OptimizeMeshDeduplicate merges binary equivalent vertices before optimization, similarly to meshopt_generateVertexRemap
+ */
+enum
+{
+	meshopt_OptimizeMeshDeduplicate = 1 << 0
+};
+
+/**
+ * Stage callback used by meshopt_optimizeMesh
+ * Called after each stage completes with the stage name: "deduplicate", "vertexcache", "overdraw" or "vertexfetch"
+ * The callback can record a timestamp to measure the time spent in each stage
+ */
+typedef void (*meshopt_StageCallback)(void* context, const char* stage);
+
+/**
+ * Mesh optimization pipeline
+ * Runs vertex cache, overdraw and vertex fetch optimization in sequence, optionally preceded by vertex deduplication
+ * Results match calling meshopt_optimizeVertexCache, meshopt_optimizeOverdraw and meshopt_optimizeVertexFetch in order, preceded by meshopt_generateVertexRemap and remapping when deduplicating
+ * Stages share one scratch index buffer so that vertex cache and overdraw optimization don't need to copy their input; the other work matches the separate calls
+ * Returns the number of unique vertices written to destination_vertices
+ *
+ * destination_indices must contain enough space for index_count elements; destination_vertices must contain enough space for vertex_count vertices
+ * in-place optimization is supported: destination_indices can be equal to indices, and destination_vertices can be equal to vertices
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex and is indexed by the source vertex ids; it can point into vertices
+ * threshold indicates how much the overdraw optimizer can degrade vertex cache efficiency, see meshopt_optimizeOverdraw
+ * options is a bitmask of meshopt_OptimizeMesh* flags; callback can be NULL
+ */
+MESHOPTIMIZER_API size_t meshopt_optimizeMesh(unsigned int* destination_indices, void* destination_vertices, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride, float threshold, unsigned int options, meshopt_StageCallback callback, void* context);
+
+/**
+ * Mesh descriptor for meshopt_optimizeMeshBatch
+ * Fields match the arguments of meshopt_optimizeMesh; result receives the number of unique vertices written to destination_vertices
+ */
+struct meshopt_BatchMesh
+{
+	unsigned int* destination_indices;
+	void* destination_vertices;
+
+	const unsigned int* indices;
+	size_t index_count;
+
+	const void* vertices;
+	size_t vertex_count;
+
+	const float* vertex_positions;
+
+	size_t result;
+};
+
+/**
+ * Batched mesh optimization pipeline
+ * Optimizes each mesh like meshopt_optimizeMesh, with the same results; intended for large numbers of small meshes
+ * Meshes are split into up to partition_count contiguous groups with a similar number of indices and vertices that are processed concurrently using parallel_for; each group allocates scratch memory once and reuses it for all of its meshes
+ * Within a group, overdraw optimization sorts the clusters of consecutive meshes together, which removes a fixed per-mesh cost: meshes with 16-32 triangles take 20-30% less time than with separate meshopt_optimizeMesh calls, and meshes with 128 triangles ~5% less
+ * Using more partitions than threads lets a work-stealing parallel_for balance the load dynamically; parallel_for can be NULL, in which case the groups are processed serially
+ *
+ * all meshes share vertex_size, vertex_positions_stride, threshold and options; see meshopt_optimizeMesh for the requirements on each mesh
+ */
+MESHOPTIMIZER_API void meshopt_optimizeMeshBatch(struct meshopt_BatchMesh* meshes, size_t mesh_count, size_t vertex_size, size_t vertex_positions_stride, float threshold, unsigned int options, size_t partition_count, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Index buffer encoder
  * Encodes index data into an array of bytes that is generally much smaller (<1.5 bytes/triangle) and compresses better (<1 bytes/triangle) compared to original.
@@ -107,6 +292,16 @@ MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetch(void* destination, unsigned
 MESHOPTIMIZER_API size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count);
 MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count);
 
+/**
+ * Index buffer encoder with adaptive codeaux table
+ * Encodes index data similarly to meshopt_encodeIndexBuffer, but uses two passes to build the codeaux table that is optimal for this index buffer.
+ * This produces smaller output at the cost of ~2x encoding time; the result can be decoded with meshopt_decodeIndexBuffer.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ *
+ * buffer must contain enough space for the encoded index buffer (use meshopt_encodeIndexBufferBound to estimate)
+ */
+MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferAdaptive(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count);
+
 /**
  * Index buffer decoder
  * Decodes index data from an array of bytes generated by meshopt_encodeIndexBuffer
@@ -116,6 +311,37 @@ MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferBound(size_t index_count, size
  */
 MESHOPTIMIZER_API int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Resumable index buffer decoder state; see meshopt_decodeIndexStream
+ * The contents are internal to the decoder and should not be modified
+ */
+struct meshopt_IndexDecoderState
+{
+	size_t index_count;
+	size_t index_offset; /* number of indices decoded so far */
+	size_t data_offset;
+	unsigned int next;
+	unsigned int last;
+	unsigned int lasta;
+	unsigned int lastc;
+	unsigned int edgefifo[16][2];
+	unsigned int vertexfifo[16];
+	size_t edgefifooffset;
+	size_t vertexfifooffset;
+};
+
+/**
+ * Resumable index buffer decoder
+ * Decodes index data generated by meshopt_encodeIndexBuffer in chunks of triangles, which allows decoding directly into a (ring) buffer that is smaller than the index buffer
+ * Call meshopt_decodeIndexStreamBegin once with the total index count, and meshopt_decodeIndexStream for each chunk with the number of indices in the chunk (must be divisible by 3)
+ * Returns 0 if decoding was successful, and an error code otherwise; the state can't be used after an error
+ *
+ * buffer must contain the entire encoded index buffer since the codeaux table is stored at the end of the stream
+ * destination must contain enough space for the indices of the chunk (index_count elements)
+ */
+MESHOPTIMIZER_API void meshopt_decodeIndexStreamBegin(struct meshopt_IndexDecoderState* state, size_t index_count);
+MESHOPTIMIZER_API int meshopt_decodeIndexStream(struct meshopt_IndexDecoderState* state, void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
+
 /**
  * Vertex buffer encoder
  * Encodes vertex data into an array of bytes that is generally smaller and compresses better compared to original.
@@ -126,6 +352,18 @@ MESHOPTIMIZER_API int meshopt_decodeIndexBuffer(void* destination, size_t index_
 MESHOPTIMIZER_API size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size);
 MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size);
 
+/**
+ * Vertex buffer encoder with compression level
+ * Encodes vertex data similarly to meshopt_encodeVertexBuffer; level 0 produces identical output, higher levels pick a predictor for each 4-byte group of every block and are slower to encode
+ * Level 1 chooses between byte deltas and 16-bit deltas, which helps 16-bit quantized attributes; level 2 also tries 32-bit xor and 32-bit deltas, which helps floating point attributes
+ * The resulting data can be decoded with meshopt_decodeVertexBuffer and the other non-streaming decoders; other predictors decode a little slower than byte deltas, so blocks only use them if that makes the block at least ~3% smaller
+ * Levels help when 16-bit quantized or floating point attributes change smoothly between adjacent vertices and the encoded data is stored as is; the gains mostly disappear after general purpose compression (deflate etc.), and encoding is 5-15x slower
+ * Returns encoded data size on success, 0 on error
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferBound to estimate)
+ */
+MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferLevel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level);
+
 /**
  * Vertex buffer decoder
  * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBuffer
@@ -135,6 +373,255 @@ MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, si
  */
 MESHOPTIMIZER_API int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Strided vertex buffer decoder
+ * Decodes vertex data similarly to meshopt_decodeVertexBuffer, but writes each vertex destination_stride bytes apart, leaving the bytes in between untouched
+ * This can be used to decode vertex data directly into an interleaved vertex buffer (e.g. mapped GPU memory): each vertex stream is decoded with a separate call, with destination pointing to the stream offset in the first vertex
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must contain enough space for the resulting vertex buffer ((vertex_count - 1) * destination_stride + vertex_size bytes); destination_stride must be at least vertex_size
+ */
+MESHOPTIMIZER_API int meshopt_decodeVertexBufferStrided(void* destination, size_t vertex_count, size_t vertex_size, size_t destination_stride, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Segmented vertex buffer encoder
+ * Encodes vertex data similarly to meshopt_encodeVertexBuffer, but splits the stream into segments of a few thousand vertices that can be decoded independently.
+ * The resulting data is slightly larger and can be decoded in parallel using meshopt_decodeVertexBufferParallel; meshopt_decodeVertexBuffer can decode it as well.
+ * Returns encoded data size on success, 0 on error; the error conditions are if buffer doesn't have enough space or if the encoded size of a segment doesn't fit in 32 bits
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferSegmentedBound to estimate)
+ */
+MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferSegmented(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferSegmentedBound(size_t vertex_count, size_t vertex_size);
+
+/**
+ * Parallel vertex buffer decoder
+ * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBuffer or meshopt_encodeVertexBufferSegmented
+ * Segments of data generated by meshopt_encodeVertexBufferSegmented are decoded using parallel_for; other data is decoded on the calling thread
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must contain enough space for the resulting vertex buffer (vertex_count * vertex_size bytes)
+ * parallel_for can be NULL, in which case all segments are decoded on the calling thread; context is passed to parallel_for as is
+ */
+MESHOPTIMIZER_API int meshopt_decodeVertexBufferParallel(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Buffer descriptor for meshopt_encodeIndexBufferBatch and meshopt_encodeVertexBufferBatch
+ * data and count are the indices and index_count, or the vertices and vertex_count, of the buffer to encode; result receives the encoded data size, or 0 on error
+ */
+struct meshopt_BatchBuffer
+{
+	unsigned char* buffer;
+	size_t buffer_size;
+
+	const void* data;
+	size_t count;
+
+	size_t result;
+};
+
+/**
+ * Batched index and vertex buffer encoders
+ * Encode each buffer with meshopt_encodeIndexBuffer or meshopt_encodeVertexBuffer; intended for large numbers of small buffers
+ * Buffers are split into up to partition_count contiguous groups of similar size that are encoded concurrently using parallel_for; parallel_for can be NULL, in which case all buffers are encoded on the calling thread
+ * Returns the total encoded data size on success, 0 if any of the buffers didn't have enough space
+ *
+ * each buffer must contain enough space for its encoded data (use meshopt_encodeIndexBufferBound or meshopt_encodeVertexBufferBound to estimate); index data is unsigned int
+ */
+MESHOPTIMIZER_API size_t meshopt_encodeIndexBufferBatch(struct meshopt_BatchBuffer* buffers, size_t buffer_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context);
+MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBatch(struct meshopt_BatchBuffer* buffers, size_t buffer_count, size_t vertex_size, size_t partition_count, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Size in bytes of the vertex block scratch space embedded in meshopt_VertexEncoderState and meshopt_VertexDecoderState
+ * This is the block size of the vertex codec, so it is part of the library ABI: a library built with a different value is incompatible with code that allocates the state structures
+ */
+enum
+{
+	meshopt_VertexStreamBlockSize = 8192
+};
+
+/**
+ * Streaming vertex buffer encoder state; see meshopt_encodeVertexStream
+ * The contents are internal to the encoder and should not be modified
+ */
+struct meshopt_VertexEncoderState
+{
+	size_t vertex_size;
+	size_t vertex_count; /* number of vertices consumed so far */
+	size_t block_size; /* number of vertices buffered in block */
+	size_t segment_blocks;
+	size_t segment_bytes;
+	unsigned char first_vertex[256];
+	unsigned char last_vertex[256];
+	unsigned char block[meshopt_VertexStreamBlockSize];
+};
+
+/**
+ * Streaming vertex buffer encoder
+ * Encodes vertex data in the same format as meshopt_encodeVertexBufferSegmented, consuming vertices and producing bytes incrementally
+ * Call meshopt_encodeVertexStreamBegin once, meshopt_encodeVertexStream for each chunk of vertices (of any size) and meshopt_encodeVertexStreamEnd to flush the remaining data
+ * Returns 0 on success with buffer_written set to the number of bytes written to buffer, and an error code otherwise; the state can't be used after an error
+ * The error conditions are if buffer doesn't have enough space or if the encoded size of a segment doesn't fit in 32 bits
+ *
+ * buffer must contain enough space for the encoded chunk (use meshopt_encodeVertexStreamBound(vertex_count, vertex_size) for meshopt_encodeVertexStream and meshopt_encodeVertexStreamBound(0, vertex_size) for meshopt_encodeVertexStreamEnd)
+ */
+MESHOPTIMIZER_API void meshopt_encodeVertexStreamBegin(struct meshopt_VertexEncoderState* state, size_t vertex_size);
+MESHOPTIMIZER_API int meshopt_encodeVertexStream(struct meshopt_VertexEncoderState* state, unsigned char* buffer, size_t buffer_size, size_t* buffer_written, const void* vertices, size_t vertex_count);
+MESHOPTIMIZER_API int meshopt_encodeVertexStreamEnd(struct meshopt_VertexEncoderState* state, unsigned char* buffer, size_t buffer_size, size_t* buffer_written);
+MESHOPTIMIZER_API size_t meshopt_encodeVertexStreamBound(size_t vertex_count, size_t vertex_size);
+
+/**
+ * Streaming vertex buffer decoder state; see meshopt_decodeVertexStream
+ * The contents are internal to the decoder and should not be modified
+ */
+struct meshopt_VertexDecoderState
+{
+	size_t vertex_count;
+	size_t vertex_size;
+	size_t vertex_offset; /* number of vertices decoded so far */
+	size_t block_size; /* number of vertices decoded into block */
+	size_t block_offset; /* number of vertices from block written to destination */
+	size_t segment_blocks;
+	size_t segment_bytes;
+	int stage;
+	unsigned char first_vertex[256];
+	unsigned char last_vertex[256];
+	unsigned char block[meshopt_VertexStreamBlockSize];
+};
+
+/**
+ * Streaming vertex buffer decoder
+ * Decodes vertex data generated by meshopt_encodeVertexBufferSegmented or meshopt_encodeVertexStream, consuming bytes and producing vertices incrementally
+ * Call meshopt_decodeVertexStreamBegin once and meshopt_decodeVertexStream repeatedly with the data that is available and the space for the next vertices
+ * Each call consumes whole blocks from buffer; the bytes that weren't consumed need to be passed again in the next call, followed by the new data
+ * Returns 1 after the entire stream was decoded, 0 if more data or more destination space is required, and an error code otherwise
+ * buffer_consumed is set to the number of bytes consumed from buffer and destination_written is set to the number of vertices written to destination
+ *
+ * Note that a block of compressed data isn't consumed until it's fully available, so buffer_size should be at least meshopt_encodeVertexStreamBound(0, vertex_size) to guarantee progress
+ */
+MESHOPTIMIZER_API void meshopt_decodeVertexStreamBegin(struct meshopt_VertexDecoderState* state, size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_API int meshopt_decodeVertexStream(struct meshopt_VertexDecoderState* state, void* destination, size_t destination_count, size_t* destination_written, const unsigned char* buffer, size_t buffer_size, size_t* buffer_consumed);
+
+/**
+ * Returns the name of the vertex decoder implementation that was selected for the current CPU at startup
+ * The result is one of "scalar", "ssse3", "avx2", "avx512" or "neon"; all implementations produce identical results
+ */
+MESHOPTIMIZER_API const char* meshopt_getVertexDecoderKernel(void);
+
+/**
+ * Returns the name of the vertex encoder implementation; this is "sse2" or "neon" when the library is compiled with SIMD support, and "scalar" otherwise
+ * All implementations produce identical results
+ */
+MESHOPTIMIZER_API const char* meshopt_getVertexEncoderKernel(void);
+
+/**
+ * Vertex buffer filters
+ * Filters convert attribute data into a representation that is smaller and compresses better with meshopt_encodeVertexBuffer; the encode functions quantize floating point data, and the decode functions convert it back in place
+ * Decode filters can be applied separately after decoding, or fused with decoding using meshopt_decodeVertexBufferFiltered
+ *
+ * meshopt_FilterOct: unit vectors encoded with octahedral mapping as 4 8-bit (stride 4) or 4 16-bit (stride 8) snorm components; the 4th component is preserved
+ * Decoding produces unit vectors as 4 snorm components of the same width (e.g. x/127.f for 8-bit data)
+ *
+ * meshopt_FilterQuat: unit quaternions encoded as 4 16-bit components (stride 8) that store 3 smallest components and the index of the largest one
+ * Decoding produces unit quaternions as 4 16-bit snorm components (x/32767.f)
+ *
+ * meshopt_FilterExp: floats encoded as 32-bit values with a 24-bit mantissa and an 8-bit exponent that is shared by all components of each element (stride / 4 components)
+ * Decoding produces 32-bit floats
+ */
+enum
+{
+	meshopt_FilterNone = 0,
+	meshopt_FilterOct = 1,
+	meshopt_FilterQuat = 2,
+	meshopt_FilterExp = 3
+};
+
+/**
+ * Vertex buffer filter encoders
+ * Quantize count elements of float data with the given stride (in bytes, of the destination) into destination
+ *
+ * meshopt_encodeFilterOct: data has 4 floats per element (unit vector xyz and an arbitrary w in [-1..1]); stride must be 4 or 8, and bits must be in [2..8] for stride 4 and [2..16] for stride 8
+ * meshopt_encodeFilterQuat: data has 4 floats per element (unit quaternion); stride must be 8, and bits must be in [4..14]
+ * meshopt_encodeFilterExp: data has stride / 4 floats per element; stride must be a multiple of 4 in [4..256], and bits must be in [2..24]
+ */
+MESHOPTIMIZER_API void meshopt_encodeFilterOct(void* destination, size_t count, size_t stride, int bits, const float* data);
+MESHOPTIMIZER_API void meshopt_encodeFilterQuat(void* destination, size_t count, size_t stride, int bits, const float* data);
+MESHOPTIMIZER_API void meshopt_encodeFilterExp(void* destination, size_t count, size_t stride, int bits, const float* data);
+
+/**
+ * Vertex buffer filter decoders
+ * Decode count elements with the given stride in place; uses SSE2 if available
+ * The stride requirements match the encoders
+ */
+MESHOPTIMIZER_API void meshopt_decodeFilterOct(void* buffer, size_t count, size_t stride);
+MESHOPTIMIZER_API void meshopt_decodeFilterQuat(void* buffer, size_t count, size_t stride);
+MESHOPTIMIZER_API void meshopt_decodeFilterExp(void* buffer, size_t count, size_t stride);
+
+/**
+ * Vertex buffer decoder with a fused filter
+ * Decodes vertex data similarly to meshopt_decodeVertexBufferParallel and applies the decode filter to each block of vertices while it's still in cache
+ * Returns 0 if decoding was successful, and an error code otherwise; unknown filter values are reported as errors
+ *
+ * filter is one of meshopt_Filter* values; the stream must contain one filter element per vertex, so vertex_size is the filter stride
+ * parallel_for can be NULL, in which case all segments are decoded on the calling thread
+ */
+MESHOPTIMIZER_API int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, unsigned int filter, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Container chunk types; see meshopt_ContainerChunk
+ */
+enum
+{
+	meshopt_ChunkVertexBuffer = 1,
+	meshopt_ChunkIndexBuffer = 2
+};
+
+/**
+ * Container chunk descriptor
+ * Each chunk holds one vertex or index buffer encoded with meshopt_encodeVertexBuffer (or its segmented/streaming variants) or meshopt_encodeIndexBuffer (or meshopt_encodeIndexBufferAdaptive)
+ * version is the codec version of the encoded data and offset is the position of the encoded data from the start of the container; both are filled by meshopt_encodeContainer
+ * size is the vertex size for vertex chunks and 0 for index chunks; bounds_min/bounds_max can hold the bounding box of the chunk geometry and are stored as is
+ */
+struct meshopt_ContainerChunk
+{
+	unsigned int type;
+	unsigned int version;
+	unsigned int count;
+	unsigned int size;
+	unsigned int offset;
+	unsigned int length;
+
+	float bounds_min[3];
+	float bounds_max[3];
+};
+
+/**
+ * Container encoder
+ * Writes encoded vertex and index buffers into a single blob with a chunk table, so that it can be memory-mapped and individual chunks can be decoded on demand without touching the rest of the data
+ * The layout is a 16-byte header (magic "MOPC", format version, chunk count, total size), followed by a 48-byte little-endian table entry per chunk, followed by the encoded data of each chunk in order
+ * Returns container size on success, 0 on error; the error conditions are if buffer doesn't have enough space or if the container size doesn't fit in 32 bits
+ *
+ * buffer must contain enough space for the container (use meshopt_encodeContainerBound to compute)
+ * chunks must have type, count, size, length and bounds filled; chunk_data[i] must point to chunks[i].length bytes of encoded data
+ */
+MESHOPTIMIZER_API size_t meshopt_encodeContainer(unsigned char* buffer, size_t buffer_size, struct meshopt_ContainerChunk* chunks, const unsigned char* const* chunk_data, size_t chunk_count);
+MESHOPTIMIZER_API size_t meshopt_encodeContainerBound(const struct meshopt_ContainerChunk* chunks, size_t chunk_count);
+
+/**
+ * Container reader
+ * meshopt_getContainerChunkCount returns the number of chunks, or 0 if buffer doesn't contain a valid container header
+ * meshopt_getContainerChunk reads the table entry of chunk index; it only accesses the header and the entry, and returns 0 on success and an error code otherwise
+ * meshopt_decodeContainerChunk decodes chunk index using meshopt_decodeVertexBuffer or meshopt_decodeIndexBuffer; it only accesses the header, the entry and the chunk data, and returns 0 on success and an error code otherwise
+ * Error codes: -1 if buffer doesn't contain a valid container header, -2 if index is out of range, -3 if the chunk type is unknown, -4 if the chunk data is outside of buffer;
+ * meshopt_decodeContainerChunk additionally returns -5 if the vertex size or index count of the chunk is invalid, and -6 if the chunk data fails to decode
+ *
+ * buffer_size should be the size of the entire container (e.g. the size of the mapped file) so that chunk data can be validated
+ * destination must contain enough space for count * size bytes for vertex chunks, count * index_size bytes for index chunks; index_size is ignored for vertex chunks
+ */
+MESHOPTIMIZER_API size_t meshopt_getContainerChunkCount(const unsigned char* buffer, size_t buffer_size);
+MESHOPTIMIZER_API int meshopt_getContainerChunk(struct meshopt_ContainerChunk* chunk, const unsigned char* buffer, size_t buffer_size, size_t index);
+MESHOPTIMIZER_API int meshopt_decodeContainerChunk(void* destination, size_t index_size, const unsigned char* buffer, size_t buffer_size, size_t index);
+
 /**
  * Experimental: Mesh simplifier
  * Reduces the number of triangles in the mesh, attempting to preserve mesh appearance as much as possible
@@ -145,6 +632,53 @@ MESHOPTIMIZER_API int meshopt_decodeVertexBuffer(void* destination, size_t verte
  */
 MESHOPTIMIZER_API size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error);
 
+/**
+ * Simplification options for meshopt_simplifyWithAttributes
+ * meshopt_SimplifyPriorityQueue collapses edges one at a time in the order of increasing error using a priority queue, re-evaluating only the edges around each collapse;
+ * compared to the default scheme, which collapses batches of non-adjacent edges in multiple passes, this usually reaches fewer triangles for the same error but is slower:
+ * reducing meshes to 25% of their triangles takes 1.5-2.5x as long for a 5K triangle model and 3-4x as long for 180K triangle grids, with flat regions at the high end
+ */
+enum
+{
+	meshopt_SimplifyPriorityQueue = 1 << 0
+};
+
+/**
+ * Experimental: Mesh simplifier with attribute metric
+ * Reduces the number of triangles in the mesh similarly to meshopt_simplify, but also takes vertex attributes (normals, texture coordinates, etc.) into account when deciding which edges to collapse
+ * Returns the number of indices after simplification, with destination containing new index data
+ *
+ * vertex_attributes should have attribute_count floats in the first attribute_count * 4 bytes of each vertex; attribute_count must be <= 16
+ * attribute_weights has attribute_count elements; each attribute is multiplied by its weight, and the squared difference of weighted attributes is added to the (squared) position error
+ * since positions are rescaled to unit range internally, weights of ~0.1-1 for unit normals and ~0.1-1 for texture coordinates normalized to [0..1] work well as a starting point
+ * attribute_count can be 0, in which case the result matches meshopt_simplify (for the same options); options is a bitmask of meshopt_Simplify* flags
+ */
+MESHOPTIMIZER_API size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t target_index_count, float target_error, unsigned int options);
+
+/**
+ * Experimental: Mesh simplifier for LOD chains
+ * Produces lod_count levels of detail in one call, sharing the setup work (adjacency, vertex classification, quadrics) between levels; each level continues simplification from the previous one
+ * Returns the total number of indices in all levels, with destination containing the index data of all levels one after another
+ * This is similar to calling meshopt_simplifyWithAttributes for each level using the previous level as the source, but quadrics keep accumulating across levels so the results are not identical.
+ *
+ * destination must contain enough space for the worst case result (index_count * lod_count elements)
+ * lod_index_counts and lod_errors receive lod_count elements with the index count and the resulting error of each level; the error is in the same units as target_error and never decreases from level to level
+ * target_index_counts and target_errors have lod_count elements and should be non-increasing and non-decreasing respectively; either can be NULL to only limit levels by the other one
+ */
+MESHOPTIMIZER_API size_t meshopt_simplifyLodChain(unsigned int* destination, size_t* lod_index_counts, float* lod_errors, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options);
+
+/**
+ * Experimental: Parallel mesh simplifier
+ * Reduces the number of triangles in the mesh similarly to meshopt_simplifyWithAttributes (without attributes), but splits the mesh into up to partition_count spatially coherent partitions that are simplified concurrently
+ * Vertices on the cuts between partitions are locked while partitions are simplified; a final pass over the combined result then simplifies across the cuts on the calling thread
+ * Returns the number of indices after simplification, with destination containing new index data
+ * Results are close but not identical to meshopt_simplifyWithAttributes; partitions have at least 4096 triangles, so small meshes are simplified on the calling thread
+ *
+ * destination must contain enough space for the source index buffer (since optimization is iterative, this means index_count elements - *not* target_index_count!)
+ * parallel_for can be NULL, in which case all partitions are simplified on the calling thread; context is passed to parallel_for as is
+ */
+MESHOPTIMIZER_API size_t meshopt_simplifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, unsigned int options, size_t partition_count, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Mesh stripifier
  * Converts a previously vertex cache optimized triangle list to triangle strip, stitching strips using restart index
@@ -155,6 +689,33 @@ MESHOPTIMIZER_API size_t meshopt_simplify(unsigned int* destination, const unsig
  */
 MESHOPTIMIZER_API size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count);
 
+/**
+ * Cache-aware mesh stripifier
+ * Converts a previously vertex cache optimized triangle list to triangle strip, trading off strip length against vertex cache efficiency
+ * Several strips are built with different search windows and the shortest one is returned whose ACMR, as measured by meshopt_analyzeVertexCache on the unstripified triangles, is within threshold of the source ACMR
+ * Strips that keep the source triangle order are among the candidates, so the result is never less cache efficient than the source when threshold is at least 1
+ * This builds and evaluates 7 strips, so it is 10-20 times slower than meshopt_stripify
+ * Returns the number of indices in the resulting strip, with destination containing new index data
+ *
+ * destination must contain enough space for the worst case target index buffer (index_count / 3 * 4 elements with restart index, index_count / 3 * 5 elements with degenerate triangles)
+ * restart_index is written between strips to use primitive restart (~0u, or 0xffff for 16-bit index buffers), or should be 0 to stitch strips with degenerate triangles instead
+ * cache_size is the FIFO cache size used for evaluation, similar to meshopt_analyzeVertexCache; 16 is a good default for small-cache mobile GPUs
+ * threshold indicates how much ACMR is allowed to degrade relative to the source; for example, 1.05 allows 5% more vertex shader invocations than the source
+ */
+MESHOPTIMIZER_API size_t meshopt_stripifyCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int restart_index, unsigned int cache_size, float threshold);
+
+/**
+ * Parallel mesh stripifier
+ * Converts a triangle list to triangle strip similarly to meshopt_stripify, but splits the mesh into up to partition_count partitions with the same number of triangles that are stripified concurrently using parallel_for and concatenated
+ * Partitions are contiguous in input order, so strips can't cross partition boundaries and the result can be a few indices longer than that of meshopt_stripify
+ * Partitions have at least 16384 triangles, so small meshes are stripified on the calling thread; parallel_for can be NULL, in which case the partitions are stripified serially
+ * Building the partitions adds about 40% to the total work compared to meshopt_stripify, so this only reduces the wall clock time when parallel_for runs partitions on several threads
+ * Returns the number of indices in the resulting strip, with destination containing new index data
+ *
+ * destination must contain enough space for the worst case target index buffer (index_count / 3 * 4 elements)
+ */
+MESHOPTIMIZER_API size_t meshopt_stripifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Mesh unstripifier
  * Converts a triangle strip to a triangle list
@@ -164,6 +725,80 @@ MESHOPTIMIZER_API size_t meshopt_stripify(unsigned int* destination, const unsig
  */
 MESHOPTIMIZER_API size_t meshopt_unstripify(unsigned int* destination, const unsigned int* indices, size_t index_count);
 
+/**
+ * Meshlet is a small mesh cluster (subset) that consists of:
+ * - triangles, an 8-bit micro triangle (index) buffer, that for each triangle specifies three local vertices to use;
+ * - vertices, a 32-bit vertex index buffer, that for each local vertex specifies which mesh vertex to fetch vertex attributes from.
+ *
+ * For efficiency, meshlet triangles and vertices are packed into two large arrays; this structure contains offsets and counts to access the data.
+ */
+struct meshopt_Meshlet
+{
+	/* offsets within meshlet_vertices and meshlet_triangles arrays with meshlet data */
+	unsigned int vertex_offset;
+	unsigned int triangle_offset;
+
+	/* number of vertices and triangles used in the meshlet; data is stored in consecutive range defined by offset and count */
+	unsigned int vertex_count;
+	unsigned int triangle_count;
+};
+
+/**
+ * Meshlet builder
+ * Splits the mesh into a set of meshlets where each meshlet has at most max_vertices vertices and max_triangles triangles
+ * Triangles are packed in the order they appear in the index buffer, so for maximum efficiency the index buffer has to be optimized for vertex cache first.
+ * Returns the number of meshlets, with meshlets, meshlet_vertices and meshlet_triangles containing meshlet data
+ *
+ * meshlets must contain enough space for all meshlets, worst case size can be computed with meshopt_buildMeshletsBound
+ * meshlet_vertices must contain enough space for all meshlets, worst case size is equal to max_meshlets * max_vertices
+ * meshlet_triangles must contain enough space for all meshlets, worst case size is equal to max_meshlets * max_triangles * 3
+ * max_vertices should be in [3..255], and max_triangles should be in [4..512] and a multiple of 4; each meshlet's triangle data starts at a 4-byte aligned offset, and padding bytes are set to 0
+ */
+MESHOPTIMIZER_API size_t meshopt_buildMeshlets(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles);
+MESHOPTIMIZER_API size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles);
+
+struct meshopt_Bounds
+{
+	/* bounding sphere, useful for frustum and occlusion culling */
+	float center[3];
+	float radius;
+
+	/* normal cone, useful for backface culling */
+	float cone_apex[3];
+	float cone_axis[3];
+	float cone_cutoff; /* = cos(angle/2) */
+
+	/* normal cone axis and cutoff, stored in 8-bit SNORM format; decode using x/127.0 */
+	signed char cone_axis_s8[3];
+	signed char cone_cutoff_s8;
+};
+
+/**
+ * Cluster bounds generator
+ * Creates bounding volumes that can be used for frustum, backface and occlusion culling.
+ *
+ * For backface culling with orthographic projection, use the following formula to reject backfacing clusters:
+ *   dot(view, cone_axis) >= cone_cutoff
+ *
+ * For perspective projection, use the following formula that needs cone apex in addition to axis & cutoff:
+ *   dot(normalize(cone_apex - camera_position), cone_axis) >= cone_cutoff
+ *
+ * Alternatively, you can use the formula that doesn't need cone apex and uses bounding sphere instead:
+ *   dot(normalize(center - camera_position), cone_axis) >= cone_cutoff + radius / length(center - camera_position)
+ * or an equivalent formula that doesn't have a singularity at center = camera_position:
+ *   dot(center - camera_position, cone_axis) >= cone_cutoff * length(center - camera_position) + radius
+ *
+ * The formula that uses the apex is slightly more accurate but needs the apex; if you are already using bounding sphere
+ * to do frustum/occlusion culling, the formula that doesn't use the apex may be preferable.
+ * If the normal cone is wider than ~168 degrees, cone_cutoff is set to 1 so that the cluster is never rejected; clusters without non-degenerate triangles get zero bounds and are always rejected.
+ *
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex - similar to glVertexPointer
+ * index_count should be less than or equal to 512*3 (the function assumes clusters of limited size, same as meshopt_buildMeshlets)
+ * meshopt_computeMeshletBounds takes meshlet data as produced by meshopt_buildMeshlets: meshlet_vertices and meshlet_triangles should point at the meshlet's vertex_offset and triangle_offset
+ */
+MESHOPTIMIZER_API struct meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+MESHOPTIMIZER_API struct meshopt_Bounds meshopt_computeMeshletBounds(const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, size_t triangle_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+
 struct meshopt_VertexCacheStatistics
 {
 	unsigned int vertices_transformed;
@@ -195,9 +830,21 @@ struct meshopt_OverdrawStatistics
  */
 MESHOPTIMIZER_API struct meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 
+/**
+ * Overdraw analyzer with configurable resolution
+ * Returns the same statistics as meshopt_analyzeOverdraw, rendering each of the three views at viewport_size x viewport_size pixels (meshopt_analyzeOverdraw uses 256)
+ * Triangles larger than a few pixels are rasterized in 4x4 pixel blocks; results at 256 are close to but not always bit-identical with meshopt_analyzeOverdraw
+ * The block rasterizer uses SSE2 on x86/x64 and scalar code on other targets (there is no NEON path)
+ * Each view is rendered in horizontal bands and allocates up to 1 MB of scratch memory while it runs; the three views are analyzed as independent tasks
+ *
+ * viewport_size must be in [1..1024] range
+ * parallel_for can be NULL, in which case views are analyzed serially on the calling thread
+ */
+MESHOPTIMIZER_API struct meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, unsigned int viewport_size, meshopt_ParallelFor parallel_for, void* context);
+
 struct meshopt_VertexFetchStatistics
 {
-	unsigned int bytes_fetched;
+	size_t bytes_fetched;
 	float overfetch; /* fetched bytes / vertex buffer size; best case 1.0 (each byte is fetched once) */
 };
 
@@ -208,6 +855,70 @@ struct meshopt_VertexFetchStatistics
  */
 MESHOPTIMIZER_API struct meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const unsigned int* indices, size_t index_count, size_t vertex_count, size_t vertex_size);
 
+/**
+ * Multi-pass vertex fetch cache analyzer
+ * Returns cache hit statistics summed over all passes using the same model as meshopt_analyzeVertexFetch with a configurable cache line size; each pass starts with a cold cache, and streams fetched by one pass share the cache
+ * bytes_fetched is the total over all passes; overfetch is relative to the size of the vertex data referenced by each pass in the streams it fetches
+ * A single pass that fetches a single stream with 64-byte lines gives the same results as meshopt_analyzeVertexFetch
+ *
+ * stream_strides contains stream_count strides in bytes; stream_count must be in [1..32] range
+ * cache_line_size must be in [1..4096] range
+ */
+MESHOPTIMIZER_API struct meshopt_VertexFetchStatistics meshopt_analyzeVertexFetchPasses(const struct meshopt_VertexFetchPass* passes, size_t pass_count, size_t vertex_count, const size_t* stream_strides, size_t stream_count, size_t cache_line_size);
+
+/**
+ * Set allocation callbacks
+ * These callbacks will be used instead of the default operator new/operator delete for all temporary allocations in the library.
+ * Note that all algorithms only allocate memory for temporary use: every allocation made by a function is deallocated before it returns,
+ * so a bump/arena allocator that is reset between calls only needs to be as large as the peak usage of the largest call.
+ * allocate must return memory aligned like operator new does (suitable for any fundamental type); the library doesn't require a larger alignment.
+ * The callbacks are global and may be called concurrently when the library is used from multiple threads.
+ * Setting the allocator is not thread-safe and should be done before using any other library functions.
+ *
+ * The callbacks are stored in template statics defined in this header (meshopt_Memory), so each executable or shared library that includes it gets its own copy on platforms that don't merge them across modules, such as Windows DLLs.
+ * When the library is built as a DLL, meshopt_setAllocator only affects allocations made inside the DLL; the C++ template wrappers that convert index types are instantiated in the calling module and keep using that module's callbacks.
+ */
+MESHOPTIMIZER_API void meshopt_setAllocator(void* (*allocate)(size_t), void (*deallocate)(void*));
+
+/**
+ * Instrumentation event reported to the callback set with meshopt_setInstrumentation
+ * Each instrumented function reports a "start" event when it begins and an event after each stage completes; the callback can record a timestamp to measure the time spent in each stage
+ * function is the entry point name without the meshopt_ prefix; counters that don't apply to a stage are 0
+ *
+ * simplify (all simplifier variants): "adjacency", "classify" and "quadrics", followed by "collapse" for each level of detail
+ *   items is the number of triangles; for "collapse", items is the resulting triangle count, iterations is the number of passes (or priority queue pops) and collapses is the number of edge collapses
+ * optimizeVertexCache, optimizeVertexCacheFifo: "adjacency", "optimize"; items is the number of triangles and iterations is the number of dead-end restarts
+ * optimizeOverdraw: "clusters", "sort" and "output"; items is the number of triangles and iterations is the number of clusters for "clusters" and "sort"
+ * encodeIndexBuffer, encodeIndexBufferAdaptive, decodeIndexBuffer, encodeVertexBuffer, decodeVertexBuffer (all decoder variants): "encode" or "decode"
+ *   items is the number of indices or vertices; bytes_read and bytes_written are the sizes of the input and output data; a failed operation reports no stage event
+ */
+struct meshopt_InstrumentationEvent
+{
+	const char* function;
+	const char* stage;
+
+	size_t items;
+	size_t iterations;
+	size_t collapses;
+
+	size_t bytes_read;
+	size_t bytes_written;
+};
+
+typedef void (*meshopt_InstrumentationCallback)(void* context, const struct meshopt_InstrumentationEvent* event);
+
+/**
+ * Set instrumentation callback
+ * The callback receives events from the simplifier, vertex cache and overdraw optimizers and codecs, see meshopt_InstrumentationEvent; callback can be NULL to disable instrumentation, which is the default
+ * When instrumentation is disabled, each stage only checks the callback pointer, so the overhead is negligible
+ * The callback is global and may be called concurrently when the library is used from multiple threads, including from worker threads of parallel_for in parallel variants
+ * Setting the callback is not thread-safe and should be done before using any other library functions.
+ *
+ * Like the allocation callbacks, the callback is stored in a template static defined in this header (meshopt_Instrumentation), so each module gets its own copy on platforms such as Windows;
+ * meshopt_setInstrumentation only affects library code linked into the same module, e.g. when the library is linked statically into several DLLs, each DLL needs its own call.
+ */
+MESHOPTIMIZER_API void meshopt_setInstrumentation(meshopt_InstrumentationCallback callback, void* context);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -253,6 +964,43 @@ inline float meshopt_quantizeFloat(float v, int N);
  * the wrappers end up allocating memory and copying index data to convert from one type to another.
  */
 #ifdef __cplusplus
+/* Allocation callback storage; see meshopt_setAllocator */
+template <typename T>
+struct meshopt_Memory
+{
+	static void* (*allocate)(size_t);
+	static void (*deallocate)(void*);
+};
+
+template <typename T>
+void* (*meshopt_Memory<T>::allocate)(size_t) = operator new;
+
+template <typename T>
+void (*meshopt_Memory<T>::deallocate)(void*) = operator delete;
+
+/* Instrumentation callback storage; see meshopt_setInstrumentation */
+template <typename T>
+struct meshopt_Instrumentation
+{
+	static meshopt_InstrumentationCallback callback;
+	static void* context;
+
+	static void report(const char* function, const char* stage, size_t items, size_t iterations = 0, size_t collapses = 0, size_t bytes_read = 0, size_t bytes_written = 0)
+	{
+		if (callback)
+		{
+			meshopt_InstrumentationEvent event = {function, stage, items, iterations, collapses, bytes_read, bytes_written};
+			callback(context, &event);
+		}
+	}
+};
+
+template <typename T>
+meshopt_InstrumentationCallback meshopt_Instrumentation<T>::callback = 0;
+
+template <typename T>
+void* meshopt_Instrumentation<T>::context = 0;
+
 template <typename T, bool ZeroCopy = sizeof(T) == sizeof(unsigned int)>
 struct meshopt_IndexAdapter;
 
@@ -268,7 +1016,7 @@ struct meshopt_IndexAdapter<T, false>
 	    , data(0)
 	    , count(count)
 	{
-		data = new unsigned int[count];
+		data = static_cast<unsigned int*>(meshopt_Memory<void>::allocate(count * sizeof(unsigned int)));
 
 		if (input)
 		{
@@ -285,7 +1033,7 @@ struct meshopt_IndexAdapter<T, false>
 				result[i] = T(data[i]);
 		}
 
-		delete[] data;
+		meshopt_Memory<void>::deallocate(data);
 	}
 };
 
@@ -308,6 +1056,22 @@ inline size_t meshopt_generateVertexRemap(unsigned int* destination, const T* in
 	return meshopt_generateVertexRemap(destination, indices ? in.data : 0, index_count, vertices, vertex_count, vertex_size);
 }
 
+template <typename T>
+inline size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapParallel(destination, indices ? in.data : 0, index_count, vertices, vertex_count, vertex_size, partition_count, parallel_for, context);
+}
+
+template <typename T>
+inline size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapMulti(destination, indices ? in.data : 0, index_count, vertex_count, streams, stream_count);
+}
+
 template <typename T>
 inline void meshopt_remapIndexBuffer(T* destination, const T* indices, size_t index_count, const unsigned int* remap)
 {
@@ -317,6 +1081,15 @@ inline void meshopt_remapIndexBuffer(T* destination, const T* indices, size_t in
 	meshopt_remapIndexBuffer(out.data, indices ? in.data : 0, index_count, remap);
 }
 
+template <typename T>
+inline size_t meshopt_generateShadowIndexBuffer(T* destination, float* destination_positions, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	meshopt_IndexAdapter<T> in(0, indices, indices ? index_count : 0);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	return meshopt_generateShadowIndexBuffer(out.data, destination_positions, indices ? in.data : 0, index_count, vertex_positions, vertex_count, vertex_positions_stride);
+}
+
 template <typename T>
 inline void meshopt_optimizeVertexCache(T* destination, const T* indices, size_t index_count, size_t vertex_count)
 {
@@ -326,6 +1099,15 @@ inline void meshopt_optimizeVertexCache(T* destination, const T* indices, size_t
 	meshopt_optimizeVertexCache(out.data, in.data, index_count, vertex_count);
 }
 
+template <typename T>
+inline void meshopt_optimizeVertexCacheParallel(T* destination, const T* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	meshopt_optimizeVertexCacheParallel(out.data, in.data, index_count, vertex_count, partition_count, parallel_for, context);
+}
+
 template <typename T>
 inline void meshopt_optimizeVertexCacheFifo(T* destination, const T* indices, size_t index_count, size_t vertex_count, unsigned int cache_size)
 {
@@ -335,6 +1117,15 @@ inline void meshopt_optimizeVertexCacheFifo(T* destination, const T* indices, si
 	meshopt_optimizeVertexCacheFifo(out.data, in.data, index_count, vertex_count, cache_size);
 }
 
+template <typename T>
+inline void meshopt_optimizeVertexCacheProfile(T* destination, const T* indices, size_t index_count, size_t vertex_count, unsigned int cache_size, unsigned int warp_size, unsigned int primgroup_size)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	meshopt_optimizeVertexCacheProfile(out.data, in.data, index_count, vertex_count, cache_size, warp_size, primgroup_size);
+}
+
 template <typename T>
 inline void meshopt_optimizeOverdraw(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
 {
@@ -344,6 +1135,15 @@ inline void meshopt_optimizeOverdraw(T* destination, const T* indices, size_t in
 	meshopt_optimizeOverdraw(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, threshold);
 }
 
+template <typename T>
+inline void meshopt_optimizeOverdrawOctants(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count * 8);
+
+	meshopt_optimizeOverdrawOctants(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, threshold);
+}
+
 template <typename T>
 inline size_t meshopt_optimizeVertexFetchRemap(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count)
 {
@@ -360,6 +1160,15 @@ inline size_t meshopt_optimizeVertexFetch(void* destination, T* indices, size_t
 	return meshopt_optimizeVertexFetch(destination, inout.data, index_count, vertices, vertex_count, vertex_size);
 }
 
+template <typename T>
+inline size_t meshopt_optimizeMesh(T* destination_indices, void* destination_vertices, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride, float threshold, unsigned int options, meshopt_StageCallback callback, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination_indices, 0, index_count);
+
+	return meshopt_optimizeMesh(out.data, destination_vertices, in.data, index_count, vertices, vertex_count, vertex_size, vertex_positions, vertex_positions_stride, threshold, options, callback, context);
+}
+
 template <typename T>
 inline size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count)
 {
@@ -368,6 +1177,14 @@ inline size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_siz
 	return meshopt_encodeIndexBuffer(buffer, buffer_size, in.data, index_count);
 }
 
+template <typename T>
+inline size_t meshopt_encodeIndexBufferAdaptive(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_encodeIndexBufferAdaptive(buffer, buffer_size, in.data, index_count);
+}
+
 template <typename T>
 inline int meshopt_decodeIndexBuffer(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size)
 {
@@ -377,6 +1194,15 @@ inline int meshopt_decodeIndexBuffer(T* destination, size_t index_count, const u
 	return meshopt_decodeIndexBuffer(destination, index_count, sizeof(T), buffer, buffer_size);
 }
 
+template <typename T>
+inline int meshopt_decodeIndexStream(meshopt_IndexDecoderState* state, T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size)
+{
+	char index_size_valid[sizeof(T) == 2 || sizeof(T) == 4 ? 1 : -1];
+	(void)index_size_valid;
+
+	return meshopt_decodeIndexStream(state, destination, index_count, sizeof(T), buffer, buffer_size);
+}
+
 template <typename T>
 inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error)
 {
@@ -386,6 +1212,33 @@ inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_co
 	return meshopt_simplify(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count, target_error);
 }
 
+template <typename T>
+inline size_t meshopt_simplifyWithAttributes(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t target_index_count, float target_error, unsigned int options)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	return meshopt_simplifyWithAttributes(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, target_index_count, target_error, options);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyLodChain(T* destination, size_t* lod_index_counts, float* lod_errors, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count * lod_count);
+
+	return meshopt_simplifyLodChain(out.data, lod_index_counts, lod_errors, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, target_index_counts, target_errors, lod_count, options);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, unsigned int options, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, index_count);
+
+	return meshopt_simplifyParallel(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, target_index_count, target_error, options, partition_count, parallel_for, context);
+}
+
 template <typename T>
 inline size_t meshopt_stripify(T* destination, const T* indices, size_t index_count, size_t vertex_count)
 {
@@ -395,6 +1248,24 @@ inline size_t meshopt_stripify(T* destination, const T* indices, size_t index_co
 	return meshopt_stripify(out.data, in.data, index_count, vertex_count);
 }
 
+template <typename T>
+inline size_t meshopt_stripifyCache(T* destination, const T* indices, size_t index_count, size_t vertex_count, unsigned int restart_index, unsigned int cache_size, float threshold)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, (index_count / 3) * (restart_index ? 4 : 5));
+
+	return meshopt_stripifyCache(out.data, in.data, index_count, vertex_count, restart_index, cache_size, threshold);
+}
+
+template <typename T>
+inline size_t meshopt_stripifyParallel(T* destination, const T* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, 0, (index_count / 3) * 4);
+
+	return meshopt_stripifyParallel(out.data, in.data, index_count, vertex_count, partition_count, parallel_for, context);
+}
+
 template <typename T>
 inline size_t meshopt_unstripify(T* destination, const T* indices, size_t index_count)
 {
@@ -404,6 +1275,22 @@ inline size_t meshopt_unstripify(T* destination, const T* indices, size_t index_
 	return meshopt_unstripify(out.data, in.data, index_count);
 }
 
+template <typename T>
+inline size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_count, max_vertices, max_triangles);
+}
+
+template <typename T>
+inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_computeClusterBounds(in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride);
+}
+
 template <typename T>
 inline meshopt_VertexCacheStatistics meshopt_analyzeVertexCache(const T* indices, size_t index_count, size_t vertex_count, unsigned int cache_size, unsigned int warp_size, unsigned int buffer_size)
 {
@@ -420,6 +1307,14 @@ inline meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const T* indices, size
 	return meshopt_analyzeOverdraw(in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride);
 }
 
+template <typename T>
+inline meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, unsigned int viewport_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(0, indices, index_count);
+
+	return meshopt_analyzeOverdrawParallel(in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, viewport_size, parallel_for, context);
+}
+
 template <typename T>
 inline meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const T* indices, size_t index_count, size_t vertex_count, size_t vertex_size)
 {
@@ -500,6 +1395,7 @@ inline float meshopt_quantizeFloat(float v, int N)
 
 /* Internal implementation helpers */
 #ifdef __cplusplus
+/* Note: T must be a POD type since the memory is obtained from meshopt_Memory and no constructors/destructors are called */
 template <typename T>
 class meshopt_Buffer
 {
@@ -520,12 +1416,13 @@ public:
 	    : data(0)
 	    , size(size)
 	{
-		data = new T[size];
+		data = static_cast<T*>(meshopt_Memory<void>::allocate(size * sizeof(T)));
 	}
 
 	~meshopt_Buffer()
 	{
-		delete[] data;
+		if (data)
+			meshopt_Memory<void>::deallocate(data);
 	}
 
 	T& operator[](size_t index)
@@ -543,7 +1440,7 @@ public:
 	void allocate(size_t size_)
 	{
 		assert(!data);
-		data = new T[size_];
+		data = static_cast<T*>(meshopt_Memory<void>::allocate(size_ * sizeof(T)));
 		size = size_;
 	}
 };
@@ -1,16 +1,32 @@
 // This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
 #include "meshoptimizer.h"
+#include "parallel.h"
 
 #include <assert.h>
 #include <float.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2
+#endif
+
+#ifdef SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 // This work is based on:
 // Nicolas Capens. Advanced Rasterization. 2004
 namespace meshopt
 {
 
 const int kViewport = 256;
+const unsigned int kViewportMax = 1024;
+
+const int kBlockSize = 4;
+const int kSmallTriangleArea = 8;
+
+// the viewport is rendered in horizontal bands of up to this many pixels so that band buffers stay in cache
+const int kBandPixels = 65536;
 
 struct OverdrawBuffer
 {
@@ -149,20 +165,273 @@ static void rasterize(OverdrawBuffer* buffer, float v1x, float v1y, float v1z, f
 	}
 }
 
-} // namespace meshopt
+struct OverdrawTarget
+{
+	float* z[2];
+	unsigned int* overdraw[2];
 
-meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+	int size;
+	int stride;
+
+	// buffers store rows [band_begin..band_end)
+	int band_begin;
+	int band_end;
+};
+
+static bool isBlockOutside(int c, int dx, int dy)
 {
-	using namespace meshopt;
+	// half edge equations are linear, so the block is outside of the edge iff all four corner pixel centers are
+	int s = kBlockSize - 1;
 
-	assert(index_count % 3 == 0);
-	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
-	assert(vertex_positions_stride % sizeof(float) == 0);
+	return (c & (c + dx * s) & (c + dy * s) & (c + dx * s + dy * s)) < 0;
+}
 
-	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+// evaluates half edge equations and depth per pixel; used for small triangles and when SIMD is not available
+static void rasterizePixels(float* zbuf, unsigned int* obuf, int stride, int cols, int rows, const int* c, const int* dx, const int* dy, float z, float dzdx, float dzdy)
+{
+	int CY1 = c[0];
+	int CY2 = c[1];
+	int CY3 = c[2];
+	float ZY = z;
 
-	meshopt_OverdrawStatistics result = {};
+	for (int y = 0; y < rows; ++y)
+	{
+		float* zrow = zbuf + y * stride;
+		unsigned int* orow = obuf + y * stride;
+
+		int CX1 = CY1;
+		int CX2 = CY2;
+		int CX3 = CY3;
+		float ZX = ZY;
+
+		for (int x = 0; x < cols; ++x)
+		{
+			// check if all CXn are non-negative
+			if ((CX1 | CX2 | CX3) >= 0 && ZX >= zrow[x])
+			{
+				zrow[x] = ZX;
+				orow[x]++;
+			}
+
+			CX1 += dx[0];
+			CX2 += dx[1];
+			CX3 += dx[2];
+			ZX += dzdx;
+		}
+
+		CY1 += dy[0];
+		CY2 += dy[1];
+		CY3 += dy[2];
+		ZY += dzdy;
+	}
+}
+
+#ifdef SIMD_SSE2
+// per-triangle steps for rasterizeBlock, so that block setup only needs to broadcast the values at the top left pixel
+struct BlockSteps
+{
+	__m128i dx[3];
+	__m128i dy[3];
+	__m128 dzdx;
+	__m128 dzdy;
+};
+
+static void prepareBlockSteps(BlockSteps& steps, const int* dx, const int* dy, float dzdx, float dzdy)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		steps.dx[i] = _mm_setr_epi32(0, dx[i], dx[i] * 2, dx[i] * 3);
+		steps.dy[i] = _mm_set1_epi32(dy[i]);
+	}
+
+	steps.dzdx = _mm_setr_ps(0, dzdx, dzdx * 2, dzdx * 3);
+	steps.dzdy = _mm_set1_ps(dzdy);
+}
+
+static void rasterizeBlock(float* zbuf, unsigned int* obuf, int stride, int rows, const int* c, float z, const BlockSteps& steps)
+{
+	__m128i c1 = _mm_add_epi32(_mm_set1_epi32(c[0]), steps.dx[0]);
+	__m128i c2 = _mm_add_epi32(_mm_set1_epi32(c[1]), steps.dx[1]);
+	__m128i c3 = _mm_add_epi32(_mm_set1_epi32(c[2]), steps.dx[2]);
+	__m128 zx = _mm_add_ps(_mm_set1_ps(z), steps.dzdx);
+
+	__m128i dy1 = steps.dy[0];
+	__m128i dy2 = steps.dy[1];
+	__m128i dy3 = steps.dy[2];
+	__m128 dz = steps.dzdy;
+
+	for (int y = 0; y < rows; ++y)
+	{
+		float* zrow = zbuf + y * stride;
+		unsigned int* orow = obuf + y * stride;
+
+		// pixel is covered if all half edge equations are non-negative
+		__m128i edges = _mm_or_si128(_mm_or_si128(c1, c2), c3);
+		__m128 covered = _mm_castsi128_ps(_mm_cmpgt_epi32(edges, _mm_set1_epi32(-1)));
+
+		__m128 zold = _mm_loadu_ps(zrow);
+		__m128 mask = _mm_and_ps(covered, _mm_cmpge_ps(zx, zold));
+
+		_mm_storeu_ps(zrow, _mm_or_ps(_mm_and_ps(mask, zx), _mm_andnot_ps(mask, zold)));
+
+		// mask lanes are ~0 for shaded pixels, so subtracting the mask increments the counters
+		__m128i count = _mm_loadu_si128(reinterpret_cast<__m128i*>(orow));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(orow), _mm_sub_epi32(count, _mm_castps_si128(mask)));
+
+		c1 = _mm_add_epi32(c1, dy1);
+		c2 = _mm_add_epi32(c2, dy2);
+		c3 = _mm_add_epi32(c3, dy3);
+		zx = _mm_add_ps(zx, dz);
+	}
+}
+#else
+struct BlockSteps
+{
+	const int* dx;
+	const int* dy;
+	float dzdx;
+	float dzdy;
+};
+
+static void prepareBlockSteps(BlockSteps& steps, const int* dx, const int* dy, float dzdx, float dzdy)
+{
+	steps.dx = dx;
+	steps.dy = dy;
+	steps.dzdx = dzdx;
+	steps.dzdy = dzdy;
+}
+
+static void rasterizeBlock(float* zbuf, unsigned int* obuf, int stride, int rows, const int* c, float z, const BlockSteps& steps)
+{
+	rasterizePixels(zbuf, obuf, stride, kBlockSize, rows, c, steps.dx, steps.dy, z, steps.dzdx, steps.dzdy);
+}
+#endif
+
+// blocked version of rasterize(): same setup and fill convention, but pixels are processed in 4x4 blocks
+// blocks that are outside of any edge are rejected using the corner pixels; the remaining blocks evaluate all edges per pixel
+static void rasterizeBlocks(const OverdrawTarget& target, float v1x, float v1y, float v1z, float v2x, float v2y, float v2z, float v3x, float v3y, float v3z)
+{
+	// coordinates, 28.4 fixed point
+	int X1 = int(16.0f * v1x + 0.5f);
+	int X2 = int(16.0f * v2x + 0.5f);
+	int X3 = int(16.0f * v3x + 0.5f);
+
+	int Y1 = int(16.0f * v1y + 0.5f);
+	int Y2 = int(16.0f * v2y + 0.5f);
+	int Y3 = int(16.0f * v3y + 0.5f);
+
+	// bounding rectangle, clipped against viewport
+	int minx = max((min(X1, min(X2, X3)) + 7) >> 4, 0);
+	int maxx = min((max(X1, max(X2, X3)) + 7) >> 4, target.size);
+	int miny = max((min(Y1, min(Y2, Y3)) + 7) >> 4, target.band_begin);
+	int maxy = min((max(Y1, max(Y2, Y3)) + 7) >> 4, target.band_end);
+
+	// small triangles often don't cover any pixel centers; rejecting them before triangle setup is much cheaper
+	if (minx >= maxx || miny >= maxy)
+		return;
+
+	// compute depth gradients
+	float DZx, DZy;
+	float det = computeDepthGradients(DZx, DZy, v1x, v1y, v1z, v2x, v2y, v2z, v3x, v3y, v3z);
+	int sign = det > 0;
+
+	// flip backfacing triangles to simplify rasterization logic
+	if (sign)
+	{
+		// flipping v2 & v3 preserves depth gradients since they're based on v1; v1 is the only vertex used for depth below
+		int t;
+		t = X2, X2 = X3, X3 = t;
+		t = Y2, Y2 = Y3, Y3 = t;
+
+		// flip depth since we rasterize backfacing triangles to second buffer with reverse Z
+		v1z = float(target.size) - v1z;
+		DZx = -DZx;
+		DZy = -DZy;
+	}
+
+	// deltas, 28.4 fixed point
+	int DX12 = X1 - X2;
+	int DX23 = X2 - X3;
+	int DX31 = X3 - X1;
+
+	int DY12 = Y1 - Y2;
+	int DY23 = Y2 - Y3;
+	int DY31 = Y3 - Y1;
+
+	// fill convention correction
+	int TL1 = DY12 < 0 || (DY12 == 0 && DX12 > 0);
+	int TL2 = DY23 < 0 || (DY23 == 0 && DX23 > 0);
+	int TL3 = DY31 < 0 || (DY31 == 0 && DX31 > 0);
+
+	// half edge equations, 24.8 fixed point
+	// note that we offset minx/miny by half pixel since we want to rasterize pixels with covered centers
+	int FX = (minx << 4) + 8;
+	int FY = (miny << 4) + 8;
+	int CY[3] = {
+	    DX12 * (FY - Y1) - DY12 * (FX - X1) + TL1 - 1,
+	    DX23 * (FY - Y2) - DY23 * (FX - X2) + TL2 - 1,
+	    DX31 * (FY - Y3) - DY31 * (FX - X3) + TL3 - 1,
+	};
+	float ZY = v1z + (DZx * float(FX - X1) + DZy * float(FY - Y1)) * (1 / 16.f);
+
+	// per-pixel steps of half edge equations
+	int dx[3] = {-DY12 * 16, -DY23 * 16, -DY31 * 16};
+	int dy[3] = {DX12 * 16, DX23 * 16, DX31 * 16};
+
+	float* zbuf = target.z[sign];
+	unsigned int* obuf = target.overdraw[sign];
+
+	// most triangles in dense meshes only touch a few pixels, so block setup isn't worth it
+	if ((maxx - minx) * (maxy - miny) <= kSmallTriangleArea)
+	{
+		size_t offset = size_t(miny - target.band_begin) * target.stride + minx;
+
+		rasterizePixels(zbuf + offset, obuf + offset, target.stride, maxx - minx, maxy - miny, CY, dx, dy, ZY, DZx, DZy);
+		return;
+	}
+
+	// align minx to block boundary; the buffer rows are padded to a multiple of the block size so that blocks on the right edge stay in bounds
+	// blocks on the bottom edge are clipped instead
+	int shift = minx & (kBlockSize - 1);
 
+	minx -= shift;
+	CY[0] -= dx[0] * shift;
+	CY[1] -= dx[1] * shift;
+	CY[2] -= dx[2] * shift;
+	ZY -= DZx * float(shift);
+
+	BlockSteps steps;
+	prepareBlockSteps(steps, dx, dy, DZx, DZy);
+
+	for (int y = miny; y < maxy; y += kBlockSize)
+	{
+		int CX[3] = {CY[0], CY[1], CY[2]};
+		float ZX = ZY;
+
+		for (int x = minx; x < maxx; x += kBlockSize)
+		{
+			if (!isBlockOutside(CX[0], dx[0], dy[0]) && !isBlockOutside(CX[1], dx[1], dy[1]) && !isBlockOutside(CX[2], dx[2], dy[2]))
+			{
+				size_t offset = size_t(y - target.band_begin) * target.stride + x;
+
+				rasterizeBlock(zbuf + offset, obuf + offset, target.stride, min(maxy - y, kBlockSize), CX, ZX, steps);
+			}
+
+			CX[0] += dx[0] * kBlockSize;
+			CX[1] += dx[1] * kBlockSize;
+			CX[2] += dx[2] * kBlockSize;
+			ZX += DZx * kBlockSize;
+		}
+
+		CY[0] += dy[0] * kBlockSize;
+		CY[1] += dy[1] * kBlockSize;
+		CY[2] += dy[2] * kBlockSize;
+		ZY += DZy * kBlockSize;
+	}
+}
+
+static void projectTriangles(float* triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_stride_float, float viewport)
+{
 	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
 	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
 
@@ -178,9 +447,7 @@ meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices,
 	}
 
 	float extent = max(maxv[0] - minv[0], max(maxv[1] - minv[1], maxv[2] - minv[2]));
-	float scale = kViewport / extent;
-
-	meshopt_Buffer<float> triangles(index_count * 3);
+	float scale = viewport / extent;
 
 	for (size_t i = 0; i < index_count; ++i)
 	{
@@ -193,6 +460,135 @@ meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices,
 		triangles[i * 3 + 1] = (v[1] - minv[1]) * scale;
 		triangles[i * 3 + 2] = (v[2] - minv[2]) * scale;
 	}
+}
+
+struct OverdrawViewData
+{
+	const float* triangles;
+	size_t index_count;
+
+	int viewport;
+	int stride;
+	int band_height;
+
+	unsigned int pixels_covered[3];
+	unsigned int pixels_shaded[3];
+};
+
+static void analyzeOverdrawView(void* task_data, size_t index)
+{
+	OverdrawViewData& data = *static_cast<OverdrawViewData*>(task_data);
+
+	int axis = int(index);
+
+	const float* triangles = data.triangles;
+	size_t triangle_count = data.index_count / 3;
+
+	// each view allocates its own buffers, so only views that run concurrently need separate memory
+	size_t plane = size_t(data.stride) * data.band_height;
+
+	meshopt_Buffer<float> z(plane * 2);
+	meshopt_Buffer<unsigned int> overdraw(plane * 2);
+
+	OverdrawTarget target;
+	target.z[0] = z.data;
+	target.z[1] = z.data + plane;
+	target.overdraw[0] = overdraw.data;
+	target.overdraw[1] = overdraw.data + plane;
+	target.size = data.viewport;
+	target.stride = data.stride;
+
+	// screen y for each view; matches the coordinate order used for rasterization below
+	static const int kAxisY[3] = {1, 2, 0};
+
+	int band_count = (data.viewport + data.band_height - 1) / data.band_height;
+
+	meshopt_Buffer<unsigned short> bands(band_count > 1 ? triangle_count * 2 : 0);
+
+	// bin triangles into bands using a conservative range of rows they can cover
+	if (band_count > 1)
+	{
+		int ay = kAxisY[axis];
+
+		for (size_t i = 0; i < triangle_count; ++i)
+		{
+			float y0 = triangles[i * 9 + 0 + ay];
+			float y1 = triangles[i * 9 + 3 + ay];
+			float y2 = triangles[i * 9 + 6 + ay];
+
+			int miny = max(int(min(y0, min(y1, y2))) - 1, 0);
+			int maxy = min(int(max(y0, max(y1, y2))), data.viewport - 1);
+
+			bands[i * 2 + 0] = (unsigned short)(miny / data.band_height);
+			bands[i * 2 + 1] = (unsigned short)(maxy / data.band_height);
+		}
+	}
+
+	unsigned int pixels_covered = 0;
+	unsigned int pixels_shaded = 0;
+
+	for (int band = 0; band < band_count; ++band)
+	{
+		target.band_begin = band * data.band_height;
+		target.band_end = min(target.band_begin + data.band_height, data.viewport);
+
+		memset(target.z[0], 0, plane * 2 * sizeof(float));
+		memset(target.overdraw[0], 0, plane * 2 * sizeof(unsigned int));
+
+		for (size_t i = 0; i < triangle_count; ++i)
+		{
+			if (band_count > 1 && (bands[i * 2 + 0] > band || bands[i * 2 + 1] < band))
+				continue;
+
+			const float* vn0 = &triangles[9 * i + 0];
+			const float* vn1 = &triangles[9 * i + 3];
+			const float* vn2 = &triangles[9 * i + 6];
+
+			switch (axis)
+			{
+			case 0:
+				rasterizeBlocks(target, vn0[2], vn0[1], vn0[0], vn1[2], vn1[1], vn1[0], vn2[2], vn2[1], vn2[0]);
+				break;
+			case 1:
+				rasterizeBlocks(target, vn0[0], vn0[2], vn0[1], vn1[0], vn1[2], vn1[1], vn2[0], vn2[2], vn2[1]);
+				break;
+			case 2:
+				rasterizeBlocks(target, vn0[1], vn0[0], vn0[2], vn1[1], vn1[0], vn1[2], vn2[1], vn2[0], vn2[2]);
+				break;
+			}
+		}
+
+		for (int y = 0; y < target.band_end - target.band_begin; ++y)
+			for (int x = 0; x < data.viewport; ++x)
+				for (int s = 0; s < 2; ++s)
+				{
+					unsigned int overdraw = target.overdraw[s][size_t(y) * data.stride + x];
+
+					pixels_covered += overdraw > 0;
+					pixels_shaded += overdraw;
+				}
+	}
+
+	data.pixels_covered[axis] = pixels_covered;
+	data.pixels_shaded[axis] = pixels_shaded;
+}
+
+} // namespace meshopt
+
+meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	meshopt_OverdrawStatistics result = {};
+
+	meshopt_Buffer<float> triangles(index_count * 3);
+	projectTriangles(triangles.data, indices, index_count, vertex_positions, vertex_count, vertex_stride_float, float(kViewport));
 
 	meshopt_Buffer<OverdrawBuffer> buffer_storage(1);
 	OverdrawBuffer* buffer = buffer_storage.data;
@@ -236,3 +632,43 @@ meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices,
 
 	return result;
 }
+
+meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, unsigned int viewport_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(viewport_size > 0 && viewport_size <= kViewportMax);
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	meshopt_OverdrawStatistics result = {};
+
+	meshopt_Buffer<float> triangles(index_count * 3);
+	projectTriangles(triangles.data, indices, index_count, vertex_positions, vertex_count, vertex_stride_float, float(viewport_size));
+
+	// rows are padded to a multiple of the block size so that blocks on the right edge stay in bounds
+	int stride = (int(viewport_size) + kBlockSize - 1) & ~(kBlockSize - 1);
+	int band_height = min(max(kBandPixels / stride, 1), int(viewport_size));
+
+	OverdrawViewData data = {};
+	data.triangles = triangles.data;
+	data.index_count = index_count;
+	data.viewport = int(viewport_size);
+	data.stride = stride;
+	data.band_height = band_height;
+
+	runTasks(parallel_for, context, analyzeOverdrawView, &data, 3);
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		result.pixels_covered += data.pixels_covered[axis];
+		result.pixels_shaded += data.pixels_shaded[axis];
+	}
+
+	result.overdraw = result.pixels_covered ? float(result.pixels_shaded) / float(result.pixels_covered) : 0.f;
+
+	return result;
+}
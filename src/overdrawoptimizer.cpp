@@ -1,5 +1,6 @@
 // This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
 #include "meshoptimizer.h"
+#include "overdrawoptimizer.h"
 
 #include <assert.h>
 #include <math.h>
@@ -10,7 +11,10 @@
 namespace meshopt
 {
 
-static void calculateSortData(float* sort_data, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_positions_stride, const unsigned int* clusters, size_t cluster_count)
+const size_t kOctantCount = 8;
+
+// cluster data is 6 floats per cluster: vector from mesh centroid to cluster centroid, followed by normalized cluster normal
+static void calculateClusterData(float* cluster_data, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_positions_stride, const unsigned int* clusters, size_t cluster_count)
 {
 	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
 
@@ -72,17 +76,41 @@ static void calculateSortData(float* sort_data, const unsigned int* indices, siz
 		float cluster_normal_length = sqrtf(cluster_normal[0] * cluster_normal[0] + cluster_normal[1] * cluster_normal[1] + cluster_normal[2] * cluster_normal[2]);
 		float inv_cluster_normal_length = cluster_normal_length == 0 ? 0 : 1 / cluster_normal_length;
 
-		cluster_normal[0] *= inv_cluster_normal_length;
-		cluster_normal[1] *= inv_cluster_normal_length;
-		cluster_normal[2] *= inv_cluster_normal_length;
+		float* data = cluster_data + cluster * 6;
+
+		data[0] = cluster_centroid[0] - mesh_centroid[0];
+		data[1] = cluster_centroid[1] - mesh_centroid[1];
+		data[2] = cluster_centroid[2] - mesh_centroid[2];
+		data[3] = cluster_normal[0] * inv_cluster_normal_length;
+		data[4] = cluster_normal[1] * inv_cluster_normal_length;
+		data[5] = cluster_normal[2] * inv_cluster_normal_length;
+	}
+}
 
-		float centroid_vector[3] = {cluster_centroid[0] - mesh_centroid[0], cluster_centroid[1] - mesh_centroid[1], cluster_centroid[2] - mesh_centroid[2]};
+static void calculateSortData(float* sort_data, const float* cluster_data, size_t cluster_count)
+{
+	for (size_t cluster = 0; cluster < cluster_count; ++cluster)
+	{
+		const float* data = cluster_data + cluster * 6;
 
-		sort_data[cluster] = centroid_vector[0] * cluster_normal[0] + centroid_vector[1] * cluster_normal[1] + centroid_vector[2] * cluster_normal[2];
+		sort_data[cluster] = data[0] * data[3] + data[1] * data[4] + data[2] * data[5];
 	}
 }
 
-static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_data, unsigned short* sort_keys, size_t cluster_count)
+static void calculateSortDataView(float* sort_data, const float* cluster_data, size_t cluster_count, const float* view)
+{
+	for (size_t cluster = 0; cluster < cluster_count; ++cluster)
+	{
+		const float* data = cluster_data + cluster * 6;
+
+		// clusters that are closer to the camera should come first; sort order puts high values first
+		sort_data[cluster] = -(data[0] * view[0] + data[1] * view[1] + data[2] * view[2]);
+	}
+}
+
+const int kSortBits = 11;
+
+static void calculateSortKeys(unsigned short* sort_keys, const float* sort_data, size_t cluster_count)
 {
 	// compute sort data bounds and renormalize, using fixed point snorm
 	float sort_data_max = 1e-3f;
@@ -94,18 +122,19 @@ static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_
 		sort_data_max = (sort_data_max < dpa) ? dpa : sort_data_max;
 	}
 
-	const int sort_bits = 11;
-
 	for (size_t i = 0; i < cluster_count; ++i)
 	{
 		// note that we flip distribution since high dot product should come first
 		float sort_key = 0.5f - 0.5f * (sort_data[i] / sort_data_max);
 
-		sort_keys[i] = meshopt_quantizeUnorm(sort_key, sort_bits) & ((1 << sort_bits) - 1);
+		sort_keys[i] = meshopt_quantizeUnorm(sort_key, kSortBits) & ((1 << kSortBits) - 1);
 	}
+}
 
+void sortOverdrawClusters(unsigned int* sort_order, const unsigned short* sort_keys, size_t cluster_count)
+{
 	// fill histogram for counting sort
-	unsigned int histogram[1 << sort_bits];
+	unsigned int histogram[1 << kSortBits];
 	memset(histogram, 0, sizeof(histogram));
 
 	for (size_t i = 0; i < cluster_count; ++i)
@@ -116,7 +145,7 @@ static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_
 	// compute offsets based on histogram data
 	size_t histogram_sum = 0;
 
-	for (size_t i = 0; i < 1 << sort_bits; ++i)
+	for (size_t i = 0; i < 1 << kSortBits; ++i)
 	{
 		size_t count = histogram[i];
 		histogram[i] = unsigned(histogram_sum);
@@ -132,6 +161,12 @@ static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_
 	}
 }
 
+static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_data, unsigned short* sort_keys, size_t cluster_count)
+{
+	calculateSortKeys(sort_keys, sort_data, cluster_count);
+	sortOverdrawClusters(sort_order, sort_keys, cluster_count);
+}
+
 static unsigned int updateCache(unsigned int a, unsigned int b, unsigned int c, unsigned int cache_size, unsigned int* cache_timestamps, unsigned int& timestamp)
 {
 	unsigned int cache_misses = 0;
@@ -267,6 +302,48 @@ static size_t generateSoftBoundaries(unsigned int* destination, const unsigned i
 	return result;
 }
 
+void fillOverdrawClusters(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* clusters, size_t cluster_count, const unsigned int* sort_order)
+{
+	size_t offset = 0;
+
+	for (size_t it = 0; it < cluster_count; ++it)
+	{
+		unsigned int cluster = sort_order[it];
+		assert(cluster < cluster_count);
+
+		size_t start = clusters[cluster];
+		size_t end = (cluster + 1 < cluster_count) ? clusters[cluster + 1] : index_count / 3;
+		assert(start < end);
+
+		memcpy(destination + offset, indices + start * 3, (end - start) * 3 * sizeof(unsigned int));
+		offset += (end - start) * 3;
+	}
+
+	assert(offset == index_count);
+}
+
+size_t generateOverdrawClusters(unsigned int* clusters, unsigned short* sort_keys, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
+{
+	assert(index_count > 0 && vertex_count > 0);
+
+	unsigned int cache_size = 16;
+
+	meshopt_Buffer<unsigned int> hard_clusters(index_count / 3);
+	size_t hard_cluster_count = generateHardBoundaries(&hard_clusters[0], indices, index_count, vertex_count, cache_size);
+
+	size_t cluster_count = generateSoftBoundaries(clusters, indices, index_count, vertex_count, &hard_clusters[0], hard_cluster_count, cache_size, threshold);
+
+	meshopt_Buffer<float> cluster_data(cluster_count * 6);
+	calculateClusterData(&cluster_data[0], indices, index_count, vertex_positions, vertex_positions_stride, clusters, cluster_count);
+
+	meshopt_Buffer<float> sort_data(cluster_count);
+	calculateSortData(&sort_data[0], &cluster_data[0], cluster_count);
+
+	calculateSortKeys(sort_keys, &sort_data[0], cluster_count);
+
+	return cluster_count;
+}
+
 } // namespace meshopt
 
 void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
@@ -293,6 +370,8 @@ void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* ind
 
 	unsigned int cache_size = 16;
 
+	meshopt_Instrumentation<void>::report("optimizeOverdraw", "start", index_count / 3);
+
 	// generate hard boundaries from full-triangle cache misses
 	meshopt_Buffer<unsigned int> hard_clusters(index_count / 3);
 	size_t hard_cluster_count = generateHardBoundaries(&hard_clusters[0], indices, index_count, vertex_count, cache_size);
@@ -304,30 +383,82 @@ void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* ind
 	const unsigned int* clusters = &soft_clusters[0];
 	size_t cluster_count = soft_cluster_count;
 
+	meshopt_Instrumentation<void>::report("optimizeOverdraw", "clusters", index_count / 3, cluster_count);
+
 	// fill sort data
+	meshopt_Buffer<float> cluster_data(cluster_count * 6);
+	calculateClusterData(&cluster_data[0], indices, index_count, vertex_positions, vertex_positions_stride, clusters, cluster_count);
+
 	meshopt_Buffer<float> sort_data(cluster_count);
-	calculateSortData(&sort_data[0], indices, index_count, vertex_positions, vertex_positions_stride, clusters, cluster_count);
+	calculateSortData(&sort_data[0], &cluster_data[0], cluster_count);
 
 	// sort clusters using sort data
 	meshopt_Buffer<unsigned short> sort_keys(cluster_count);
 	meshopt_Buffer<unsigned int> sort_order(cluster_count);
 	calculateSortOrderRadix(&sort_order[0], &sort_data[0], &sort_keys[0], cluster_count);
 
+	meshopt_Instrumentation<void>::report("optimizeOverdraw", "sort", index_count / 3, cluster_count);
+
 	// fill output buffer
-	size_t offset = 0;
+	fillOverdrawClusters(destination, indices, index_count, clusters, cluster_count, &sort_order[0]);
 
-	for (size_t it = 0; it < cluster_count; ++it)
+	meshopt_Instrumentation<void>::report("optimizeOverdraw", "output", index_count / 3);
+}
+
+void meshopt_optimizeOverdrawOctants(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	// guard for empty meshes
+	if (index_count == 0 || vertex_count == 0)
+		return;
+
+	// support in-place optimization
+	meshopt_Buffer<unsigned int> indices_copy;
+
+	if (destination == indices)
 	{
-		unsigned int cluster = sort_order[it];
-		assert(cluster < cluster_count);
+		indices_copy.allocate(index_count);
+		memcpy(indices_copy.data, indices, index_count * sizeof(unsigned int));
+		indices = indices_copy.data;
+	}
 
-		size_t start = clusters[cluster];
-		size_t end = (cluster + 1 < cluster_count) ? clusters[cluster + 1] : index_count / 3;
-		assert(start < end);
+	unsigned int cache_size = 16;
 
-		memcpy(destination + offset, indices + start * 3, (end - start) * 3 * sizeof(unsigned int));
-		offset += (end - start) * 3;
+	// all orderings share cluster boundaries, so vertex cache efficiency is the same for every octant
+	meshopt_Buffer<unsigned int> hard_clusters(index_count / 3);
+	size_t hard_cluster_count = generateHardBoundaries(&hard_clusters[0], indices, index_count, vertex_count, cache_size);
+
+	meshopt_Buffer<unsigned int> soft_clusters(index_count / 3 + 1);
+	size_t soft_cluster_count = generateSoftBoundaries(&soft_clusters[0], indices, index_count, vertex_count, &hard_clusters[0], hard_cluster_count, cache_size, threshold);
+
+	const unsigned int* clusters = &soft_clusters[0];
+	size_t cluster_count = soft_cluster_count;
+
+	meshopt_Buffer<float> cluster_data(cluster_count * 6);
+	calculateClusterData(&cluster_data[0], indices, index_count, vertex_positions, vertex_positions_stride, clusters, cluster_count);
+
+	meshopt_Buffer<float> sort_data(cluster_count);
+	meshopt_Buffer<unsigned short> sort_keys(cluster_count);
+	meshopt_Buffer<unsigned int> sort_order(cluster_count);
+
+	for (size_t octant = 0; octant < kOctantCount; ++octant)
+	{
+		// octant index encodes the signs of view direction components, see meshopt_getOverdrawOctant
+		float view[3] = {(octant & 1) ? -1.f : 1.f, (octant & 2) ? -1.f : 1.f, (octant & 4) ? -1.f : 1.f};
+
+		calculateSortDataView(&sort_data[0], &cluster_data[0], cluster_count, view);
+		calculateSortOrderRadix(&sort_order[0], &sort_data[0], &sort_keys[0], cluster_count);
+
+		fillOverdrawClusters(destination + octant * index_count, indices, index_count, clusters, cluster_count, &sort_order[0]);
 	}
+}
 
-	assert(offset == index_count);
+unsigned int meshopt_getOverdrawOctant(float view_x, float view_y, float view_z)
+{
+	return (view_x < 0 ? 1 : 0) | (view_y < 0 ? 2 : 0) | (view_z < 0 ? 4 : 0);
 }
@@ -0,0 +1,25 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#ifndef MESHOPTIMIZER_OVERDRAWOPTIMIZER_H
+#define MESHOPTIMIZER_OVERDRAWOPTIMIZER_H
+
+#include "meshoptimizer.h"
+
+// Internal interface that splits meshopt_optimizeOverdraw into phases, so that batched optimization can sort the clusters of many meshes at once
+// Sorting uses a fixed size histogram, which dominates the cost of overdraw optimization for meshes with a few hundred triangles
+namespace meshopt
+{
+
+// Splits triangles into clusters with meshopt_optimizeOverdraw rules and computes the sort key of each cluster
+// clusters must contain index_count / 3 + 1 elements and sort_keys index_count / 3 elements; returns the number of clusters
+size_t generateOverdrawClusters(unsigned int* clusters, unsigned short* sort_keys, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold);
+
+// Stable sort of clusters by key; sort_order receives cluster_count cluster indices
+// Keys from several meshes can be sorted together, since each mesh keeps the relative order of its clusters
+void sortOverdrawClusters(unsigned int* sort_order, const unsigned short* sort_keys, size_t cluster_count);
+
+// Writes the triangles of each cluster to destination, visiting clusters in sort order
+void fillOverdrawClusters(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* clusters, size_t cluster_count, const unsigned int* sort_order);
+
+} // namespace meshopt
+
+#endif
@@ -0,0 +1,76 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#ifndef MESHOPTIMIZER_PARALLEL_H
+#define MESHOPTIMIZER_PARALLEL_H
+
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+// Internal helpers for the algorithms that split work into tasks processed via meshopt_ParallelFor
+namespace meshopt
+{
+
+inline void runTasks(meshopt_ParallelFor parallel_for, void* context, meshopt_ParallelTask task, void* task_data, size_t count)
+{
+	if (parallel_for)
+		parallel_for(context, task, task_data, count);
+	else
+		for (size_t i = 0; i < count; ++i)
+			task(task_data, i);
+}
+
+// Builds a compact vertex set for triangles [face_begin..face_end) of the index buffer, visited in the order given by order (or in input order if order is NULL)
+// local_indices receives 3 local indices per triangle and local_vertices receives the original index of each local vertex; returns the number of local vertices
+// The same vertex may be present in several partitions, so partitions can share index_count-sized local_indices and local_vertices arrays by using the range [face_begin * 3..face_end * 3) of each
+inline size_t buildLocalVertices(unsigned int* local_indices, unsigned int* local_vertices, const unsigned int* indices, const unsigned int* order, size_t face_begin, size_t face_end)
+{
+	size_t index_count = (face_end - face_begin) * 3;
+
+	// table is an open addressing hash table of original vertex indices, and table_local maps its slots to local indices
+	// the table has room for all partition indices so it never gets full
+	size_t table_size = 1;
+	while (table_size < index_count)
+		table_size *= 2;
+
+	meshopt_Buffer<unsigned int> table(table_size);
+	meshopt_Buffer<unsigned int> table_local(table_size);
+	memset(table.data, -1, table_size * sizeof(unsigned int));
+
+	size_t hashmod = table_size - 1;
+	size_t vertex_count = 0;
+
+	for (size_t i = face_begin; i < face_end; ++i)
+	{
+		size_t face = order ? order[i] : i;
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			unsigned int v = indices[face * 3 + k];
+			size_t bucket = (v * 0x5bd1e995) & hashmod;
+
+			// hash collision, quadratic probing
+			for (size_t probe = 0; table[bucket] != v && table[bucket] != ~0u; ++probe)
+			{
+				assert(probe <= hashmod);
+				bucket = (bucket + probe + 1) & hashmod;
+			}
+
+			if (table[bucket] == ~0u)
+			{
+				table[bucket] = v;
+				table_local[bucket] = unsigned(vertex_count);
+
+				local_vertices[vertex_count++] = v;
+			}
+
+			*local_indices++ = table_local[bucket];
+		}
+	}
+
+	return vertex_count;
+}
+
+} // namespace meshopt
+
+#endif
@@ -0,0 +1,405 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+#include "overdrawoptimizer.h"
+#include "parallel.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace meshopt
+{
+
+static void notifyStage(meshopt_StageCallback callback, void* context, const char* stage)
+{
+	if (callback)
+		callback(context, stage);
+}
+
+// runs deduplication and vertex cache optimization, writing the optimized indices to cache_indices; returns the vertex count for the remaining stages
+// remap must contain vertex_count elements; positions must contain vertex_count * 3 elements when deduplicating, or be NULL to allocate them in positions_storage on demand
+static size_t optimizeMeshCache(unsigned int* cache_indices, const float*& overdraw_positions, size_t& overdraw_positions_stride, unsigned int* destination_indices, void* destination_vertices, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride, unsigned int options, meshopt_StageCallback callback, void* context, unsigned int* remap, float* positions, meshopt_Buffer<float>& positions_storage)
+{
+	bool deduplicate = (options & meshopt_OptimizeMeshDeduplicate) != 0;
+
+	const unsigned int* cache_input = indices;
+	size_t cache_vertex_count = vertex_count;
+
+	// positions are only compacted when deduplicating; otherwise the overdraw stage reads the source positions directly
+	overdraw_positions = vertex_positions;
+	overdraw_positions_stride = vertex_positions_stride;
+
+	if (deduplicate)
+	{
+		size_t unique_vertices = meshopt_generateVertexRemap(remap, indices, index_count, vertices, vertex_count, vertex_size);
+
+		// sized for unique vertices only, as fresh memory for a mostly duplicated source would be expensive to fault in
+		if (!positions)
+		{
+			positions_storage.allocate(unique_vertices * 3);
+			positions = positions_storage.data;
+		}
+
+		// remapping is element-wise, so this is safe for in-place optimization
+		meshopt_remapIndexBuffer(destination_indices, indices, index_count, remap);
+
+		// positions stored in each vertex are copied from the compacted vertices, which is cheaper than another pass over a mostly duplicated source
+		// other positions are compacted first as they may still point into vertex data that in-place optimization overwrites
+		const char* vertex_data = static_cast<const char*>(vertices);
+		const char* position_data = reinterpret_cast<const char*>(vertex_positions);
+
+		bool interleaved = vertex_positions_stride == vertex_size && position_data >= vertex_data && position_data + sizeof(float) * 3 <= vertex_data + vertex_size;
+
+		if (!interleaved)
+		{
+			size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+			for (size_t i = 0; i < vertex_count; ++i)
+			{
+				if (remap[i] != ~0u)
+				{
+					const float* v = vertex_positions + i * vertex_stride_float;
+
+					positions[remap[i] * 3 + 0] = v[0];
+					positions[remap[i] * 3 + 1] = v[1];
+					positions[remap[i] * 3 + 2] = v[2];
+				}
+			}
+		}
+
+		// vertex data is compacted right away, as reading unique vertices from a large source buffer in the final order is slower than moving compacted vertices again
+		meshopt_remapVertexBuffer(destination_vertices, vertices, vertex_count, vertex_size, remap);
+
+		if (interleaved)
+		{
+			const char* compacted = static_cast<const char*>(destination_vertices) + (position_data - vertex_data);
+
+			for (size_t i = 0; i < unique_vertices; ++i)
+				memcpy(&positions[i * 3], compacted + i * vertex_size, sizeof(float) * 3);
+		}
+
+		cache_input = destination_indices;
+		cache_vertex_count = unique_vertices;
+		overdraw_positions = positions;
+		overdraw_positions_stride = sizeof(float) * 3;
+
+		notifyStage(callback, context, "deduplicate");
+	}
+
+	// vertex cache optimization should go first as it provides starting order for overdraw
+	meshopt_optimizeVertexCache(cache_indices, cache_input, index_count, cache_vertex_count);
+	notifyStage(callback, context, "vertexcache");
+
+	return cache_vertex_count;
+}
+
+static size_t getBatchCost(const meshopt_BatchMesh& mesh)
+{
+	return mesh.index_count + mesh.vertex_count;
+}
+
+static size_t getBatchCost(const meshopt_BatchBuffer& buffer)
+{
+	return buffer.count;
+}
+
+// splits items into contiguous groups with similar total cost; group i covers items [offsets[i]..offsets[i + 1])
+template <typename T>
+static size_t partitionBatch(size_t* offsets, const T* items, size_t count, size_t partition_count)
+{
+	size_t total = 0;
+
+	for (size_t i = 0; i < count; ++i)
+		total += getBatchCost(items[i]);
+
+	size_t result = 0;
+	size_t cost = 0;
+
+	offsets[0] = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		cost += getBatchCost(items[i]);
+
+		// close the group once it reaches its share of the total; the last group always ends with the last item
+		if (cost * partition_count >= total * (result + 1) && result + 1 < partition_count && i + 1 < count)
+			offsets[++result] = i + 1;
+	}
+
+	offsets[++result] = count;
+
+	return result;
+}
+
+// meshes of a group are processed in runs of up to this many indices that share one overdraw cluster sort, as the sort has a fixed cost comparable to the rest of the pipeline for small meshes
+const size_t kBatchRunIndices = 16384;
+
+struct OptimizeBatchData
+{
+	meshopt_BatchMesh* meshes;
+	const size_t* offsets;
+
+	size_t vertex_size;
+	size_t vertex_positions_stride;
+	float threshold;
+	unsigned int options;
+};
+
+static void optimizeBatchGroup(void* task_data, size_t index)
+{
+	const OptimizeBatchData& data = *static_cast<const OptimizeBatchData*>(task_data);
+
+	size_t begin = data.offsets[index];
+	size_t end = data.offsets[index + 1];
+
+	// scratch memory is sized for the largest mesh in the group and reused for every mesh
+	size_t max_indices = 0;
+	size_t max_vertices = 0;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		max_indices = max_indices < data.meshes[i].index_count ? data.meshes[i].index_count : max_indices;
+		max_vertices = max_vertices < data.meshes[i].vertex_count ? data.meshes[i].vertex_count : max_vertices;
+	}
+
+	bool deduplicate = (data.options & meshopt_OptimizeMeshDeduplicate) != 0;
+
+	// a run always fits the largest mesh; each mesh needs at most one cluster per triangle plus one while generating soft boundaries
+	size_t run_capacity = max_indices > kBatchRunIndices ? max_indices : kBatchRunIndices;
+	size_t run_mesh_capacity = run_capacity / 3;
+	size_t cluster_capacity = run_capacity / 3 * 2;
+
+	meshopt_Buffer<unsigned int> run_indices(run_capacity);
+	meshopt_Buffer<unsigned int> run_meshes(run_mesh_capacity);
+	meshopt_Buffer<unsigned int> index_offsets(run_mesh_capacity);
+	meshopt_Buffer<unsigned int> cluster_offsets(run_mesh_capacity + 1);
+	meshopt_Buffer<unsigned int> cluster_cursors(run_mesh_capacity);
+
+	meshopt_Buffer<unsigned int> clusters(cluster_capacity);
+	meshopt_Buffer<unsigned int> cluster_meshes(cluster_capacity);
+	meshopt_Buffer<unsigned short> sort_keys(cluster_capacity);
+	meshopt_Buffer<unsigned int> sort_order(cluster_capacity);
+	meshopt_Buffer<unsigned int> mesh_sort_order(cluster_capacity);
+
+	meshopt_Buffer<unsigned int> remap(max_vertices);
+	meshopt_Buffer<float> positions;
+	meshopt_Buffer<float> positions_storage;
+
+	if (deduplicate)
+		positions.allocate(max_vertices * 3);
+
+	size_t next = begin;
+
+	while (next < end)
+	{
+		size_t run_mesh_count = 0;
+		size_t run_index_count = 0;
+		size_t run_cluster_count = 0;
+
+		// deduplicate, optimize for vertex cache and generate overdraw clusters for each mesh of the run
+		for (; next < end; ++next)
+		{
+			meshopt_BatchMesh& mesh = data.meshes[next];
+
+			assert(mesh.index_count % 3 == 0);
+
+			if (mesh.index_count == 0 || mesh.vertex_count == 0)
+			{
+				mesh.result = 0;
+				continue;
+			}
+
+			if (run_index_count + mesh.index_count > run_capacity || run_cluster_count + mesh.index_count / 3 + 1 > cluster_capacity)
+				break;
+
+			unsigned int* cache_indices = run_indices.data + run_index_count;
+			const float* overdraw_positions = 0;
+			size_t overdraw_positions_stride = 0;
+
+			// result temporarily holds the vertex count for the remaining stages
+			mesh.result = optimizeMeshCache(cache_indices, overdraw_positions, overdraw_positions_stride, mesh.destination_indices, mesh.destination_vertices, mesh.indices, mesh.index_count, mesh.vertices, mesh.vertex_count, data.vertex_size, mesh.vertex_positions, data.vertex_positions_stride, data.options, 0, 0, remap.data, positions.data, positions_storage);
+
+			size_t cluster_count = generateOverdrawClusters(clusters.data + run_cluster_count, sort_keys.data + run_cluster_count, cache_indices, mesh.index_count, overdraw_positions, mesh.result, overdraw_positions_stride, data.threshold);
+
+			for (size_t i = 0; i < cluster_count; ++i)
+				cluster_meshes[run_cluster_count + i] = unsigned(run_mesh_count);
+
+			run_meshes[run_mesh_count] = unsigned(next);
+			index_offsets[run_mesh_count] = unsigned(run_index_count);
+			cluster_offsets[run_mesh_count] = unsigned(run_cluster_count);
+			run_mesh_count++;
+
+			run_index_count += mesh.index_count;
+			run_cluster_count += cluster_count;
+		}
+
+		cluster_offsets[run_mesh_count] = unsigned(run_cluster_count);
+
+		// one stable sort orders the clusters of all meshes; splitting the result by mesh keeps the order, so it matches sorting each mesh separately
+		sortOverdrawClusters(sort_order.data, sort_keys.data, run_cluster_count);
+
+		memcpy(cluster_cursors.data, cluster_offsets.data, run_mesh_count * sizeof(unsigned int));
+
+		for (size_t i = 0; i < run_cluster_count; ++i)
+		{
+			unsigned int cluster = sort_order[i];
+			unsigned int run_mesh = cluster_meshes[cluster];
+
+			mesh_sort_order[cluster_cursors[run_mesh]++] = cluster - cluster_offsets[run_mesh];
+		}
+
+		for (size_t i = 0; i < run_mesh_count; ++i)
+		{
+			meshopt_BatchMesh& mesh = data.meshes[run_meshes[i]];
+
+			size_t cluster_offset = cluster_offsets[i];
+
+			fillOverdrawClusters(mesh.destination_indices, run_indices.data + index_offsets[i], mesh.index_count, clusters.data + cluster_offset, cluster_offsets[i + 1] - cluster_offset, mesh_sort_order.data + cluster_offset);
+
+			mesh.result = meshopt_optimizeVertexFetch(mesh.destination_vertices, mesh.destination_indices, mesh.index_count, deduplicate ? mesh.destination_vertices : mesh.vertices, mesh.result, data.vertex_size);
+		}
+	}
+}
+
+struct EncodeBatchData
+{
+	meshopt_BatchBuffer* buffers;
+	const size_t* offsets;
+
+	size_t vertex_size;
+};
+
+static void encodeIndexBatchGroup(void* task_data, size_t index)
+{
+	const EncodeBatchData& data = *static_cast<const EncodeBatchData*>(task_data);
+
+	for (size_t i = data.offsets[index]; i < data.offsets[index + 1]; ++i)
+	{
+		meshopt_BatchBuffer& buffer = data.buffers[i];
+
+		buffer.result = meshopt_encodeIndexBuffer(buffer.buffer, buffer.buffer_size, static_cast<const unsigned int*>(buffer.data), buffer.count);
+	}
+}
+
+static void encodeVertexBatchGroup(void* task_data, size_t index)
+{
+	const EncodeBatchData& data = *static_cast<const EncodeBatchData*>(task_data);
+
+	for (size_t i = data.offsets[index]; i < data.offsets[index + 1]; ++i)
+	{
+		meshopt_BatchBuffer& buffer = data.buffers[i];
+
+		buffer.result = meshopt_encodeVertexBuffer(buffer.buffer, buffer.buffer_size, buffer.data, buffer.count, data.vertex_size);
+	}
+}
+
+static size_t encodeBatch(meshopt_BatchBuffer* buffers, size_t buffer_count, size_t vertex_size, size_t partition_count, meshopt_ParallelFor parallel_for, void* context, meshopt_ParallelTask task)
+{
+	if (buffer_count == 0)
+		return 0;
+
+	if (partition_count > buffer_count)
+		partition_count = buffer_count;
+
+	meshopt_Buffer<size_t> offsets(partition_count + 1);
+	size_t group_count = partitionBatch(offsets.data, buffers, buffer_count, partition_count);
+
+	EncodeBatchData data = {buffers, offsets.data, vertex_size};
+
+	runTasks(parallel_for, context, task, &data, group_count);
+
+	size_t result = 0;
+
+	for (size_t i = 0; i < buffer_count; ++i)
+	{
+		if (buffers[i].result == 0)
+			return 0;
+
+		result += buffers[i].result;
+	}
+
+	return result;
+}
+
+} // namespace meshopt
+
+size_t meshopt_optimizeMesh(unsigned int* destination_indices, void* destination_vertices, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride, float threshold, unsigned int options, meshopt_StageCallback callback, void* context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert((options & ~meshopt_OptimizeMeshDeduplicate) == 0);
+
+	// guard for empty meshes
+	if (index_count == 0 || vertex_count == 0)
+		return 0;
+
+	// all stages share one working set: a scratch index buffer for ping-ponging between stages and a remap table
+	meshopt_Buffer<unsigned int> scratch(index_count + vertex_count);
+	meshopt_Buffer<float> positions_storage;
+
+	unsigned int* scratch_indices = scratch.data;
+	unsigned int* remap = scratch.data + index_count;
+
+	const float* overdraw_positions = 0;
+	size_t overdraw_positions_stride = 0;
+
+	size_t cache_vertex_count = optimizeMeshCache(scratch_indices, overdraw_positions, overdraw_positions_stride, destination_indices, destination_vertices, indices, index_count, vertices, vertex_count, vertex_size, vertex_positions, vertex_positions_stride, options, callback, context, remap, 0, positions_storage);
+
+	meshopt_optimizeOverdraw(destination_indices, scratch_indices, index_count, overdraw_positions, cache_vertex_count, overdraw_positions_stride, threshold);
+	notifyStage(callback, context, "overdraw");
+
+	// vertex fetch optimization should go last as it depends on the final index order
+	bool deduplicate = (options & meshopt_OptimizeMeshDeduplicate) != 0;
+
+	size_t result = meshopt_optimizeVertexFetch(destination_vertices, destination_indices, index_count, deduplicate ? destination_vertices : vertices, cache_vertex_count, vertex_size);
+	notifyStage(callback, context, "vertexfetch");
+
+	return result;
+}
+
+void meshopt_optimizeMeshBatch(meshopt_BatchMesh* meshes, size_t mesh_count, size_t vertex_size, size_t vertex_positions_stride, float threshold, unsigned int options, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert((options & ~meshopt_OptimizeMeshDeduplicate) == 0);
+	assert(partition_count > 0);
+
+	if (mesh_count == 0)
+		return;
+
+	if (partition_count > mesh_count)
+		partition_count = mesh_count;
+
+	meshopt_Buffer<size_t> offsets(partition_count + 1);
+	size_t group_count = partitionBatch(offsets.data, meshes, mesh_count, partition_count);
+
+	OptimizeBatchData data = {meshes, offsets.data, vertex_size, vertex_positions_stride, threshold, options};
+
+	runTasks(parallel_for, context, optimizeBatchGroup, &data, group_count);
+}
+
+size_t meshopt_encodeIndexBufferBatch(meshopt_BatchBuffer* buffers, size_t buffer_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	assert(partition_count > 0);
+
+	return encodeBatch(buffers, buffer_count, 0, partition_count, parallel_for, context, encodeIndexBatchGroup);
+}
+
+size_t meshopt_encodeVertexBufferBatch(meshopt_BatchBuffer* buffers, size_t buffer_count, size_t vertex_size, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(partition_count > 0);
+
+	return encodeBatch(buffers, buffer_count, vertex_size, partition_count, parallel_for, context, encodeVertexBatchGroup);
+}
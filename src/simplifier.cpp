@@ -1,5 +1,6 @@
 // This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
 #include "meshoptimizer.h"
+#include "parallel.h"
 
 #include <assert.h>
 #include <float.h>
@@ -205,6 +206,14 @@ enum VertexKind
 	Kind_Count
 };
 
+// meshopt_simplifyParallel simplifies partitions with a compact vertex set each, locking borders that include the cuts, and then stitches them
+enum PartitionMode
+{
+	Partition_None,
+	Partition_Cut,
+	Partition_Stitch
+};
+
 // manifold vertices can collapse on anything except locked
 // border/seam vertices can only be collapsed onto border/seam respectively
 // TODO: seam->seam collapses don't make sure the collapse is along a seam edge
@@ -368,12 +377,29 @@ static void rescalePositions(Vector3* result, const float* vertex_positions_data
 	}
 }
 
+const size_t kMaxAttributes = 16;
+
+static void rescaleAttributes(float* result, const float* vertex_attributes_data, size_t vertex_count, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count)
+{
+	size_t vertex_stride_float = vertex_attributes_stride / sizeof(float);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		for (size_t k = 0; k < attribute_count; ++k)
+			result[i * attribute_count + k] = vertex_attributes_data[i * vertex_stride_float + k] * attribute_weights[k];
+}
+
 struct Quadric
 {
 	float a00;
 	float a10, a11;
 	float a20, a21, a22;
 	float b0, b1, b2, c;
+	float w;
+};
+
+struct QuadricGrad
+{
+	float gx, gy, gz, gw;
 };
 
 struct Collapse
@@ -413,6 +439,18 @@ static void quadricAdd(Quadric& Q, const Quadric& R)
 	Q.b1 += R.b1;
 	Q.b2 += R.b2;
 	Q.c += R.c;
+	Q.w += R.w;
+}
+
+static void quadricAdd(QuadricGrad* G, const QuadricGrad* R, size_t attribute_count)
+{
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		G[k].gx += R[k].gx;
+		G[k].gy += R[k].gy;
+		G[k].gz += R[k].gz;
+		G[k].gw += R[k].gw;
+	}
 }
 
 static void quadricMul(Quadric& Q, float s)
@@ -427,6 +465,7 @@ static void quadricMul(Quadric& Q, float s)
 	Q.b1 *= s;
 	Q.b2 *= s;
 	Q.c *= s;
+	Q.w *= s;
 }
 
 static float quadricError(const Quadric& Q, const Vector3& v)
@@ -443,6 +482,29 @@ static float quadricError(const Quadric& Q, const Vector3& v)
 	return fabsf(vTQv);
 }
 
+static float quadricError(const Quadric& Q, const QuadricGrad* G, size_t attribute_count, const Vector3& v, const float* va)
+{
+	float xx = v.x * v.x;
+	float xy = v.x * v.y;
+	float xz = v.x * v.z;
+	float yy = v.y * v.y;
+	float yz = v.y * v.z;
+	float zz = v.z * v.z;
+
+	float vTQv = Q.a00 * xx + Q.a10 * xy * 2 + Q.a11 * yy + Q.a20 * xz * 2 + Q.a21 * yz * 2 + Q.a22 * zz + Q.b0 * v.x * 2 + Q.b1 * v.y * 2 + Q.b2 * v.z * 2 + Q.c;
+
+	// Q contains the quadratic terms of the gradient error (g*p + d - a)^2 for all attributes; the terms that depend on a are accumulated here
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		float a = va[k];
+		float g = G[k].gx * v.x + G[k].gy * v.y + G[k].gz * v.z + G[k].gw;
+
+		vTQv += a * a * Q.w - 2 * a * g;
+	}
+
+	return fabsf(vTQv);
+}
+
 static void quadricFromPlane(Quadric& Q, float a, float b, float c, float d)
 {
 	Q.a00 = a * a;
@@ -455,6 +517,7 @@ static void quadricFromPlane(Quadric& Q, float a, float b, float c, float d)
 	Q.b1 = d * b;
 	Q.b2 = d * c;
 	Q.c = d * d;
+	Q.w = 1;
 }
 
 static void quadricFromTriangle(Quadric& Q, const Vector3& p0, const Vector3& p1, const Vector3& p2)
@@ -490,6 +553,93 @@ static void quadricFromTriangleEdge(Quadric& Q, const Vector3& p0, const Vector3
 	quadricMul(Q, length * length * weight);
 }
 
+static void quadricFromAttributes(Quadric& Q, QuadricGrad* G, const Vector3& p0, const Vector3& p1, const Vector3& p2, const float* va0, const float* va1, const float* va2, size_t attribute_count)
+{
+	Vector3 p10 = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+	Vector3 p20 = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+
+	Vector3 normal = {p10.y * p20.z - p10.z * p20.y, p10.z * p20.x - p10.x * p20.z, p10.x * p20.y - p10.y * p20.x};
+	float area = normalize(normal);
+
+	// attribute gradients in the triangle plane are found by solving the 2x2 system built from the triangle edges
+	float a = p10.x * p10.x + p10.y * p10.y + p10.z * p10.z;
+	float b = p10.x * p20.x + p10.y * p20.y + p10.z * p20.z;
+	float c = p20.x * p20.x + p20.y * p20.y + p20.z * p20.z;
+	float det = a * c - b * b;
+	float invdet = det == 0 ? 0 : 1 / det;
+
+	memset(&Q, 0, sizeof(Q));
+
+	for (size_t k = 0; k < attribute_count; ++k)
+	{
+		float a0 = va0[k], a1 = va1[k], a2 = va2[k];
+
+		float w1 = (c * (a1 - a0) - b * (a2 - a0)) * invdet;
+		float w2 = (a * (a2 - a0) - b * (a1 - a0)) * invdet;
+
+		// attribute is approximated as g*p + d over the triangle
+		float gx = p10.x * w1 + p20.x * w2;
+		float gy = p10.y * w1 + p20.y * w2;
+		float gz = p10.z * w1 + p20.z * w2;
+		float gd = a0 - (gx * p0.x + gy * p0.y + gz * p0.z);
+
+		// quadratic part of (g*p + d)^2 has the same form as a plane quadric; the terms that depend on the attribute value are stored separately
+		Quadric R;
+		quadricFromPlane(R, gx, gy, gz, gd);
+		R.w = 0;
+
+		quadricAdd(Q, R);
+
+		G[k].gx = gx * area;
+		G[k].gy = gy * area;
+		G[k].gz = gz * area;
+		G[k].gw = gd * area;
+	}
+
+	Q.w = 1;
+
+	quadricMul(Q, area);
+}
+
+static void fillAttributeQuadrics(Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const float* vertex_attributes, size_t attribute_count)
+{
+	QuadricGrad G[kMaxAttributes];
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int i0 = indices[i + 0];
+		unsigned int i1 = indices[i + 1];
+		unsigned int i2 = indices[i + 2];
+
+		Quadric QA;
+		quadricFromAttributes(QA, G, vertex_positions[i0], vertex_positions[i1], vertex_positions[i2], &vertex_attributes[i0 * attribute_count], &vertex_attributes[i1 * attribute_count], &vertex_attributes[i2 * attribute_count], attribute_count);
+
+		// note: unlike position quadrics, attribute quadrics aren't remapped since attributes differ between wedges
+		quadricAdd(attribute_quadrics[i0], QA);
+		quadricAdd(attribute_quadrics[i1], QA);
+		quadricAdd(attribute_quadrics[i2], QA);
+
+		quadricAdd(&attribute_gradients[i0 * attribute_count], G, attribute_count);
+		quadricAdd(&attribute_gradients[i1 * attribute_count], G, attribute_count);
+		quadricAdd(&attribute_gradients[i2 * attribute_count], G, attribute_count);
+	}
+}
+
+static float getAttributeError(const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, const float* vertex_attributes, size_t attribute_count, const Vector3* vertex_positions, const unsigned int* wedge, const unsigned char* vertex_kind, unsigned int i0, unsigned int i1)
+{
+	float error = quadricError(attribute_quadrics[i0], &attribute_gradients[i0 * attribute_count], attribute_count, vertex_positions[i1], &vertex_attributes[i1 * attribute_count]);
+
+	// seam collapses also move the other wedge of i0 onto the other wedge of i1, see performEdgeCollapses
+	if (vertex_kind[i0] == Kind_Seam)
+	{
+		unsigned int s0 = wedge[i0], s1 = wedge[i1];
+
+		error += quadricError(attribute_quadrics[s0], &attribute_gradients[s0 * attribute_count], attribute_count, vertex_positions[s1], &vertex_attributes[s1 * attribute_count]);
+	}
+
+	return error;
+}
+
 static void fillFaceQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const unsigned int* remap)
 {
 	for (size_t i = 0; i < index_count; i += 3)
@@ -551,7 +701,7 @@ static size_t fillEdgeQuadrics(Quadric* vertex_quadrics, const unsigned int* ind
 	return boundary;
 }
 
-static size_t fillEdgeCollapses(Collapse* collapses, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const Quadric* vertex_quadrics, const unsigned int* remap, const unsigned char* vertex_kind)
+static size_t fillEdgeCollapses(Collapse* collapses, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const Quadric* vertex_quadrics, const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, const float* vertex_attributes, size_t attribute_count, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind)
 {
 	size_t collapse_count = 0;
 
@@ -582,6 +732,13 @@ static size_t fillEdgeCollapses(Collapse* collapses, const unsigned int* indices
 				// if vertex kinds match, we can collapse the edge in either direction - pick the one with minimum error
 				Collapse c01 = {i0, i1, {quadricError(vertex_quadrics[remap[i0]], vertex_positions[i1])}};
 				Collapse c10 = {i1, i0, {quadricError(vertex_quadrics[remap[i1]], vertex_positions[i0])}};
+
+				if (attribute_count)
+				{
+					c01.error += getAttributeError(attribute_quadrics, attribute_gradients, vertex_attributes, attribute_count, vertex_positions, wedge, vertex_kind, i0, i1);
+					c10.error += getAttributeError(attribute_quadrics, attribute_gradients, vertex_attributes, attribute_count, vertex_positions, wedge, vertex_kind, i1, i0);
+				}
+
 				Collapse c = c01.error <= c10.error ? c01 : c10;
 				assert(c.error >= 0);
 
@@ -591,6 +748,10 @@ static size_t fillEdgeCollapses(Collapse* collapses, const unsigned int* indices
 			{
 				// if vertex kinds are different, edge can only be collapsed in one direction
 				Collapse c = {i0, i1, {quadricError(vertex_quadrics[remap[i0]], vertex_positions[i1])}};
+
+				if (attribute_count)
+					c.error += getAttributeError(attribute_quadrics, attribute_gradients, vertex_attributes, attribute_count, vertex_positions, wedge, vertex_kind, i0, i1);
+
 				assert(c.error >= 0);
 
 				collapses[collapse_count++] = c;
@@ -638,7 +799,7 @@ static void sortEdgeCollapses(unsigned int* sort_order, const Collapse* collapse
 	}
 }
 
-static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char* collapse_locked, Quadric* vertex_quadrics, const Collapse* collapses, size_t collapse_count, const unsigned int* collapse_order, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, size_t collapse_limit, float error_limit, float& pass_error)
+static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char* collapse_locked, Quadric* vertex_quadrics, Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, size_t attribute_count, const Collapse* collapses, size_t collapse_count, const unsigned int* collapse_order, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, size_t collapse_limit, float error_limit, float& pass_error)
 {
 	size_t pass_collapses = 0;
 
@@ -671,12 +832,27 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 
 			collapse_remap[c.v0] = c.v1;
 			collapse_remap[s0] = s1;
+
+			if (attribute_count)
+			{
+				quadricAdd(attribute_quadrics[c.v1], attribute_quadrics[c.v0]);
+				quadricAdd(&attribute_gradients[c.v1 * attribute_count], &attribute_gradients[c.v0 * attribute_count], attribute_count);
+
+				quadricAdd(attribute_quadrics[s1], attribute_quadrics[s0]);
+				quadricAdd(&attribute_gradients[s1 * attribute_count], &attribute_gradients[s0 * attribute_count], attribute_count);
+			}
 		}
 		else
 		{
 			assert(wedge[c.v0] == c.v0);
 
 			collapse_remap[c.v0] = c.v1;
+
+			if (attribute_count)
+			{
+				quadricAdd(attribute_quadrics[c.v1], attribute_quadrics[c.v0]);
+				quadricAdd(&attribute_gradients[c.v1 * attribute_count], &attribute_gradients[c.v0 * attribute_count], attribute_count);
+			}
 		}
 
 		collapse_locked[r0] = 1;
@@ -719,22 +895,498 @@ static size_t remapIndexBuffer(unsigned int* indices, size_t index_count, const
 	return write;
 }
 
+
+struct CollapseHeap
+{
+	meshopt_Buffer<unsigned int> heap;   // vertex in each heap slot
+	meshopt_Buffer<unsigned int> slots;  // heap slot of each vertex, ~0u if the vertex isn't in the heap
+	meshopt_Buffer<float> errors;        // error of the best collapse of each vertex
+	meshopt_Buffer<unsigned int> targets; // target of the best collapse of each vertex
+	size_t size;
+
+	explicit CollapseHeap(size_t vertex_count)
+	    : heap(vertex_count)
+	    , slots(vertex_count)
+	    , errors(vertex_count)
+	    , targets(vertex_count)
+	    , size(0)
+	{
+		memset(slots.data, -1, vertex_count * sizeof(unsigned int));
+	}
+};
+
+static void heapMove(CollapseHeap& heap, size_t slot, unsigned int v)
+{
+	heap.heap[slot] = v;
+	heap.slots[v] = unsigned(slot);
+}
+
+static void heapSiftUp(CollapseHeap& heap, size_t slot)
+{
+	unsigned int v = heap.heap[slot];
+	float error = heap.errors[v];
+
+	while (slot > 0)
+	{
+		size_t parent = (slot - 1) / 2;
+
+		if (heap.errors[heap.heap[parent]] <= error)
+			break;
+
+		heapMove(heap, slot, heap.heap[parent]);
+		slot = parent;
+	}
+
+	heapMove(heap, slot, v);
+}
+
+static void heapSiftDown(CollapseHeap& heap, size_t slot)
+{
+	unsigned int v = heap.heap[slot];
+	float error = heap.errors[v];
+
+	for (;;)
+	{
+		size_t child = slot * 2 + 1;
+
+		if (child >= heap.size)
+			break;
+
+		if (child + 1 < heap.size && heap.errors[heap.heap[child + 1]] < heap.errors[heap.heap[child]])
+			child++;
+
+		if (error <= heap.errors[heap.heap[child]])
+			break;
+
+		heapMove(heap, slot, heap.heap[child]);
+		slot = child;
+	}
+
+	heapMove(heap, slot, v);
+}
+
+static void heapRemove(CollapseHeap& heap, unsigned int v)
+{
+	unsigned int slot = heap.slots[v];
+
+	if (slot == ~0u)
+		return;
+
+	heap.slots[v] = ~0u;
+	heap.size--;
+
+	if (slot < heap.size)
+	{
+		unsigned int last = heap.heap[heap.size];
+
+		heapMove(heap, slot, last);
+		heapSiftUp(heap, slot);
+		heapSiftDown(heap, heap.slots[last]);
+	}
+}
+
+static void heapUpdate(CollapseHeap& heap, unsigned int v, unsigned int target, float error)
+{
+	float old_error = heap.errors[v];
+
+	heap.errors[v] = error;
+	heap.targets[v] = target;
+
+	if (heap.slots[v] == ~0u)
+	{
+		heapMove(heap, heap.size++, v);
+		heapSiftUp(heap, heap.size - 1);
+	}
+	else if (error < old_error)
+		heapSiftUp(heap, heap.slots[v]);
+	else
+		heapSiftDown(heap, heap.slots[v]);
+}
+
+struct CollapseContext
+{
+	unsigned int* indices;
+	unsigned char* triangle_dead;
+
+	// each vertex has a singly linked list of corners that reference it; lists are spliced together on collapse
+	unsigned int* corner_next;
+	unsigned int* corner_first;
+	unsigned int* corner_last;
+
+	const Vector3* vertex_positions;
+	Quadric* vertex_quadrics;
+	Quadric* attribute_quadrics;
+	QuadricGrad* attribute_gradients;
+	const float* vertex_attributes;
+	size_t attribute_count;
+
+	const unsigned int* remap;
+	const unsigned int* wedge;
+	const unsigned char* vertex_kind;
+};
+
+static float getCollapseError(const CollapseContext& context, unsigned int v0, unsigned int v1)
+{
+	float error = quadricError(context.vertex_quadrics[context.remap[v0]], context.vertex_positions[v1]);
+
+	if (context.attribute_count)
+		error += getAttributeError(context.attribute_quadrics, context.attribute_gradients, context.vertex_attributes, context.attribute_count, context.vertex_positions, context.wedge, context.vertex_kind, v0, v1);
+
+	return error;
+}
+
+// finds the cheapest collapse of v and updates the heap; when only is not ~0u, just the edges to vertices at position only are evaluated and compete with the scheduled collapse
+static void updateVertexCollapse(CollapseHeap& heap, const CollapseContext& context, unsigned int v, unsigned int only)
+{
+	assert(context.remap[v] == v);
+
+	bool scheduled = only != ~0u && heap.slots[v] != ~0u;
+
+	float best_error = scheduled ? heap.errors[v] : FLT_MAX;
+	unsigned int best_target = scheduled ? heap.targets[v] : ~0u;
+
+	// seam vertices move together with their wedge pair; edges of the other wedge are expressed as collapses of v via the wedge of the target
+	unsigned int w = v;
+
+	do
+	{
+		for (unsigned int corner = context.corner_first[w]; corner != ~0u; corner = context.corner_next[corner])
+		{
+			unsigned int triangle = corner / 3;
+
+			if (context.triangle_dead[triangle])
+				continue;
+
+			for (unsigned int k = 1; k < 3; ++k)
+			{
+				unsigned int o = context.indices[triangle * 3 + (corner % 3 + k) % 3];
+
+				if (context.remap[o] == context.remap[w])
+					continue;
+
+				if (only != ~0u && context.remap[o] != only)
+					continue;
+
+				if (!kCanCollapse[context.vertex_kind[w]][context.vertex_kind[o]])
+					continue;
+
+				unsigned int target = (w == v) ? o : context.wedge[o];
+				float error = getCollapseError(context, v, target);
+
+				if (error < best_error)
+				{
+					best_error = error;
+					best_target = target;
+				}
+			}
+		}
+
+		w = context.wedge[w];
+	} while (w != v && context.vertex_kind[v] == Kind_Seam);
+
+	if (best_target == ~0u)
+		heapRemove(heap, v);
+	else
+		heapUpdate(heap, v, best_target, best_error);
+}
+
+static size_t collapseVertex(CollapseContext& context, unsigned int v0, unsigned int v1)
+{
+	size_t removed = 0;
+
+	for (unsigned int corner = context.corner_first[v0]; corner != ~0u; corner = context.corner_next[corner])
+	{
+		unsigned int triangle = corner / 3;
+
+		if (context.triangle_dead[triangle])
+			continue;
+
+		context.indices[corner] = v1;
+
+		unsigned int a = context.indices[triangle * 3 + 0], b = context.indices[triangle * 3 + 1], c = context.indices[triangle * 3 + 2];
+
+		if (a == b || a == c || b == c)
+		{
+			context.triangle_dead[triangle] = 1;
+			removed++;
+		}
+	}
+
+	if (context.corner_first[v0] != ~0u)
+	{
+		if (context.corner_first[v1] == ~0u)
+			context.corner_first[v1] = context.corner_first[v0];
+		else
+			context.corner_next[context.corner_last[v1]] = context.corner_first[v0];
+
+		context.corner_last[v1] = context.corner_last[v0];
+		context.corner_first[v0] = context.corner_last[v0] = ~0u;
+	}
+
+	return removed;
+}
+
+static void pruneCorners(CollapseContext& context, unsigned int v)
+{
+	// collapses splice corner lists together, so dead corners would otherwise accumulate and slow down future traversals
+	unsigned int last = ~0u;
+
+	for (unsigned int corner = context.corner_first[v]; corner != ~0u; corner = context.corner_next[corner])
+	{
+		if (context.triangle_dead[corner / 3])
+			continue;
+
+		if (last == ~0u)
+			context.corner_first[v] = corner;
+		else
+			context.corner_next[last] = corner;
+
+		last = corner;
+	}
+
+	if (last == ~0u)
+		context.corner_first[v] = ~0u;
+	else
+		context.corner_next[last] = ~0u;
+
+	context.corner_last[v] = last;
+}
+
+static size_t gatherNeighbors(const CollapseContext& context, unsigned int v, unsigned int* neighbors, unsigned char* neighbor_marks)
+{
+	size_t neighbor_count = 0;
+	unsigned int w = v;
+
+	do
+	{
+		for (unsigned int corner = context.corner_first[w]; corner != ~0u; corner = context.corner_next[corner])
+		{
+			unsigned int triangle = corner / 3;
+
+			if (context.triangle_dead[triangle])
+				continue;
+
+			for (unsigned int k = 0; k < 3; ++k)
+			{
+				unsigned int r = context.remap[context.indices[triangle * 3 + k]];
+
+				if (!neighbor_marks[r] && context.vertex_kind[r] != Kind_Locked)
+				{
+					neighbor_marks[r] = 1;
+					neighbors[neighbor_count++] = r;
+				}
+			}
+		}
+
+		w = context.wedge[w];
+	} while (w != v && context.vertex_kind[v] == Kind_Seam);
+
+	return neighbor_count;
+}
+
+static void buildCorners(CollapseContext& context, size_t index_count, size_t vertex_count)
+{
+	memset(context.triangle_dead, 0, index_count / 3);
+	memset(context.corner_first, -1, vertex_count * sizeof(unsigned int));
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int v = context.indices[i];
+
+		context.corner_next[i] = ~0u;
+
+		if (context.corner_first[v] == ~0u)
+			context.corner_first[v] = unsigned(i);
+		else
+			context.corner_next[context.corner_last[v]] = unsigned(i);
+
+		context.corner_last[v] = unsigned(i);
+	}
+}
+
+static size_t performHeapCollapses(unsigned int* destination, size_t* lod_index_counts, float* lod_errors, unsigned int* indices, size_t index_count, size_t vertex_count, CollapseContext& context, const size_t* target_index_counts, const float* target_errors, size_t lod_count)
+{
+	size_t triangle_count = index_count / 3;
+
+	meshopt_Buffer<unsigned char> triangle_dead(triangle_count);
+	meshopt_Buffer<unsigned int> corner_next(index_count);
+	meshopt_Buffer<unsigned int> corner_first(vertex_count);
+	meshopt_Buffer<unsigned int> corner_last(vertex_count);
+
+	context.indices = indices;
+	context.triangle_dead = triangle_dead.data;
+	context.corner_next = corner_next.data;
+	context.corner_first = corner_first.data;
+	context.corner_last = corner_last.data;
+
+	buildCorners(context, index_count, vertex_count);
+
+	CollapseHeap heap(vertex_count);
+
+	// only canonical vertices of each position are scheduled; other wedges move with them
+	for (size_t i = 0; i < vertex_count; ++i)
+		if (context.remap[i] == i && corner_first[i] != ~0u && context.vertex_kind[i] != Kind_Locked)
+			updateVertexCollapse(heap, context, unsigned(i), ~0u);
+
+	meshopt_Buffer<unsigned int> neighbors(vertex_count);
+	meshopt_Buffer<unsigned char> neighbor_marks(vertex_count);
+	memset(neighbor_marks.data, 0, vertex_count);
+
+	size_t live_count = triangle_count;
+	size_t result_offset = 0;
+	float worst_error = 0;
+
+	for (size_t lod = 0; lod < lod_count; ++lod)
+	{
+		size_t target_index_count = target_index_counts ? target_index_counts[lod] : 0;
+		float target_error = target_errors ? target_errors[lod] : FLT_MAX;
+
+		size_t pops = 0;
+		size_t collapses = 0;
+
+		while (live_count * 3 > target_index_count && heap.size > 0)
+		{
+			unsigned int v0 = heap.heap[0];
+			unsigned int v1 = heap.targets[v0];
+			float error = heap.errors[v0];
+
+			if (error > target_error)
+				break;
+
+			heapRemove(heap, v0);
+			pops++;
+
+			size_t neighbor_count = gatherNeighbors(context, v0, neighbors.data, neighbor_marks.data);
+
+			unsigned int r0 = context.remap[v0];
+			unsigned int r1 = context.remap[v1];
+
+			quadricAdd(context.vertex_quadrics[r1], context.vertex_quadrics[r0]);
+
+			if (context.attribute_count)
+			{
+				unsigned int w0 = v0, w1 = v1;
+
+				do
+				{
+					quadricAdd(context.attribute_quadrics[w1], context.attribute_quadrics[w0]);
+					quadricAdd(&context.attribute_gradients[w1 * context.attribute_count], &context.attribute_gradients[w0 * context.attribute_count], context.attribute_count);
+
+					w0 = context.wedge[w0], w1 = context.wedge[w1];
+				} while (w0 != v0 && context.vertex_kind[v0] == Kind_Seam);
+			}
+
+			if (context.vertex_kind[v0] == Kind_Seam)
+			{
+				// remap v0 to v1 and seam pair of v0 to seam pair of v1
+				unsigned int s0 = context.wedge[v0];
+				unsigned int s1 = context.wedge[v1];
+
+				assert(s0 != v0 && s1 != v1);
+
+				live_count -= collapseVertex(context, v0, v1);
+				live_count -= collapseVertex(context, s0, s1);
+				collapses += 2;
+
+				pruneCorners(context, s1);
+			}
+			else
+			{
+				assert(context.wedge[v0] == v0);
+
+				live_count -= collapseVertex(context, v0, v1);
+				collapses++;
+			}
+
+			pruneCorners(context, v1);
+
+			worst_error = (worst_error < error) ? error : worst_error;
+
+			// v1 inherited the edges of v0, so only neighbors of v0 and v1 itself have different collapse options now
+			// collapse errors only depend on the quadrics of the collapsed vertex, so unless a neighbor is r1 or targets a vertex that lost edges, its scheduled collapse stays valid and only edges to r1 are new
+			for (size_t i = 0; i < neighbor_count; ++i)
+			{
+				unsigned int n = neighbors[i];
+
+				neighbor_marks[n] = 0;
+
+				if (n == v0)
+					continue;
+
+				unsigned int target = heap.slots[n] == ~0u ? ~0u : context.remap[heap.targets[n]];
+				bool stale = n == r1 || target == r0 || target == r1;
+
+				updateVertexCollapse(heap, context, n, stale ? ~0u : r1);
+			}
+		}
+
+		// compact live triangles in place; subsequent levels traverse fewer triangles and get better locality as a result
+		size_t write = 0;
+
+		for (size_t i = 0; i < triangle_count; ++i)
+			if (!triangle_dead[i])
+			{
+				indices[write + 0] = indices[i * 3 + 0];
+				indices[write + 1] = indices[i * 3 + 1];
+				indices[write + 2] = indices[i * 3 + 2];
+				write += 3;
+			}
+
+		if (indices != destination + result_offset)
+			memcpy(destination + result_offset, indices, write * sizeof(unsigned int));
+
+#if TRACE
+		printf("priority queue: triangles: %d, error: %e\n", int(write / 3), worst_error);
+#endif
+
+		meshopt_Instrumentation<void>::report("simplify", "collapse", write / 3, pops, collapses);
+
+		if (lod + 1 < lod_count && write < triangle_count * 3)
+		{
+			triangle_count = write / 3;
+			buildCorners(context, write, vertex_count);
+		}
+
+		lod_index_counts[lod] = write;
+		lod_errors[lod] = worst_error;
+		result_offset += write;
+	}
+
+	return result_offset;
+}
+
 } // namespace meshopt
 
 // TODO: this is necessary for lodviewer but will go away at some point
 unsigned char* meshopt_simplifyDebugKind = 0;
 
-size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error)
+static size_t simplifyLods(unsigned int* destination, size_t* lod_index_counts, float* lod_errors, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options, int partition_mode)
 {
 	using namespace meshopt;
 
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
-	assert(target_index_count <= index_count);
+	assert(vertex_attributes_stride % sizeof(float) == 0);
+	assert(attribute_count <= kMaxAttributes);
+	assert(attribute_count * sizeof(float) <= vertex_attributes_stride || attribute_count == 0);
+	assert(lod_count > 0);
+
+	for (size_t i = 0; i < lod_count; ++i)
+		assert(!target_index_counts || target_index_counts[i] <= index_count);
 
+	meshopt_Instrumentation<void>::report("simplify", "start", index_count / 3);
+
+	// a single level can be simplified in place; a chain continues simplification in scratch memory and copies each level out
+	meshopt_Buffer<unsigned int> scratch;
 	unsigned int* result = destination;
 
+	if (lod_count > 1)
+	{
+		scratch.allocate(index_count);
+		result = scratch.data;
+	}
+
 	// build adjacency information
 	EdgeAdjacency adjacency(index_count, vertex_count);
 	buildEdgeAdjacency(adjacency, indices, index_count, vertex_count);
@@ -744,6 +1396,8 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	meshopt_Buffer<unsigned int> wedge(vertex_count);
 	buildPositionRemap(remap.data, wedge.data, vertex_positions_data, vertex_count, vertex_positions_stride);
 
+	meshopt_Instrumentation<void>::report("simplify", "adjacency", index_count / 3);
+
 	// TODO: maybe make this an option? this disables seam awareness
 	// for (size_t i = 0; i < vertex_count; ++i) remap[i] = wedge[i] = unsigned(i);
 
@@ -753,7 +1407,33 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	meshopt_Buffer<unsigned char> vertex_kind(vertex_count);
 	classifyVertices(vertex_kind.data, vertex_count, adjacency, remap.data, wedge.data, lockedstats);
 
-	if (meshopt_simplifyDebugKind)
+	// cuts between partitions of meshopt_simplifyParallel are classified as borders; they must stay in place so that the partitions still match
+	size_t partition_target = 0;
+
+	if (partition_mode == Partition_Cut)
+	{
+		assert(lod_count == 1 && target_index_counts);
+
+		size_t cut_vertices = 0;
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			if (vertex_kind[i] == Kind_Border)
+			{
+				vertex_kind[i] = Kind_Locked;
+				cut_vertices++;
+			}
+
+		// locked vertices keep at least one triangle each, so the target is extended to leave the same budget for the rest of the partition
+		partition_target = target_index_counts[0] + cut_vertices * 3;
+		partition_target = partition_target < index_count ? partition_target : index_count;
+
+		target_index_counts = &partition_target;
+	}
+
+	meshopt_Instrumentation<void>::report("simplify", "classify", index_count / 3);
+
+	// partitions use their own vertex numbering and may be simplified concurrently
+	if (meshopt_simplifyDebugKind && partition_mode == Partition_None)
 		memcpy(meshopt_simplifyDebugKind, vertex_kind.data, vertex_count);
 
 #if TRACE
@@ -781,6 +1461,24 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 
 	fillFaceQuadrics(vertex_quadrics.data, indices, index_count, vertex_positions.data, remap.data);
 
+	meshopt_Buffer<float> vertex_attributes;
+	meshopt_Buffer<Quadric> attribute_quadrics;
+	meshopt_Buffer<QuadricGrad> attribute_gradients;
+
+	if (attribute_count)
+	{
+		vertex_attributes.allocate(vertex_count * attribute_count);
+		rescaleAttributes(vertex_attributes.data, vertex_attributes_data, vertex_count, vertex_attributes_stride, attribute_weights, attribute_count);
+
+		attribute_quadrics.allocate(vertex_count);
+		memset(attribute_quadrics.data, 0, vertex_count * sizeof(Quadric));
+
+		attribute_gradients.allocate(vertex_count * attribute_count);
+		memset(attribute_gradients.data, 0, vertex_count * attribute_count * sizeof(QuadricGrad));
+
+		fillAttributeQuadrics(attribute_quadrics.data, attribute_gradients.data, indices, index_count, vertex_positions.data, vertex_attributes.data, attribute_count);
+	}
+
 	size_t boundary = fillEdgeQuadrics(vertex_quadrics.data, indices, index_count, vertex_positions.data, remap.data, vertex_kind.data, adjacency);
 	(void)boundary;
 
@@ -788,9 +1486,27 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	printf("vertices: %d, half-edges: %d, boundary: %d\n", int(vertex_count), int(index_count), int(boundary));
 #endif
 
+	meshopt_Instrumentation<void>::report("simplify", "quadrics", index_count / 3);
+
 	if (result != indices)
 		memcpy(result, indices, index_count * sizeof(unsigned int));
 
+	if (options & meshopt_SimplifyPriorityQueue)
+	{
+		CollapseContext context = {};
+		context.vertex_positions = vertex_positions.data;
+		context.vertex_quadrics = vertex_quadrics.data;
+		context.attribute_quadrics = attribute_quadrics.data;
+		context.attribute_gradients = attribute_gradients.data;
+		context.vertex_attributes = vertex_attributes.data;
+		context.attribute_count = attribute_count;
+		context.remap = remap.data;
+		context.wedge = wedge.data;
+		context.vertex_kind = vertex_kind.data;
+
+		return performHeapCollapses(destination, lod_index_counts, lod_errors, result, index_count, vertex_count, context, target_index_counts, target_errors, lod_count);
+	}
+
 	size_t pass_count = 0;
 	float worst_error = 0;
 
@@ -800,48 +1516,71 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 	meshopt_Buffer<unsigned char> collapse_locked(vertex_count);
 
 	size_t result_count = index_count;
+	size_t result_offset = 0;
 
-	while (result_count > target_index_count)
+	for (size_t lod = 0; lod < lod_count; ++lod)
 	{
-		size_t edge_collapse_count = fillEdgeCollapses(edge_collapses.data, result, result_count, vertex_positions.data, vertex_quadrics.data, remap.data, vertex_kind.data);
+		size_t target_index_count = target_index_counts ? target_index_counts[lod] : 0;
+		float target_error = target_errors ? target_errors[lod] : FLT_MAX;
 
-		// no edges can be collapsed any more due to topology restrictions => bail out
-		if (edge_collapse_count == 0)
-			break;
+		size_t lod_passes = 0;
+		size_t lod_collapses = 0;
+
+		// each level continues from the result of the previous level with the accumulated quadrics
+		while (result_count > target_index_count)
+		{
+			size_t edge_collapse_count = fillEdgeCollapses(edge_collapses.data, result, result_count, vertex_positions.data, vertex_quadrics.data, attribute_quadrics.data, attribute_gradients.data, vertex_attributes.data, attribute_count, remap.data, wedge.data, vertex_kind.data);
 
-		sortEdgeCollapses(collapse_order.data, edge_collapses.data, edge_collapse_count);
+			// no edges can be collapsed any more due to topology restrictions => bail out
+			if (edge_collapse_count == 0)
+				break;
 
-		// each collapse removes 2 triangles
-		// TODO: except for border collapses :) this can lead to a few small passes in the end
-		size_t edge_collapse_goal = (result_count - target_index_count) / 6 + 1;
+			sortEdgeCollapses(collapse_order.data, edge_collapses.data, edge_collapse_count);
 
-		float error_goal = edge_collapse_goal < edge_collapse_count ? edge_collapses[collapse_order[edge_collapse_goal]].error * 1.5f : FLT_MAX;
-		float error_limit = error_goal > target_error ? target_error : error_goal;
+			// each collapse removes 2 triangles
+			// TODO: except for border collapses :) this can lead to a few small passes in the end
+			size_t edge_collapse_goal = (result_count - target_index_count) / 6 + 1;
 
-		// no edges can be collapsed any more due to hitting the error limit => bail out
-		if (edge_collapses[collapse_order[0]].error > error_limit)
-			break;
+			float error_goal = edge_collapse_goal < edge_collapse_count ? edge_collapses[collapse_order[edge_collapse_goal]].error * 1.5f : FLT_MAX;
+			float error_limit = error_goal > target_error ? target_error : error_goal;
 
-		for (size_t i = 0; i < vertex_count; ++i)
-			collapse_remap[i] = unsigned(i);
+			// no edges can be collapsed any more due to hitting the error limit => bail out
+			if (edge_collapses[collapse_order[0]].error > error_limit)
+				break;
+
+			for (size_t i = 0; i < vertex_count; ++i)
+				collapse_remap[i] = unsigned(i);
 
-		memset(collapse_locked.data, 0, vertex_count);
+			memset(collapse_locked.data, 0, vertex_count);
 
-		float pass_error = 0;
-		size_t collapses = performEdgeCollapses(collapse_remap.data, collapse_locked.data, vertex_quadrics.data, edge_collapses.data, edge_collapse_count, collapse_order.data, remap.data, wedge.data, vertex_kind.data, edge_collapse_goal, error_limit, pass_error);
+			float pass_error = 0;
+			size_t collapses = performEdgeCollapses(collapse_remap.data, collapse_locked.data, vertex_quadrics.data, attribute_quadrics.data, attribute_gradients.data, attribute_count, edge_collapses.data, edge_collapse_count, collapse_order.data, remap.data, wedge.data, vertex_kind.data, edge_collapse_goal, error_limit, pass_error);
 
 #if TRACE
-		printf("pass %d: triangles: %d, collapses: %d/%d (target %d), error: %e\n", int(pass_count), int(result_count / 3), int(collapses), int(edge_collapse_count), int(edge_collapse_goal), pass_error);
+			printf("pass %d: triangles: %d, collapses: %d/%d (target %d), error: %e\n", int(pass_count), int(result_count / 3), int(collapses), int(edge_collapse_count), int(edge_collapse_goal), pass_error);
 #endif
 
-		pass_count++;
-		worst_error = (worst_error < pass_error) ? pass_error : worst_error;
+			pass_count++;
+			worst_error = (worst_error < pass_error) ? pass_error : worst_error;
 
-		// no edges can be collapsed any more => bail out
-		if (collapses == 0)
-			break;
+			lod_passes++;
+			lod_collapses += collapses;
+
+			// no edges can be collapsed any more => bail out
+			if (collapses == 0)
+				break;
+
+			result_count = remapIndexBuffer(result, result_count, collapse_remap.data);
+		}
 
-		result_count = remapIndexBuffer(result, result_count, collapse_remap.data);
+		if (result != destination + result_offset)
+			memcpy(destination + result_offset, result, result_count * sizeof(unsigned int));
+
+		lod_index_counts[lod] = result_count;
+		lod_errors[lod] = worst_error;
+		result_offset += result_count;
+
+		meshopt_Instrumentation<void>::report("simplify", "collapse", result_count / 3, lod_passes, lod_collapses);
 	}
 
 #if TRACE
@@ -871,5 +1610,294 @@ size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices,
 				printf("locked collapses %d -> %d: %d\n", k0, k1, int(locked_collapses[k0][k1]));
 #endif
 
-	return result_count;
+	return result_offset;
+}
+
+struct SimplifyPartition
+{
+	size_t face_begin;
+	size_t face_end;
+
+	size_t target_index_count;
+	size_t result_count;
+};
+
+struct SimplifyPartitionData
+{
+	SimplifyPartition* partitions;
+
+	// triangles of each partition are order[face_begin..face_end) of source indices, or [face_begin..face_end) if order is NULL
+	const unsigned int* indices;
+	const unsigned int* order;
+
+	// each partition uses the index range [face_begin * 3..face_end * 3) of these as its local index buffer and vertex list
+	unsigned int* partition_indices;
+	unsigned int* partition_vertices;
+
+	const float* vertex_positions_data;
+	size_t vertex_positions_stride;
+
+	float target_error;
+	unsigned int options;
+	int partition_mode;
+};
+
+static unsigned int spreadBits10(unsigned int v)
+{
+	// inserts two 0 bits between each bit of a 10-bit value
+	v &= 0x3ff;
+	v = (v | (v << 16)) & 0x030000ff;
+	v = (v | (v << 8)) & 0x0300f00f;
+	v = (v | (v << 4)) & 0x030c30c3;
+	v = (v | (v << 2)) & 0x09249249;
+
+	return v;
+}
+
+static void sortTrianglesSpatially(unsigned int* order, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
+{
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+	size_t face_count = index_count / 3;
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = vertex_positions_data + i * vertex_stride_float;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			minv[j] = minv[j] > v[j] ? v[j] : minv[j];
+			maxv[j] = maxv[j] < v[j] ? v[j] : maxv[j];
+		}
+	}
+
+	float extent = 0.f;
+
+	extent = (maxv[0] - minv[0]) < extent ? extent : (maxv[0] - minv[0]);
+	extent = (maxv[1] - minv[1]) < extent ? extent : (maxv[1] - minv[1]);
+	extent = (maxv[2] - minv[2]) < extent ? extent : (maxv[2] - minv[2]);
+
+	// centroids are quantized to a 1024^3 grid; the sum of 3 coordinates needs to be divided by 3 as well
+	float scale = extent == 0 ? 0.f : 1023.f / (extent * 3);
+
+	meshopt_Buffer<unsigned int> keys(face_count);
+
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		unsigned int key = 0;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			float c = vertex_positions_data[indices[i * 3 + 0] * vertex_stride_float + j] + vertex_positions_data[indices[i * 3 + 1] * vertex_stride_float + j] + vertex_positions_data[indices[i * 3 + 2] * vertex_stride_float + j];
+
+			key |= spreadBits10(unsigned(int((c - minv[j] * 3) * scale + 0.5f))) << j;
+		}
+
+		keys[i] = key;
+	}
+
+	// partitions only need coarse spatial order, so we sort by the top 20 bits of the 30-bit Morton code (a 128^3 grid) in 2 radix passes
+	// keys are permuted together with faces to keep memory accesses sequential
+	meshopt_Buffer<unsigned int> scratch(face_count);
+	meshopt_Buffer<unsigned int> scratch_keys(face_count);
+
+	for (size_t i = 0; i < face_count; ++i)
+		order[i] = unsigned(i);
+
+	unsigned int* source = order;
+	unsigned int* source_keys = keys.data;
+	unsigned int* target = scratch.data;
+	unsigned int* target_keys = scratch_keys.data;
+
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		int shift = 10 + pass * 10;
+
+		unsigned int histogram[1024];
+		memset(histogram, 0, sizeof(histogram));
+
+		for (size_t i = 0; i < face_count; ++i)
+			histogram[(source_keys[i] >> shift) & 1023]++;
+
+		unsigned int histogram_sum = 0;
+
+		for (size_t i = 0; i < 1024; ++i)
+		{
+			unsigned int count = histogram[i];
+			histogram[i] = histogram_sum;
+			histogram_sum += count;
+		}
+
+		for (size_t i = 0; i < face_count; ++i)
+		{
+			unsigned int key = source_keys[i];
+			unsigned int slot = histogram[(key >> shift) & 1023]++;
+
+			target[slot] = source[i];
+			target_keys[slot] = key;
+		}
+
+		unsigned int* temp = source;
+		source = target;
+		target = temp;
+
+		temp = source_keys;
+		source_keys = target_keys;
+		target_keys = temp;
+	}
+
+	// even number of passes leaves the result in order
+	assert(source == order);
+}
+
+static void simplifyPartition(void* task_data, size_t index)
+{
+	using namespace meshopt;
+
+	SimplifyPartitionData& data = *static_cast<SimplifyPartitionData*>(task_data);
+	SimplifyPartition& partition = data.partitions[index];
+
+	size_t index_offset = partition.face_begin * 3;
+	size_t index_count = (partition.face_end - partition.face_begin) * 3;
+
+	unsigned int* indices = data.partition_indices + index_offset;
+	unsigned int* vertices = data.partition_vertices + index_offset;
+
+	size_t vertex_count = buildLocalVertices(indices, vertices, data.indices, data.order, partition.face_begin, partition.face_end);
+
+	size_t vertex_stride_float = data.vertex_positions_stride / sizeof(float);
+
+	meshopt_Buffer<float> vertex_positions(vertex_count * 3);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = data.vertex_positions_data + vertices[i] * vertex_stride_float;
+
+		vertex_positions[i * 3 + 0] = v[0];
+		vertex_positions[i * 3 + 1] = v[1];
+		vertex_positions[i * 3 + 2] = v[2];
+	}
+
+	size_t lod_index_count = 0;
+	float lod_error = 0;
+
+	partition.result_count = simplifyLods(indices, &lod_index_count, &lod_error, indices, index_count, vertex_positions.data, vertex_count, sizeof(float) * 3, 0, 0, 0, 0, &partition.target_index_count, &data.target_error, 1, data.options, data.partition_mode);
+
+	// convert the result back to original vertex indices
+	for (size_t i = 0; i < partition.result_count; ++i)
+		indices[i] = vertices[indices[i]];
+}
+
+size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error)
+{
+	return meshopt_simplifyWithAttributes(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, 0, 0, 0, 0, target_index_count, target_error, 0);
+}
+
+size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t target_index_count, float target_error, unsigned int options)
+{
+	using namespace meshopt;
+
+	size_t lod_index_count = 0;
+	float lod_error = 0;
+
+	return simplifyLods(destination, &lod_index_count, &lod_error, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, &target_index_count, &target_error, 1, options, Partition_None);
+}
+
+size_t meshopt_simplifyLodChain(unsigned int* destination, size_t* lod_index_counts, float* lod_errors, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options)
+{
+	using namespace meshopt;
+
+	return simplifyLods(destination, lod_index_counts, lod_errors, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, target_index_counts, target_errors, lod_count, options, Partition_None);
+}
+
+size_t meshopt_simplifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, unsigned int options, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride > 0 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(target_index_count <= index_count);
+
+	size_t face_count = index_count / 3;
+
+	// small partitions lock too many vertices on their borders and don't have enough work to amortize the setup cost
+	const size_t kMinPartitionFaces = 4096;
+
+	if (partition_count > face_count / kMinPartitionFaces)
+		partition_count = face_count / kMinPartitionFaces;
+
+	if (partition_count <= 1)
+		return meshopt_simplifyWithAttributes(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, 0, 0, 0, 0, target_index_count, target_error, options);
+
+	// split the mesh into partitions with the same number of triangles that are close in space
+	meshopt_Buffer<unsigned int> order(face_count);
+	sortTrianglesSpatially(order.data, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride);
+
+	meshopt_Buffer<SimplifyPartition> partitions(partition_count + 1);
+
+	for (size_t i = 0; i < partition_count; ++i)
+	{
+		SimplifyPartition& partition = partitions[i];
+
+		partition.face_begin = i * face_count / partition_count;
+		partition.face_end = (i + 1) * face_count / partition_count;
+
+		// each partition gets its share of the target; simplifyLods extends it to account for the cut vertices, which are left to the stitching pass
+		size_t partition_index_count = (partition.face_end - partition.face_begin) * 3;
+
+		partition.target_index_count = size_t(double(target_index_count) * double(partition_index_count) / double(index_count)) / 3 * 3;
+		partition.result_count = 0;
+	}
+
+	meshopt_Buffer<unsigned int> partition_indices(index_count);
+	meshopt_Buffer<unsigned int> partition_vertices(index_count);
+
+	SimplifyPartitionData data = {};
+	data.partitions = partitions.data;
+	data.indices = indices;
+	data.order = order.data;
+	data.partition_indices = partition_indices.data;
+	data.partition_vertices = partition_vertices.data;
+	data.vertex_positions_data = vertex_positions_data;
+	data.vertex_positions_stride = vertex_positions_stride;
+	data.target_error = target_error;
+	data.options = options;
+	data.partition_mode = Partition_Cut;
+
+	runTasks(parallel_for, context, simplifyPartition, &data, partition_count);
+
+	// gather the results; destination can alias indices which are no longer needed at this point
+	size_t result_count = 0;
+
+	for (size_t i = 0; i < partition_count; ++i)
+	{
+		const SimplifyPartition& partition = partitions[i];
+
+		memmove(&destination[result_count], &partition_indices[partition.face_begin * 3], partition.result_count * sizeof(unsigned int));
+		result_count += partition.result_count;
+	}
+
+	if (result_count <= target_index_count)
+		return result_count;
+
+	// the final stitching pass simplifies the combined result with cut vertices unlocked; it only processes vertices that are still referenced
+	SimplifyPartition& stitch = partitions[partition_count];
+
+	stitch.face_begin = 0;
+	stitch.face_end = result_count / 3;
+	stitch.target_index_count = target_index_count;
+	stitch.result_count = 0;
+
+	data.indices = destination;
+	data.order = 0;
+	data.partition_mode = Partition_Stitch;
+
+	simplifyPartition(&data, partition_count);
+
+	memcpy(destination, partition_indices.data, stitch.result_count * sizeof(unsigned int));
+
+	return stitch.result_count;
 }
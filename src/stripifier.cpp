@@ -1,4 +1,5 @@
 #include "meshoptimizer.h"
+#include "parallel.h"
 
 #include <assert.h>
 #include <limits.h>
@@ -29,8 +30,47 @@ static unsigned int findStripFirst(const unsigned int buffer[][3], unsigned int
 	return index;
 }
 
-static int findStripNext(const unsigned int buffer[][3], unsigned int buffer_size, unsigned int e0, unsigned int e1)
+static unsigned int findStripFirstCache(const unsigned int buffer[][3], unsigned int buffer_size, const unsigned int* valence, const unsigned int* cache_timestamps, unsigned int timestamp, unsigned int cache_size)
 {
+	unsigned int index = 0;
+	unsigned int ih = 0;
+	unsigned int iv = ~0u;
+
+	for (size_t i = 0; i < buffer_size; ++i)
+	{
+		unsigned int va = valence[buffer[i][0]], vb = valence[buffer[i][1]], vc = valence[buffer[i][2]];
+		unsigned int v = (va < vb && va < vc) ? va : (vb < vc) ? vb : vc;
+
+		// prefer triangles that reuse vertices still in cache; valence breaks ties
+		unsigned int ha = timestamp - cache_timestamps[buffer[i][0]] <= cache_size;
+		unsigned int hb = timestamp - cache_timestamps[buffer[i][1]] <= cache_size;
+		unsigned int hc = timestamp - cache_timestamps[buffer[i][2]] <= cache_size;
+		unsigned int h = ha + hb + hc;
+
+		if (h > ih || (h == ih && v < iv))
+		{
+			index = unsigned(i);
+			ih = h;
+			iv = v;
+		}
+	}
+
+	return index;
+}
+
+// returns the corner of triangle [a b c] that isn't on edge [e0 e1]: edge [a b] leaves c, edge [b c] leaves a and edge [c a] leaves b
+// a degenerate triangle may have the edge several times, in which case the first one wins
+static int getStripCorner(unsigned int a, unsigned int b, unsigned int c, unsigned int e0, unsigned int e1)
+{
+	return (e0 == a && e1 == b) ? 2 : (e0 == b && e1 == c) ? 0 : (e0 == c && e1 == a) ? 1 : -1;
+}
+
+// finds the first triangle with edge [e0 e1]; if there is none, swap receives the first triangle with edge [s0 s1] or -1
+// both edges are looked up in one pass since strips often end, in which case the entire buffer is scanned for each edge
+static int findStripNext(const unsigned int buffer[][3], unsigned int buffer_size, unsigned int e0, unsigned int e1, unsigned int s0, unsigned int s1, int& swap)
+{
+	swap = -1;
+
 	for (size_t i = 0; i < buffer_size; ++i)
 	{
 		unsigned int a = buffer[i][0], b = buffer[i][1], c = buffer[i][2];
@@ -41,25 +81,156 @@ static int findStripNext(const unsigned int buffer[][3], unsigned int buffer_siz
 			return (int(i) << 2) | 0;
 		else if (e0 == c && e1 == a)
 			return (int(i) << 2) | 1;
+
+		if (swap < 0)
+		{
+			if (s0 == a && s1 == b)
+				swap = (int(i) << 2) | 2;
+			else if (s0 == b && s1 == c)
+				swap = (int(i) << 2) | 0;
+			else if (s0 == c && s1 == a)
+				swap = (int(i) << 2) | 1;
+		}
 	}
 
 	return -1;
 }
 
-} // namespace meshopt
+// finds the first triangle with any of the edges [c b], [a c] and [b a]; the edges it doesn't have receive -1
+static void findStripStart(const unsigned int buffer[][3], unsigned int buffer_size, unsigned int a, unsigned int b, unsigned int c, int& ea, int& eb, int& ec)
+{
+	ea = eb = ec = -1;
 
-size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
+	for (size_t i = 0; i < buffer_size; ++i)
+	{
+		unsigned int x = buffer[i][0], y = buffer[i][1], z = buffer[i][2];
+
+		// getStripCorner resolves the corners of a matching triangle the same way separate lookups of each edge would
+		if ((y == c && z == b) || (y == a && z == c) || (y == b && z == a) || (z == c && x == b) || (z == a && x == c) || (z == b && x == a) || (x == c && y == b) || (x == a && y == c) || (x == b && y == a))
+		{
+			int ka = getStripCorner(x, y, z, c, b);
+			int kb = getStripCorner(x, y, z, a, c);
+			int kc = getStripCorner(x, y, z, b, a);
+
+			ea = ka >= 0 ? (int(i) << 2) | ka : -1;
+			eb = kb >= 0 ? (int(i) << 2) | kb : -1;
+			ec = kc >= 0 ? (int(i) << 2) | kc : -1;
+			break;
+		}
+	}
+}
+
+// triangles that use each vertex, in index buffer order; the lists of all vertices are stored back to back in data
+struct StripAdjacency
 {
-	assert(destination != indices);
-	assert(index_count % 3 == 0);
+	const unsigned int* counts;
+	const unsigned int* offsets;
+	const unsigned int* data;
+};
 
-	using namespace meshopt;
+// counts must contain the number of triangles that use each vertex
+static void buildStripAdjacency(unsigned int* offsets, unsigned int* data, const unsigned int* indices, size_t index_count, const unsigned int* counts, size_t vertex_count)
+{
+	size_t face_count = index_count / 3;
 
-	const size_t buffer_capacity = 8;
+	// fill offset table
+	unsigned int offset = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		offsets[i] = offset;
+		offset += counts[i];
+	}
+
+	assert(offset == index_count);
+
+	// fill triangle data
+	for (size_t i = 0; i < face_count; ++i)
+	{
+		unsigned int a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
+
+		data[offsets[a]++] = unsigned(i);
+		data[offsets[b]++] = unsigned(i);
+		data[offsets[c]++] = unsigned(i);
+	}
+
+	// fix offsets that have been disturbed by the previous pass
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		assert(offsets[i] >= counts[i]);
+
+		offsets[i] -= counts[i];
+	}
+}
 
-	unsigned int buffer[buffer_capacity][3] = {};
+// finds the first triangle with edge [e0 e1] among the triangles of e0; faces lists the source triangle of each buffer entry in increasing order
+static int findStripNextAdjacent(const StripAdjacency& adjacency, const unsigned int* indices, const unsigned int* faces, unsigned int buffer_size, unsigned int e0, unsigned int e1)
+{
+	const unsigned int* triangles = adjacency.data + adjacency.offsets[e0];
+	size_t count = adjacency.counts[e0];
+
+	if (buffer_size == 0)
+		return -1;
+
+	unsigned int first = faces[0], last = faces[buffer_size - 1];
+
+	// triangles with the edge that are no longer in the buffer are skipped; the first one that is found in the buffer is the oldest
+	for (size_t i = 0; i < count; ++i)
+	{
+		unsigned int face = triangles[i];
+
+		if (face < first)
+			continue;
+
+		if (face > last)
+			break;
+
+		int k = getStripCorner(indices[face * 3 + 0], indices[face * 3 + 1], indices[face * 3 + 2], e0, e1);
+		if (k < 0)
+			continue;
+
+		// binary search for the face in the buffer
+		unsigned int offset = 0, size = buffer_size;
+
+		while (size > 1)
+		{
+			unsigned int half = size / 2;
+			offset = faces[offset + half] <= face ? offset + half : offset;
+			size -= half;
+		}
+
+		if (faces[offset] == face)
+			return (int(offset) << 2) | k;
+	}
+
+	return -1;
+}
+
+static void updateStripCache(unsigned int* cache_timestamps, unsigned int& timestamp, unsigned int cache_size, unsigned int v)
+{
+	if (cache_timestamps && timestamp - cache_timestamps[v] > cache_size)
+		cache_timestamps[v] = timestamp++;
+}
+
+const size_t kStripBufferMax = 64;
+
+// buffers up to this size are faster to scan than to look up triangles by vertex
+const size_t kStripBufferScan = 16;
+
+// valence must contain the number of triangles that use each vertex and is consumed in the process
+// adjacency is only used for buffers larger than kStripBufferScan, and must be built from indices
+// restart_index of 0 stitches strips with degenerate triangles; cache_timestamps, if not NULL, must be zero-initialized and enables cache-aware strip starts
+static size_t stripifyRange(unsigned int* destination, const unsigned int* indices, size_t index_count, unsigned int* valence, const StripAdjacency* adjacency, unsigned int restart_index, size_t buffer_capacity, unsigned int* cache_timestamps, unsigned int cache_size)
+{
+	assert(buffer_capacity > 0 && buffer_capacity <= kStripBufferMax);
+	assert(buffer_capacity <= kStripBufferScan || adjacency);
+
+	unsigned int buffer[kStripBufferMax][3] = {};
+	unsigned int buffer_faces[kStripBufferMax] = {};
 	unsigned int buffer_size = 0;
 
+	adjacency = buffer_capacity > kStripBufferScan ? adjacency : 0;
+
 	size_t index_offset = 0;
 
 	unsigned int strip[2] = {};
@@ -67,17 +238,7 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 
 	size_t strip_size = 0;
 
-	// compute vertex valence; this is used to prioritize starting triangle for strips
-	meshopt_Buffer<unsigned int> valence(vertex_count);
-	memset(valence.data, 0, vertex_count * sizeof(unsigned int));
-
-	for (size_t i = 0; i < index_count; ++i)
-	{
-		unsigned int index = indices[i];
-		assert(index < vertex_count);
-
-		valence[index]++;
-	}
+	unsigned int timestamp = cache_size + 1;
 
 	int next = -1;
 
@@ -91,6 +252,7 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 			buffer[buffer_size][0] = indices[index_offset + 0];
 			buffer[buffer_size][1] = indices[index_offset + 1];
 			buffer[buffer_size][2] = indices[index_offset + 2];
+			buffer_faces[buffer_size] = unsigned(index_offset / 3);
 
 			buffer_size++;
 			index_offset += 3;
@@ -106,6 +268,8 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 
 			// ordered removal from the buffer
 			memmove(buffer[i], buffer[i + 1], (buffer_size - i - 1) * sizeof(buffer[0]));
+			if (adjacency)
+				memmove(&buffer_faces[i], &buffer_faces[i + 1], (buffer_size - i - 1) * sizeof(buffer_faces[0]));
 			buffer_size--;
 
 			// update vertex valences for strip start heuristic
@@ -116,8 +280,18 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 			// find next triangle (note that edge order flips on every iteration)
 			// in some cases we need to perform a swap to pick a different outgoing triangle edge
 			// for [a b c], the default strip edge is [b c], but we might want to use [a c]
-			int cont = findStripNext(buffer, buffer_size, parity ? strip[1] : v, parity ? v : strip[1]);
-			int swap = cont < 0 ? findStripNext(buffer, buffer_size, parity ? v : strip[0], parity ? strip[0] : v) : -1;
+			unsigned int e0 = parity ? strip[1] : v, e1 = parity ? v : strip[1];
+			unsigned int s0 = parity ? v : strip[0], s1 = parity ? strip[0] : v;
+
+			int cont = -1, swap = -1;
+
+			if (adjacency)
+			{
+				cont = findStripNextAdjacent(*adjacency, indices, buffer_faces, buffer_size, e0, e1);
+				swap = cont < 0 ? findStripNextAdjacent(*adjacency, indices, buffer_faces, buffer_size, s0, s1) : -1;
+			}
+			else
+				cont = findStripNext(buffer, buffer_size, e0, e1, s0, s1, swap);
 
 			if (cont < 0 && swap >= 0)
 			{
@@ -125,6 +299,8 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 				destination[strip_size++] = strip[0];
 				destination[strip_size++] = v;
 
+				updateStripCache(cache_timestamps, timestamp, cache_size, v);
+
 				// next strip has same winding
 				// ? a b => b a v
 				strip[1] = v;
@@ -136,6 +312,8 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 				// emit the next vertex in the strip
 				destination[strip_size++] = v;
 
+				updateStripCache(cache_timestamps, timestamp, cache_size, v);
+
 				// next strip has flipped winding
 				strip[0] = strip[1];
 				strip[1] = v;
@@ -148,11 +326,13 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 		{
 			// if we didn't find anything, we need to find the next new triangle
 			// we use a heuristic to maximize the strip length
-			unsigned int i = findStripFirst(buffer, buffer_size, &valence[0]);
+			unsigned int i = cache_timestamps ? findStripFirstCache(buffer, buffer_size, valence, cache_timestamps, timestamp, cache_size) : findStripFirst(buffer, buffer_size, valence);
 			unsigned int a = buffer[i][0], b = buffer[i][1], c = buffer[i][2];
 
 			// ordered removal from the buffer
 			memmove(buffer[i], buffer[i + 1], (buffer_size - i - 1) * sizeof(buffer[0]));
+			if (adjacency)
+				memmove(&buffer_faces[i], &buffer_faces[i + 1], (buffer_size - i - 1) * sizeof(buffer_faces[0]));
 			buffer_size--;
 
 			// update vertex valences for strip start heuristic
@@ -161,9 +341,16 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 			valence[c]--;
 
 			// we need to pre-rotate the triangle so that we will find a match in the existing buffer on the next iteration
-			int ea = findStripNext(buffer, buffer_size, c, b);
-			int eb = findStripNext(buffer, buffer_size, a, c);
-			int ec = findStripNext(buffer, buffer_size, b, a);
+			int ea = -1, eb = -1, ec = -1;
+
+			if (adjacency)
+			{
+				ea = findStripNextAdjacent(*adjacency, indices, buffer_faces, buffer_size, c, b);
+				eb = findStripNextAdjacent(*adjacency, indices, buffer_faces, buffer_size, a, c);
+				ec = findStripNextAdjacent(*adjacency, indices, buffer_faces, buffer_size, b, a);
+			}
+			else
+				findStripStart(buffer, buffer_size, a, b, c, ea, eb, ec);
 
 			// in some cases we can have several matching edges; since we can pick any edge, we pick the one with the smallest
 			// triangle index in the buffer. this reduces the effect of stripification on ACMR and additionally - for unclear
@@ -195,24 +382,278 @@ size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices,
 				next = ec;
 			}
 
-			// emit the new strip; we use restart indices
-			if (strip_size)
-				destination[strip_size++] = ~0u;
-
-			destination[strip_size++] = a;
-			destination[strip_size++] = b;
-			destination[strip_size++] = c;
+			if (restart_index)
+			{
+				// emit the new strip; we use restart indices
+				if (strip_size)
+					destination[strip_size++] = restart_index;
+
+				destination[strip_size++] = a;
+				destination[strip_size++] = b;
+				destination[strip_size++] = c;
+
+				// new strip always starts with the same edge winding
+				strip[0] = b;
+				strip[1] = c;
+				parity = 1;
+			}
+			else
+			{
+				// stitch the new strip with degenerate triangles that repeat the last vertex of the previous strip and the first vertex of the new one
+				if (strip_size)
+				{
+					destination[strip_size] = destination[strip_size - 1];
+					strip_size++;
+					destination[strip_size++] = a;
+				}
+
+				// odd triangles have flipped winding, so the new triangle is emitted as [a c b] at odd positions to avoid an extra degenerate
+				if (strip_size & 1)
+				{
+					destination[strip_size++] = a;
+					destination[strip_size++] = c;
+					destination[strip_size++] = b;
+
+					strip[0] = c;
+					strip[1] = b;
+					parity = 0;
+				}
+				else
+				{
+					destination[strip_size++] = a;
+					destination[strip_size++] = b;
+					destination[strip_size++] = c;
+
+					strip[0] = b;
+					strip[1] = c;
+					parity = 1;
+				}
+			}
 
-			// new strip always starts with the same edge winding
-			strip[0] = b;
-			strip[1] = c;
-			parity = 1;
+			updateStripCache(cache_timestamps, timestamp, cache_size, a);
+			updateStripCache(cache_timestamps, timestamp, cache_size, b);
+			updateStripCache(cache_timestamps, timestamp, cache_size, c);
 		}
 	}
 
 	return strip_size;
 }
 
+struct StripifyPartition
+{
+	size_t face_begin;
+	size_t face_end;
+
+	size_t strip_size;
+};
+
+struct StripifyPartitionData
+{
+	StripifyPartition* partitions;
+
+	const unsigned int* indices;
+
+	// each partition uses the index range [face_begin * 3..face_end * 3) of these as its local index buffer, vertex list and valence
+	unsigned int* partition_indices;
+	unsigned int* partition_vertices;
+	unsigned int* partition_valence;
+
+	// each partition writes its strip to [face_begin * 4..face_end * 4)
+	unsigned int* destination;
+};
+
+static void stripifyPartition(void* task_data, size_t index)
+{
+	const StripifyPartitionData& data = *static_cast<const StripifyPartitionData*>(task_data);
+	StripifyPartition& partition = data.partitions[index];
+
+	size_t index_offset = partition.face_begin * 3;
+	size_t index_count = (partition.face_end - partition.face_begin) * 3;
+
+	unsigned int* indices = data.partition_indices + index_offset;
+	unsigned int* vertices = data.partition_vertices + index_offset;
+	unsigned int* valence = data.partition_valence + index_offset;
+
+	// valence is tracked over a compact vertex set so that it isn't shared between partitions
+	size_t vertex_count = buildLocalVertices(indices, vertices, data.indices, 0, partition.face_begin, partition.face_end);
+
+	memset(valence, 0, vertex_count * sizeof(unsigned int));
+
+	for (size_t i = 0; i < index_count; ++i)
+		valence[indices[i]]++;
+
+	unsigned int* destination = data.destination + partition.face_begin * 4;
+
+	partition.strip_size = stripifyRange(destination, indices, index_count, valence, 0, ~0u, 8, 0, 0);
+
+	// convert the result back to original vertex indices
+	for (size_t i = 0; i < partition.strip_size; ++i)
+		destination[i] = (destination[i] == ~0u) ? ~0u : vertices[destination[i]];
+}
+
+} // namespace meshopt
+
+size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
+{
+	assert(destination != indices);
+	assert(index_count % 3 == 0);
+
+	using namespace meshopt;
+
+	// compute vertex valence; this is used to prioritize starting triangle for strips
+	meshopt_Buffer<unsigned int> valence(vertex_count);
+	memset(valence.data, 0, vertex_count * sizeof(unsigned int));
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		assert(index < vertex_count);
+
+		valence[index]++;
+	}
+
+	return stripifyRange(destination, indices, index_count, valence.data, 0, ~0u, 8, 0, 0);
+}
+
+size_t meshopt_stripifyCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int restart_index, unsigned int cache_size, float threshold)
+{
+	assert(destination != indices);
+	assert(index_count % 3 == 0);
+	assert(cache_size >= 3);
+
+	using namespace meshopt;
+
+	// guard for empty meshes
+	if (index_count == 0 || vertex_count == 0)
+		return 0;
+
+	meshopt_Buffer<unsigned int> source_valence(vertex_count);
+	memset(source_valence.data, 0, vertex_count * sizeof(unsigned int));
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		assert(index < vertex_count);
+
+		source_valence[index]++;
+	}
+
+	meshopt_Buffer<unsigned int> valence(vertex_count);
+	meshopt_Buffer<unsigned int> cache_timestamps(vertex_count);
+
+	// candidates with large buffers find triangles through vertex adjacency; valence doubles as the triangle count of each vertex
+	meshopt_Buffer<unsigned int> adjacency_offsets(vertex_count);
+	meshopt_Buffer<unsigned int> adjacency_data(index_count);
+	buildStripAdjacency(adjacency_offsets.data, adjacency_data.data, indices, index_count, source_valence.data, vertex_count);
+
+	StripAdjacency adjacency = {source_valence.data, adjacency_offsets.data, adjacency_data.data};
+
+	meshopt_Buffer<unsigned int> strip(index_count / 3 * 5);
+	meshopt_Buffer<unsigned int> triangles(index_count);
+
+	float target_acmr = meshopt_analyzeVertexCache(indices, index_count, vertex_count, cache_size, 0, 0).acmr * threshold;
+
+	// larger buffers find longer strips but stray further from the source order, which costs cache efficiency
+	// the first candidate matches meshopt_stripify, the rest prefer strip starts that reuse cached vertices; buffer size 1 keeps the source order and ACMR
+	const size_t buffer_sizes[] = {8, 1, 4, 8, 16, 32, 64};
+	const size_t candidate_count = sizeof(buffer_sizes) / sizeof(buffer_sizes[0]);
+
+	size_t result = 0;
+	float result_acmr = 0;
+	bool result_fits = false;
+
+	for (size_t candidate = 0; candidate < candidate_count; ++candidate)
+	{
+		bool cache_aware = candidate > 0;
+
+		memcpy(valence.data, source_valence.data, vertex_count * sizeof(unsigned int));
+
+		if (cache_aware)
+			memset(cache_timestamps.data, 0, vertex_count * sizeof(unsigned int));
+
+		// candidates use ~0u as a restart index so that they can be evaluated with meshopt_unstripify
+		size_t strip_size = stripifyRange(strip.data, indices, index_count, valence.data, &adjacency, restart_index ? ~0u : 0, buffer_sizes[candidate], cache_aware ? cache_timestamps.data : 0, cache_size);
+
+		size_t triangle_size = meshopt_unstripify(triangles.data, strip.data, strip_size);
+		float acmr = meshopt_analyzeVertexCache(triangles.data, triangle_size, vertex_count, cache_size, 0, 0).acmr;
+		bool fits = acmr <= target_acmr;
+
+		// pick the shortest strip that fits the target; if no strip fits, pick the most cache efficient one
+		if (candidate == 0 || (fits && (!result_fits || strip_size < result)) || (!fits && !result_fits && acmr < result_acmr))
+		{
+			for (size_t i = 0; i < strip_size; ++i)
+				destination[i] = (strip[i] == ~0u && restart_index) ? restart_index : strip[i];
+
+			result = strip_size;
+			result_acmr = acmr;
+			result_fits = fits;
+		}
+	}
+
+	return result;
+}
+
+size_t meshopt_stripifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	assert(destination != indices);
+	assert(index_count % 3 == 0);
+
+	using namespace meshopt;
+
+	size_t face_count = index_count / 3;
+
+	// partition boundaries end strips, so partitions need to be large enough for that cost to be negligible
+	const size_t kMinPartitionFaces = 16384;
+
+	if (partition_count > face_count / kMinPartitionFaces)
+		partition_count = face_count / kMinPartitionFaces;
+
+	if (partition_count <= 1)
+		return meshopt_stripify(destination, indices, index_count, vertex_count);
+
+	meshopt_Buffer<StripifyPartition> partitions(partition_count);
+
+	for (size_t i = 0; i < partition_count; ++i)
+	{
+		StripifyPartition& partition = partitions[i];
+
+		partition.face_begin = i * face_count / partition_count;
+		partition.face_end = (i + 1) * face_count / partition_count;
+		partition.strip_size = 0;
+	}
+
+	meshopt_Buffer<unsigned int> partition_indices(index_count);
+	meshopt_Buffer<unsigned int> partition_vertices(index_count);
+	meshopt_Buffer<unsigned int> partition_valence(index_count);
+
+	StripifyPartitionData data = {};
+	data.partitions = partitions.data;
+	data.indices = indices;
+	data.partition_indices = partition_indices.data;
+	data.partition_vertices = partition_vertices.data;
+	data.partition_valence = partition_valence.data;
+	data.destination = destination;
+
+	runTasks(parallel_for, context, stripifyPartition, &data, partition_count);
+
+	// each partition emits at most 4 indices per triangle minus one, which leaves room for the restart index, so strips can be packed front to back in place
+	size_t result = 0;
+
+	for (size_t i = 0; i < partition_count; ++i)
+	{
+		const StripifyPartition& partition = partitions[i];
+
+		if (result)
+			destination[result++] = ~0u;
+
+		assert(result <= partition.face_begin * 4);
+		memmove(destination + result, destination + partition.face_begin * 4, partition.strip_size * sizeof(unsigned int));
+		result += partition.strip_size;
+	}
+
+	return result;
+}
+
 size_t meshopt_unstripify(unsigned int* destination, const unsigned int* indices, size_t index_count)
 {
 	assert(destination != indices);
@@ -1,5 +1,6 @@
 // This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
 #include "meshoptimizer.h"
+#include "parallel.h"
 
 #include <assert.h>
 #include <math.h>
@@ -157,14 +158,119 @@ static unsigned int getNextTriangleDeadEnd(unsigned int& input_cursor, const cha
 	return ~0u;
 }
 
-} // namespace meshopt
+struct VertexCachePartition
+{
+	size_t face_begin;
+	size_t face_end;
 
-void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
+	size_t vertex_count;
+};
+
+struct VertexCachePartitionData
 {
-	using namespace meshopt;
+	VertexCachePartition* partitions;
 
-	assert(index_count % 3 == 0);
+	// triangles of each partition are order[face_begin..face_end) of source indices, or [face_begin..face_end) if order is NULL
+	const unsigned int* indices;
+	const unsigned int* order;
+
+	// each partition uses the index range [face_begin * 3..face_end * 3) of these as its local index buffer and vertex list
+	unsigned int* partition_indices;
+	unsigned int* partition_vertices;
+
+	unsigned int* destination;
+};
+
+static void sortTrianglesBreadthFirst(unsigned int* order, const unsigned int* indices, size_t index_count, size_t vertex_count)
+{
+	size_t face_count = index_count / 3;
+
+	TriangleAdjacency adjacency(index_count, vertex_count);
+	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count);
+
+	meshopt_Buffer<char> emitted_flags(face_count);
+	memset(emitted_flags.data, 0, face_count);
+
+	meshopt_Buffer<char> visited_flags(vertex_count);
+	memset(visited_flags.data, 0, vertex_count);
+
+	// order doubles as the traversal queue; every triangle is pushed exactly once
+	size_t order_head = 0, order_tail = 0;
+	unsigned int input_cursor = 0;
+
+	while (order_head < face_count)
+	{
+		// restart from the next triangle in input order once the current component is exhausted
+		if (order_head == order_tail)
+		{
+			while (emitted_flags[input_cursor])
+				input_cursor++;
+
+			emitted_flags[input_cursor] = true;
+			order[order_tail++] = input_cursor;
+		}
+
+		unsigned int face = order[order_head++];
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			unsigned int index = indices[face * 3 + k];
+
+			// each vertex only needs to be expanded once
+			if (visited_flags[index])
+				continue;
+
+			visited_flags[index] = true;
+
+			const unsigned int* neighbours_begin = &adjacency.data[0] + adjacency.offsets[index];
+			const unsigned int* neighbours_end = neighbours_begin + adjacency.counts[index];
+
+			for (const unsigned int* it = neighbours_begin; it != neighbours_end; ++it)
+			{
+				unsigned int tri = *it;
+
+				if (!emitted_flags[tri])
+				{
+					emitted_flags[tri] = true;
+					order[order_tail++] = tri;
+				}
+			}
+		}
+	}
+
+	assert(order_tail == face_count);
+}
+
+static void buildPartitionVertices(void* task_data, size_t index)
+{
+	VertexCachePartitionData& data = *static_cast<VertexCachePartitionData*>(task_data);
+	VertexCachePartition& partition = data.partitions[index];
+
+	size_t index_offset = partition.face_begin * 3;
+
+	partition.vertex_count = buildLocalVertices(data.partition_indices + index_offset, data.partition_vertices + index_offset, data.indices, data.order, partition.face_begin, partition.face_end);
+}
+
+static void optimizePartition(void* task_data, size_t index)
+{
+	const VertexCachePartitionData& data = *static_cast<VertexCachePartitionData*>(task_data);
+	const VertexCachePartition& partition = data.partitions[index];
 
+	size_t index_offset = partition.face_begin * 3;
+	size_t index_count = (partition.face_end - partition.face_begin) * 3;
+
+	const unsigned int* vertices = data.partition_vertices + index_offset;
+	unsigned int* destination = data.destination + index_offset;
+
+	meshopt_optimizeVertexCache(destination, data.partition_indices + index_offset, index_count, partition.vertex_count);
+
+	// convert the result back to original vertex indices
+	for (size_t i = 0; i < index_count; ++i)
+		destination[i] = vertices[destination[i]];
+}
+
+static void optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int flush_cache_size, unsigned int flush_warp_size, unsigned int flush_primgroup_size)
+{
 	// guard for empty meshes
 	if (index_count == 0 || vertex_count == 0)
 		return;
@@ -184,13 +290,13 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 
 	size_t face_count = index_count / 3;
 
+	meshopt_Instrumentation<void>::report("optimizeVertexCache", "start", face_count);
+
 	// build adjacency information
 	TriangleAdjacency adjacency(index_count, vertex_count);
 	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count);
 
-	// live triangle counts
-	meshopt_Buffer<unsigned int> live_triangles(vertex_count);
-	memcpy(live_triangles.data, adjacency.counts.data, vertex_count * sizeof(unsigned int));
+	meshopt_Instrumentation<void>::report("optimizeVertexCache", "adjacency", face_count);
 
 	// emitted flags
 	meshopt_Buffer<char> emitted_flags(face_count);
@@ -201,7 +307,7 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
-		vertex_scores[i] = vertexScore(-1, live_triangles[i]);
+		vertex_scores[i] = vertexScore(-1, adjacency.counts[i]);
 	}
 
 	// compute triangle scores
@@ -225,6 +331,22 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 	unsigned int input_cursor = 1;
 
 	unsigned int output_triangle = 0;
+	size_t dead_ends = 0;
+
+	// optionally simulate a GPU that flushes its vertex cache between warps, using the same model as meshopt_analyzeVertexCache
+	bool flush_model = flush_warp_size || flush_primgroup_size;
+
+	meshopt_Buffer<unsigned int> flush_timestamps;
+
+	if (flush_model)
+	{
+		flush_timestamps.allocate(vertex_count);
+		memset(flush_timestamps.data, 0, vertex_count * sizeof(unsigned int));
+	}
+
+	unsigned int flush_timestamp = flush_cache_size + 1;
+	unsigned int warp_offset = 0;
+	unsigned int primgroup_offset = 0;
 
 	while (current_triangle != ~0u)
 	{
@@ -234,6 +356,38 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 		unsigned int b = indices[current_triangle * 3 + 1];
 		unsigned int c = indices[current_triangle * 3 + 2];
 
+		size_t cache_limit = cache_size;
+
+		if (flush_model)
+		{
+			bool ac = (flush_timestamp - flush_timestamps[a]) > flush_cache_size;
+			bool bc = (flush_timestamp - flush_timestamps[b]) > flush_cache_size;
+			bool cc = (flush_timestamp - flush_timestamps[c]) > flush_cache_size;
+
+			// after a flush only the vertices of the new triangle are in cache
+			if ((flush_primgroup_size && primgroup_offset == flush_primgroup_size) || (flush_warp_size && warp_offset + ac + bc + cc > flush_warp_size))
+			{
+				warp_offset = 0;
+				primgroup_offset = 0;
+
+				flush_timestamp += flush_cache_size + 1;
+				cache_limit = 3;
+			}
+
+			for (size_t k = 0; k < 3; ++k)
+			{
+				unsigned int index = indices[current_triangle * 3 + k];
+
+				if (flush_timestamp - flush_timestamps[index] > flush_cache_size)
+				{
+					flush_timestamps[index] = flush_timestamp++;
+					warp_offset++;
+				}
+			}
+
+			primgroup_offset++;
+		}
+
 		// output indices
 		destination[output_triangle * 3 + 0] = a;
 		destination[output_triangle * 3 + 1] = b;
@@ -255,23 +409,17 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 		{
 			unsigned int index = cache[i];
 
-			if (index != a && index != b && index != c)
-			{
-				cache_new[cache_write++] = index;
-			}
+			cache_new[cache_write] = index;
+			cache_write += (index != a) & (index != b) & (index != c);
 		}
 
 		unsigned int* cache_temp = cache;
 		cache = cache_new, cache_new = cache_temp;
-		cache_count = cache_write > cache_size ? cache_size : cache_write;
-
-		// update live triangle counts
-		live_triangles[a]--;
-		live_triangles[b]--;
-		live_triangles[c]--;
+		cache_count = cache_write > cache_limit ? cache_limit : cache_write;
 
 		// remove emitted triangle from adjacency data
 		// this makes sure that we spend less time traversing these lists on subsequent iterations
+		// live triangle counts are updated as a byproduct of these adjustments
 		for (size_t k = 0; k < 3; ++k)
 		{
 			unsigned int index = indices[current_triangle * 3 + k];
@@ -300,10 +448,14 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 		{
 			unsigned int index = cache[i];
 
-			int cache_position = i >= cache_size ? -1 : int(i);
+			// no need to update scores if we are never going to use this vertex
+			if (adjacency.counts[index] == 0)
+				continue;
+
+			int cache_position = i >= cache_count ? -1 : int(i);
 
 			// update vertex score
-			float score = vertexScore(cache_position, live_triangles[index]);
+			float score = vertexScore(cache_position, adjacency.counts[index]);
 			float score_diff = score - vertex_scores[index];
 
 			vertex_scores[index] = score;
@@ -320,11 +472,8 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 				float tri_score = triangle_scores[tri] + score_diff;
 				assert(tri_score > 0);
 
-				if (best_score < tri_score)
-				{
-					best_triangle = tri;
-					best_score = tri_score;
-				}
+				best_triangle = best_score < tri_score ? tri : best_triangle;
+				best_score = best_score < tri_score ? tri_score : best_score;
 
 				triangle_scores[tri] = tri_score;
 			}
@@ -336,11 +485,25 @@ void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int*
 		if (current_triangle == ~0u)
 		{
 			current_triangle = getNextTriangleDeadEnd(input_cursor, &emitted_flags[0], face_count);
+			dead_ends++;
 		}
 	}
 
 	assert(input_cursor == face_count);
 	assert(output_triangle == face_count);
+
+	meshopt_Instrumentation<void>::report("optimizeVertexCache", "optimize", face_count, dead_ends);
+}
+
+} // namespace meshopt
+
+void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	optimizeVertexCacheTable(destination, indices, index_count, vertex_count, 0, 0, 0);
 }
 
 void meshopt_optimizeVertexCacheFifo(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size)
@@ -366,10 +529,14 @@ void meshopt_optimizeVertexCacheFifo(unsigned int* destination, const unsigned i
 
 	size_t face_count = index_count / 3;
 
+	meshopt_Instrumentation<void>::report("optimizeVertexCacheFifo", "start", face_count);
+
 	// build adjacency information
 	TriangleAdjacency adjacency(index_count, vertex_count);
 	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count);
 
+	meshopt_Instrumentation<void>::report("optimizeVertexCacheFifo", "adjacency", face_count);
+
 	// live triangle counts
 	meshopt_Buffer<unsigned int> live_triangles(vertex_count);
 	memcpy(live_triangles.data, adjacency.counts.data, vertex_count * sizeof(unsigned int));
@@ -392,6 +559,7 @@ void meshopt_optimizeVertexCacheFifo(unsigned int* destination, const unsigned i
 	unsigned int input_cursor = 1; // vertex to restart from in case of dead-end
 
 	unsigned int output_triangle = 0;
+	size_t dead_ends = 0;
 
 	while (current_vertex != ~0u)
 	{
@@ -451,8 +619,148 @@ void meshopt_optimizeVertexCacheFifo(unsigned int* destination, const unsigned i
 		if (current_vertex == ~0u)
 		{
 			current_vertex = getNextVertexDeadEnd(&dead_end[0], dead_end_top, input_cursor, &live_triangles[0], vertex_count);
+			dead_ends++;
 		}
 	}
 
 	assert(output_triangle == face_count);
+
+	meshopt_Instrumentation<void>::report("optimizeVertexCacheFifo", "optimize", face_count, dead_ends);
+}
+
+void meshopt_optimizeVertexCacheParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t partition_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+
+	size_t face_count = index_count / 3;
+
+	// partition boundaries cost cache efficiency, so partitions need to be large enough for that cost to be negligible
+	const size_t kMinPartitionFaces = 16384;
+
+	if (partition_count > face_count / kMinPartitionFaces)
+		partition_count = face_count / kMinPartitionFaces;
+
+	if (partition_count <= 1)
+	{
+		meshopt_optimizeVertexCache(destination, indices, index_count, vertex_count);
+		return;
+	}
+
+	// start with partitions that are contiguous in input order; most meshes have enough locality for these to share few vertices
+	meshopt_Buffer<VertexCachePartition> partitions(partition_count);
+
+	for (size_t i = 0; i < partition_count; ++i)
+	{
+		VertexCachePartition& partition = partitions[i];
+
+		partition.face_begin = i * face_count / partition_count;
+		partition.face_end = (i + 1) * face_count / partition_count;
+		partition.vertex_count = 0;
+	}
+
+	meshopt_Buffer<unsigned int> partition_indices(index_count);
+	meshopt_Buffer<unsigned int> partition_vertices(index_count);
+
+	VertexCachePartitionData data = {};
+	data.partitions = partitions.data;
+	data.indices = indices;
+	data.partition_indices = partition_indices.data;
+	data.partition_vertices = partition_vertices.data;
+	data.destination = destination;
+
+	runTasks(parallel_for, context, buildPartitionVertices, &data, partition_count);
+
+	// every vertex shared between partitions costs at most one extra transform, which bounds the efficiency loss
+	size_t shared_vertices = 0;
+
+	{
+		meshopt_Buffer<char> used_flags(vertex_count);
+		memset(used_flags.data, 0, vertex_count);
+
+		for (size_t i = 0; i < partition_count; ++i)
+		{
+			const VertexCachePartition& partition = partitions[i];
+			const unsigned int* vertices = &partition_vertices[partition.face_begin * 3];
+
+			for (size_t j = 0; j < partition.vertex_count; ++j)
+			{
+				assert(vertices[j] < vertex_count);
+
+				shared_vertices += used_flags[vertices[j]];
+				used_flags[vertices[j]] = 1;
+			}
+		}
+	}
+
+	// if the input order doesn't have enough locality, rebuild the partitions from a breadth-first traversal over shared vertices
+	meshopt_Buffer<unsigned int> order;
+
+	if (shared_vertices > face_count / 32)
+	{
+		order.allocate(face_count);
+		sortTrianglesBreadthFirst(order.data, indices, index_count, vertex_count);
+
+		data.order = order.data;
+
+		runTasks(parallel_for, context, buildPartitionVertices, &data, partition_count);
+	}
+
+	// destination can alias indices which are no longer needed at this point
+	runTasks(parallel_for, context, optimizePartition, &data, partition_count);
+}
+
+void meshopt_optimizeVertexCacheProfile(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size, unsigned int warp_size, unsigned int primgroup_size)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(cache_size >= 3);
+	assert(warp_size == 0 || warp_size >= 3);
+
+	// guard for empty meshes
+	if (index_count == 0 || vertex_count == 0)
+		return;
+
+	// no single optimizer is best for all GPU models, so we try several and pick the one with the lowest cost according to the model
+	// large FIFO caches favor meshopt_optimizeVertexCacheFifo with the full cache size, while caches that are flushed between warps favor smaller sizes
+	unsigned int fifo_small = cache_size < 16 ? cache_size : 16;
+
+	meshopt_Buffer<unsigned int> result(index_count);
+	meshopt_Buffer<unsigned int> candidate(index_count);
+
+	unsigned int* best = result.data;
+	unsigned int* next = candidate.data;
+	unsigned int best_cost = ~0u;
+
+	for (int kind = 0; kind < 4; ++kind)
+	{
+		if (kind == 1 && warp_size == 0 && primgroup_size == 0)
+			continue;
+
+		if (kind == 3 && fifo_small == cache_size)
+			continue;
+
+		if (kind == 0)
+			optimizeVertexCacheTable(next, indices, index_count, vertex_count, 0, 0, 0);
+		else if (kind == 1)
+			optimizeVertexCacheTable(next, indices, index_count, vertex_count, cache_size, warp_size, primgroup_size);
+		else
+			meshopt_optimizeVertexCacheFifo(next, indices, index_count, vertex_count, kind == 2 ? cache_size : fifo_small);
+
+		unsigned int cost = meshopt_analyzeVertexCache(next, index_count, vertex_count, cache_size, warp_size, primgroup_size).vertices_transformed;
+
+		if (cost < best_cost)
+		{
+			unsigned int* temp = best;
+			best = next;
+			next = temp;
+
+			best_cost = cost;
+		}
+	}
+
+	// destination can alias indices which are no longer needed at this point
+	memcpy(destination, best, index_count * sizeof(unsigned int));
 }
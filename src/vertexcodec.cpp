@@ -1,5 +1,6 @@
 // This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
 #include "meshoptimizer.h"
+#include "vertexcodec.h"
 
 #include <assert.h>
 #include <string.h>
@@ -15,13 +16,59 @@
 #if !defined(SIMD_SSE) && defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 #define SIMD_SSE
 #define SIMD_FALLBACK
-#include <intrin.h>
+#endif
+
+// GCC 4.9+ and clang can compile SSSE3 code without global compiler flags using per-function target attributes
+#if !defined(SIMD_SSE) && (defined(__i386__) || defined(__x86_64__)) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define SIMD_SSE
+#define SIMD_FALLBACK
+#define SIMD_TARGET __attribute__((target("ssse3")))
+#endif
+
+// AVX2 and AVX-512 kernels are always compiled with per-function targets and are selected at runtime
+#if defined(SIMD_SSE) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define SIMD_AVX2
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && _MSC_VER >= 1900
+#define SIMD_AVX2
+#define SIMD_TARGET_AVX2
+#endif
+
+#if defined(SIMD_AVX2) && ((defined(__clang__) && __clang_major__ >= 6) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 8))
+#define SIMD_AVX512
+#define SIMD_TARGET_AVX512 __attribute__((target("avx2,popcnt,avx512f,avx512bw,avx512vl,avx512vbmi2")))
+#endif
+
+#ifndef SIMD_TARGET
+#define SIMD_TARGET
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2
+#endif
+
+#ifdef SIMD_SSE2
+#include <emmintrin.h>
 #endif
 
 #ifdef SIMD_SSE
 #include <tmmintrin.h>
 #endif
 
+#if defined(SIMD_SSE) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(SIMD_SSE) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+#ifdef SIMD_AVX2
+#include <immintrin.h>
+#endif
+
 #ifdef SIMD_NEON
 #include <arm_neon.h>
 #endif
@@ -31,7 +78,20 @@ namespace meshopt
 
 const unsigned char kVertexHeader = 0xa0;
 
-const size_t kVertexBlockSizeBytes = 8192;
+// version 1 streams are split into segments of kVertexSegmentBlocks blocks that can be decoded independently
+const size_t kVertexSegmentBlocks = 16;
+
+// version 2 blocks start with a 2-bit predictor mode for each group of 4 bytes; version 0 and 1 blocks always use byte deltas
+const int kChannelDelta8 = 0;  // zigzag-encoded delta of each byte
+const int kChannelDelta16 = 1; // zigzag-encoded delta of each 16-bit pair, for 16-bit quantized attributes
+const int kChannelXor32 = 2;   // xor of each 32-bit value, for floating point attributes
+const int kChannelDelta32 = 3; // zigzag-encoded delta of each 32-bit value
+
+// other predictors decode slower than byte deltas, so a block only uses them if they make it at least 1/kChannelModeMinGain smaller
+const size_t kChannelModeMinGain = 32;
+
+// streaming states embed a block of this size, so it can't change without breaking the ABI
+const size_t kVertexBlockSizeBytes = meshopt_VertexStreamBlockSize;
 const size_t kVertexBlockMaxSize = 256;
 const size_t kByteGroupSize = 16;
 const size_t kTailMaxSize = 32;
@@ -48,9 +108,22 @@ static size_t getVertexBlockSize(size_t vertex_size)
 	return (result < kVertexBlockMaxSize) ? result : kVertexBlockMaxSize;
 }
 
+static void writeVertices(unsigned char* vertex_data, size_t vertex_stride, const unsigned char* transposed, size_t vertex_count, size_t vertex_size)
+{
+	if (vertex_stride == vertex_size)
+	{
+		memcpy(vertex_data, transposed, vertex_count * vertex_size);
+		return;
+	}
+
+	// interleaved destinations receive each vertex separately; the bytes between vertices are left untouched
+	for (size_t i = 0; i < vertex_count; ++i)
+		memcpy(vertex_data + i * vertex_stride, transposed + i * vertex_size, vertex_size);
+}
+
 inline unsigned char zigzag8(unsigned char v)
 {
-	return (v >> 7) | ((v ^ -(v >> 7)) << 1);
+	return (unsigned char)((v >> 7) | (unsigned(v ^ -(v >> 7)) << 1));
 }
 
 inline unsigned char unzigzag8(unsigned char v)
@@ -58,6 +131,37 @@ inline unsigned char unzigzag8(unsigned char v)
 	return (-(v & 1)) ^ (v >> 1);
 }
 
+inline unsigned short zigzag16(unsigned short v)
+{
+	return (unsigned short)((v >> 15) | (unsigned(v ^ -(v >> 15)) << 1));
+}
+
+inline unsigned short unzigzag16(unsigned short v)
+{
+	return (unsigned short)((-(v & 1)) ^ (v >> 1));
+}
+
+inline unsigned int zigzag32(unsigned int v)
+{
+	return (v >> 31) | ((v ^ -(v >> 31)) << 1);
+}
+
+inline unsigned int unzigzag32(unsigned int v)
+{
+	return (-(v & 1)) ^ (v >> 1);
+}
+
+static size_t getChannelModeSize(size_t vertex_size)
+{
+	// 2 bits per group of 4 bytes
+	return (vertex_size / 4 + 3) / 4;
+}
+
+inline int getChannelMode(const unsigned char* modes, size_t k)
+{
+	return modes ? (modes[k / 16] >> ((k / 4 % 4) * 2)) & 3 : kChannelDelta8;
+}
+
 static bool encodeBytesGroupZero(const unsigned char* buffer)
 {
 	for (size_t i = 0; i < kByteGroupSize; ++i)
@@ -87,6 +191,87 @@ static size_t encodeBytesGroupMeasure(const unsigned char* buffer, int bits)
 	return result;
 }
 
+#ifdef SIMD_SSE2
+static size_t encodeBytesGroupCountSimd(__m128i mask)
+{
+	// horizontal sum of 0/1 bytes; sad produces two partial sums in the low and high 64-bit halves
+	__m128i sum = _mm_sad_epu8(_mm_and_si128(mask, _mm_set1_epi8(1)), _mm_setzero_si128());
+
+	return size_t(_mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4));
+}
+
+static size_t encodeBytesGroupMeasureSimd(const unsigned char* buffer, int& best_bits)
+{
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+
+	// v >= sentinel <=> max(v, sentinel) == v; note that there's no unsigned byte comparison in SSE2
+	__m128i zero = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+	__m128i over2 = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(3)), v);
+	__m128i over4 = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(15)), v);
+
+	if (_mm_movemask_epi8(zero) == 0xffff)
+	{
+		best_bits = 1;
+		return 0;
+	}
+
+	size_t size2 = kByteGroupSize * 2 / 8 + encodeBytesGroupCountSimd(over2);
+	size_t size4 = kByteGroupSize * 4 / 8 + encodeBytesGroupCountSimd(over4);
+
+	// this must match the selection order in encodeBytes exactly to produce identical output
+	size_t best_size = kByteGroupSize;
+	best_bits = 8;
+
+	if (size2 < best_size)
+		best_bits = 2, best_size = size2;
+
+	if (size4 < best_size)
+		best_bits = 4, best_size = size4;
+
+	return best_size;
+}
+#endif
+
+#ifdef SIMD_NEON
+static size_t encodeBytesGroupCountSimd(uint8x16_t mask)
+{
+	uint8x16_t bits = vandq_u8(mask, vdupq_n_u8(1));
+	uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(bits)));
+
+	return size_t(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+}
+
+static size_t encodeBytesGroupMeasureSimd(const unsigned char* buffer, int& best_bits)
+{
+	uint8x16_t v = vld1q_u8(buffer);
+
+	uint8x16_t nonzero = vtstq_u8(v, v);
+	uint8x16_t over2 = vcgeq_u8(v, vdupq_n_u8(3));
+	uint8x16_t over4 = vcgeq_u8(v, vdupq_n_u8(15));
+
+	if (encodeBytesGroupCountSimd(nonzero) == 0)
+	{
+		best_bits = 1;
+		return 0;
+	}
+
+	size_t size2 = kByteGroupSize * 2 / 8 + encodeBytesGroupCountSimd(over2);
+	size_t size4 = kByteGroupSize * 4 / 8 + encodeBytesGroupCountSimd(over4);
+
+	// this must match the selection order in encodeBytes exactly to produce identical output
+	size_t best_size = kByteGroupSize;
+	best_bits = 8;
+
+	if (size2 < best_size)
+		best_bits = 2, best_size = size2;
+
+	if (size4 < best_size)
+		best_bits = 4, best_size = size4;
+
+	return best_size;
+}
+#endif
+
 static unsigned char* encodeBytesGroup(unsigned char* data, const unsigned char* buffer, int bits)
 {
 	assert(bits >= 1 && bits <= 8);
@@ -133,7 +318,145 @@ static unsigned char* encodeBytesGroup(unsigned char* data, const unsigned char*
 	return data;
 }
 
-static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size)
+#ifdef SIMD_SSE2
+static __m128i encodeBytesGroupPack(__m128i v, int shift)
+{
+	// combines pairs of adjacent bytes (a, b) into (a << shift) | b, halving the number of bytes
+	__m128i lo = _mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(255)), shift);
+	__m128i hi = _mm_srli_epi16(v, 8);
+
+	return _mm_packus_epi16(_mm_or_si128(lo, hi), _mm_setzero_si128());
+}
+
+static unsigned char* encodeBytesGroupSimd(unsigned char* data, const unsigned char* buffer, int bits)
+{
+	assert(bits >= 1 && bits <= 8);
+
+	if (bits == 1)
+		return data;
+
+	if (bits == 8)
+	{
+		memcpy(data, buffer, kByteGroupSize);
+		return data + kByteGroupSize;
+	}
+
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+	__m128i sentinel = _mm_set1_epi8(char((1 << bits) - 1));
+
+	// fixed portion: bits bits for each value
+	__m128i enc = _mm_min_epu8(v, sentinel);
+	__m128i packed = (bits == 2) ? encodeBytesGroupPack(encodeBytesGroupPack(enc, 2), 4) : encodeBytesGroupPack(enc, 4);
+
+	unsigned char fixed[16];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(fixed), packed);
+
+	memcpy(data, fixed, kByteGroupSize * bits / 8);
+	data += kByteGroupSize * bits / 8;
+
+	// variable portion: full byte for each out-of-range value (using 1...1 as sentinel)
+	int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, sentinel), v));
+
+	for (int i = 0; mask; ++i, mask >>= 1)
+		if (mask & 1)
+			*data++ = buffer[i];
+
+	return data;
+}
+#endif
+
+#ifdef SIMD_NEON
+static uint8x8_t encodeBytesGroupPack(uint8x16_t v, int shift)
+{
+	// combines pairs of adjacent bytes (a, b) into (a << shift) | b, halving the number of bytes
+	uint16x8_t v16 = vreinterpretq_u16_u8(v);
+	uint16x8_t lo = vshlq_u16(vandq_u16(v16, vdupq_n_u16(255)), vdupq_n_s16(short(shift)));
+	uint16x8_t hi = vshrq_n_u16(v16, 8);
+
+	return vmovn_u16(vorrq_u16(lo, hi));
+}
+
+static unsigned char* encodeBytesGroupSimd(unsigned char* data, const unsigned char* buffer, int bits)
+{
+	assert(bits >= 1 && bits <= 8);
+
+	if (bits == 1)
+		return data;
+
+	if (bits == 8)
+	{
+		memcpy(data, buffer, kByteGroupSize);
+		return data + kByteGroupSize;
+	}
+
+	uint8x16_t v = vld1q_u8(buffer);
+	uint8x16_t sentinel = vdupq_n_u8((unsigned char)((1 << bits) - 1));
+
+	// fixed portion: bits bits for each value
+	uint8x16_t enc = vminq_u8(v, sentinel);
+	uint8x8_t packed = encodeBytesGroupPack(enc, bits == 2 ? 2 : 4);
+
+	if (bits == 2)
+		packed = encodeBytesGroupPack(vcombine_u8(packed, vdup_n_u8(0)), 4);
+
+	unsigned char fixed[8];
+	vst1_u8(fixed, packed);
+
+	memcpy(data, fixed, kByteGroupSize * bits / 8);
+	data += kByteGroupSize * bits / 8;
+
+	// variable portion: full byte for each out-of-range value (using 1...1 as sentinel)
+	unsigned char over[16];
+	vst1q_u8(over, vcgeq_u8(v, sentinel));
+
+	for (size_t i = 0; i < kByteGroupSize; ++i)
+		if (over[i])
+			*data++ = buffer[i];
+
+	return data;
+}
+#endif
+
+static size_t encodeBytesGroupMeasureDispatch(const unsigned char* buffer, int& best_bits, bool simd)
+{
+#if defined(SIMD_SSE2) || defined(SIMD_NEON)
+	if (simd)
+		return encodeBytesGroupMeasureSimd(buffer, best_bits);
+#else
+	(void)simd;
+#endif
+
+	size_t best_size = encodeBytesGroupMeasure(buffer, 8);
+	best_bits = 8;
+
+	for (int bits = 1; bits < 8; bits *= 2)
+	{
+		size_t size = encodeBytesGroupMeasure(buffer, bits);
+
+		if (size < best_size)
+		{
+			best_bits = bits;
+			best_size = size;
+		}
+	}
+
+	return best_size;
+}
+
+static unsigned char* encodeBytesGroupDispatch(unsigned char* data, const unsigned char* buffer, int bits, bool simd)
+{
+#if defined(SIMD_SSE2) || defined(SIMD_NEON)
+	if (simd)
+		return encodeBytesGroupSimd(data, buffer, bits);
+#else
+	(void)simd;
+#endif
+
+	return encodeBytesGroup(data, buffer, bits);
+}
+
+// simd selects the vectorized byte group encoder; both encoders produce identical output
+static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size, bool simd)
 {
 	assert(buffer_size % kByteGroupSize == 0);
 
@@ -155,18 +478,7 @@ static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end,
 			return 0;
 
 		int best_bits = 8;
-		size_t best_size = encodeBytesGroupMeasure(buffer + i, 8);
-
-		for (int bits = 1; bits < 8; bits *= 2)
-		{
-			size_t size = encodeBytesGroupMeasure(buffer + i, bits);
-
-			if (size < best_size)
-			{
-				best_bits = bits;
-				best_size = size;
-			}
-		}
+		size_t best_size = encodeBytesGroupMeasureDispatch(buffer + i, best_bits, simd);
 
 		int bitslog2 = (best_bits == 1) ? 0 : (best_bits == 2) ? 1 : (best_bits == 4) ? 2 : 3;
 		assert((1 << bitslog2) == best_bits);
@@ -175,9 +487,11 @@ static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end,
 
 		header[header_offset / 4] |= bitslog2 << ((header_offset % 4) * 2);
 
-		unsigned char* next = encodeBytesGroup(data, buffer + i, best_bits);
+		unsigned char* next = encodeBytesGroupDispatch(data, buffer + i, best_bits, simd);
 
 		assert(data + best_size == next);
+		(void)best_size;
+
 		data = next;
 	}
 
@@ -209,7 +523,7 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 			vertex_offset += vertex_size;
 		}
 
-		data = encodeBytes(data, data_end, buffer, (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1));
+		data = encodeBytes(data, data_end, buffer, (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1), false);
 		if (!data)
 			return 0;
 	}
@@ -219,116 +533,487 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 	return data;
 }
 
-#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON))
-static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2)
+#if defined(SIMD_SSE2) || defined(SIMD_NEON)
+#ifdef SIMD_SSE2
+static __m128i zigzag8(__m128i v)
 {
-#define READ() byte = *data++
-#define NEXT(bits) enc = byte >> (8 - bits), byte <<= bits, encv = *data_var, *buffer++ = (enc == (1 << bits) - 1) ? encv : enc, data_var += (enc == (1 << bits) - 1)
+	// (v << 1) ^ (v >> 7), where >> is an arithmetic shift
+	__m128i xl = _mm_add_epi8(v, v);
+	__m128i xr = _mm_cmpgt_epi8(_mm_setzero_si128(), v);
 
-	unsigned char byte, enc, encv;
-	const unsigned char* data_var;
+	return _mm_xor_si128(xl, xr);
+}
 
-	switch (bitslog2)
-	{
-	case 0:
-		memset(buffer, 0, kByteGroupSize);
-		return data;
-	case 1:
-		data_var = data + 4;
+static void transposeVertices(unsigned char* channels[4], const unsigned char* vertex_data, size_t vertex_size)
+{
+#define LOAD(i) *reinterpret_cast<const int*>(vertex_data + vertex_size * (i))
 
-		// 4 groups with 4 2-bit values in each byte
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
-		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+	// 4 vertices per register, 4 bytes per vertex
+	__m128i x0 = _mm_setr_epi32(LOAD(0), LOAD(1), LOAD(2), LOAD(3));
+	__m128i x1 = _mm_setr_epi32(LOAD(4), LOAD(5), LOAD(6), LOAD(7));
+	__m128i x2 = _mm_setr_epi32(LOAD(8), LOAD(9), LOAD(10), LOAD(11));
+	__m128i x3 = _mm_setr_epi32(LOAD(12), LOAD(13), LOAD(14), LOAD(15));
 
-		return data_var;
-	case 2:
-		data_var = data + 8;
+#undef LOAD
 
-		// 8 groups with 2 4-bit values in each byte
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
-		READ(), NEXT(4), NEXT(4);
+	// each unpack round interleaves bytes; after three rounds each 8-byte half holds one byte of 8 vertices
+	__m128i t0 = _mm_unpacklo_epi8(x0, x1);
+	__m128i t1 = _mm_unpackhi_epi8(x0, x1);
+	__m128i t2 = _mm_unpacklo_epi8(x2, x3);
+	__m128i t3 = _mm_unpackhi_epi8(x2, x3);
 
-		return data_var;
-	case 3:
-		memcpy(buffer, data, kByteGroupSize);
-		return data + kByteGroupSize;
-	default:
-		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
-		return data;
-	}
+	__m128i u0 = _mm_unpacklo_epi8(t0, t1);
+	__m128i u1 = _mm_unpackhi_epi8(t0, t1);
+	__m128i u2 = _mm_unpacklo_epi8(t2, t3);
+	__m128i u3 = _mm_unpackhi_epi8(t2, t3);
 
-#undef READ
-#undef NEXT
+	__m128i w0 = _mm_unpacklo_epi8(u0, u1);
+	__m128i w1 = _mm_unpackhi_epi8(u0, u1);
+	__m128i w2 = _mm_unpacklo_epi8(u2, u3);
+	__m128i w3 = _mm_unpackhi_epi8(u2, u3);
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(channels[0]), _mm_unpacklo_epi64(w0, w2));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(channels[1]), _mm_unpackhi_epi64(w0, w2));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(channels[2]), _mm_unpacklo_epi64(w1, w3));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(channels[3]), _mm_unpackhi_epi64(w1, w3));
 }
 
-static const unsigned char* decodeBytes(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+static void encodeDeltas(unsigned char* buffer, const unsigned char* channel, size_t count)
 {
-	assert(buffer_size % kByteGroupSize == 0);
+	for (size_t i = 0; i < count; i += kByteGroupSize)
+	{
+		__m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(channel + i));
+		__m128i curr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(channel + i + 1));
 
-	const unsigned char* header = data;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), zigzag8(_mm_sub_epi8(curr, prev)));
+	}
+}
+#endif
 
-	// round number of groups to 4 to get number of header bytes
-	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+#ifdef SIMD_NEON
+static uint8x16_t zigzag8(uint8x16_t v)
+{
+	// (v << 1) ^ (v >> 7), where >> is an arithmetic shift
+	uint8x16_t xl = vshlq_n_u8(v, 1);
+	uint8x16_t xr = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(v), 7));
 
-	if (size_t(data_end - data) < header_size)
-		return 0;
+	return veorq_u8(xl, xr);
+}
 
-	data += header_size;
+static void transposeVertices(unsigned char* channels[4], const unsigned char* vertex_data, size_t vertex_size)
+{
+#define LOAD(r, i) r = vld1q_lane_u32(reinterpret_cast<const uint32_t*>(vertex_data + vertex_size * (i)), r, (i) & 3)
 
-	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
-	{
-		if (size_t(data_end - data) < kTailMaxSize)
-			return 0;
+	// 4 vertices per register, 4 bytes per vertex
+	uint32x4_t x0 = vdupq_n_u32(0), x1 = vdupq_n_u32(0), x2 = vdupq_n_u32(0), x3 = vdupq_n_u32(0);
 
-		size_t header_offset = i / kByteGroupSize;
+	LOAD(x0, 0), LOAD(x0, 1), LOAD(x0, 2), LOAD(x0, 3);
+	LOAD(x1, 4), LOAD(x1, 5), LOAD(x1, 6), LOAD(x1, 7);
+	LOAD(x2, 8), LOAD(x2, 9), LOAD(x2, 10), LOAD(x2, 11);
+	LOAD(x3, 12), LOAD(x3, 13), LOAD(x3, 14), LOAD(x3, 15);
 
-		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+#undef LOAD
 
-		data = decodeBytesGroup(data, buffer + i, bitslog2);
-	}
+	// each zip round interleaves bytes; after three rounds each 8-byte half holds one byte of 8 vertices
+	uint8x16x2_t t01 = vzipq_u8(vreinterpretq_u8_u32(x0), vreinterpretq_u8_u32(x1));
+	uint8x16x2_t t23 = vzipq_u8(vreinterpretq_u8_u32(x2), vreinterpretq_u8_u32(x3));
 
-	return data;
+	uint8x16x2_t u01 = vzipq_u8(t01.val[0], t01.val[1]);
+	uint8x16x2_t u23 = vzipq_u8(t23.val[0], t23.val[1]);
+
+	uint8x16x2_t w01 = vzipq_u8(u01.val[0], u01.val[1]);
+	uint8x16x2_t w23 = vzipq_u8(u23.val[0], u23.val[1]);
+
+	vst1q_u8(channels[0], vcombine_u8(vget_low_u8(w01.val[0]), vget_low_u8(w23.val[0])));
+	vst1q_u8(channels[1], vcombine_u8(vget_high_u8(w01.val[0]), vget_high_u8(w23.val[0])));
+	vst1q_u8(channels[2], vcombine_u8(vget_low_u8(w01.val[1]), vget_low_u8(w23.val[1])));
+	vst1q_u8(channels[3], vcombine_u8(vget_high_u8(w01.val[1]), vget_high_u8(w23.val[1])));
 }
 
-static const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+static void encodeDeltas(unsigned char* buffer, const unsigned char* channel, size_t count)
 {
-	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+	for (size_t i = 0; i < count; i += kByteGroupSize)
+	{
+		uint8x16_t prev = vld1q_u8(channel + i);
+		uint8x16_t curr = vld1q_u8(channel + i + 1);
+
+		vst1q_u8(buffer + i, zigzag8(vsubq_u8(curr, prev)));
+	}
+}
+#endif
+
+static unsigned char* encodeVertexBlockSimd(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+	assert(vertex_size % 4 == 0);
 
 	unsigned char buffer[kVertexBlockMaxSize];
-	unsigned char transposed[kVertexBlockSizeBytes];
+
+	// each channel stores the previous vertex byte followed by the block data, so that deltas can be computed with two loads
+	unsigned char channel_data[4][1 + kVertexBlockMaxSize];
+	unsigned char* channels[4] = {channel_data[0] + 1, channel_data[1] + 1, channel_data[2] + 1, channel_data[3] + 1};
 
 	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
 
-	for (size_t k = 0; k < vertex_size; ++k)
+	for (size_t k = 0; k < vertex_size; k += 4)
 	{
-		data = decodeBytes(data, data_end, buffer, vertex_count_aligned);
-		if (!data)
+		size_t i = 0;
+
+		// fast-path: transpose 16 vertices at a time
+		for (; i + kByteGroupSize <= vertex_count; i += kByteGroupSize)
+		{
+			unsigned char* group[4] = {channels[0] + i, channels[1] + i, channels[2] + i, channels[3] + i};
+
+			transposeVertices(group, vertex_data + i * vertex_size + k, vertex_size);
+		}
+
+		// slow-path: transpose remaining vertices and clear the padding
+		for (size_t j = 0; j < 4; ++j)
+		{
+			for (size_t v = i; v < vertex_count; ++v)
+				channels[j][v] = vertex_data[v * vertex_size + k + j];
+
+			memset(channels[j] + vertex_count, 0, vertex_count_aligned - vertex_count);
+
+			channel_data[j][0] = last_vertex[k + j];
+		}
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			encodeDeltas(buffer, channel_data[j], vertex_count_aligned);
+
+			// we sometimes encode elements we didn't fill when rounding to kByteGroupSize
+			memset(buffer + vertex_count, 0, vertex_count_aligned - vertex_count);
+
+			data = encodeBytes(data, data_end, buffer, vertex_count_aligned, true);
+			if (!data)
+				return 0;
+		}
+	}
+
+	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+struct EncodeVertexKernel
+{
+	bool simd;
+	const char* name;
+};
+
+#if defined(SIMD_SSE2)
+static const EncodeVertexKernel kEncodeVertexKernelSimd = {true, "sse2"};
+#elif defined(SIMD_NEON)
+static const EncodeVertexKernel kEncodeVertexKernelSimd = {true, "neon"};
+#endif
+
+static const EncodeVertexKernel kEncodeVertexKernelScalar = {false, "scalar"};
+
+// the scalar encoder is always available so that tests can validate the vectorized one against it via meshopt_encodeVertexBufferKernel
+#if defined(SIMD_SSE2) || defined(SIMD_NEON)
+static const EncodeVertexKernel kEncodeVertexKernels[] = {kEncodeVertexKernelSimd, kEncodeVertexKernelScalar};
+#else
+static const EncodeVertexKernel kEncodeVertexKernels[] = {kEncodeVertexKernelScalar};
+#endif
+
+static void encodeChannelDeltas(unsigned char* buffer, size_t buffer_stride, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const unsigned char last_vertex[4], int mode)
+{
+	unsigned int p = last_vertex[0] | (last_vertex[1] << 8) | (last_vertex[2] << 16) | (unsigned(last_vertex[3]) << 24);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const unsigned char* v = vertex_data + i * vertex_size;
+		unsigned int c = v[0] | (v[1] << 8) | (v[2] << 16) | (unsigned(v[3]) << 24);
+
+		unsigned int d = 0;
+
+		switch (mode)
+		{
+		case kChannelDelta8:
+			for (int j = 0; j < 32; j += 8)
+				d |= unsigned(zigzag8((unsigned char)((c >> j) - (p >> j)))) << j;
+			break;
+
+		case kChannelDelta16:
+			d = zigzag16((unsigned short)(c - p)) | (unsigned(zigzag16((unsigned short)((c >> 16) - (p >> 16)))) << 16);
+			break;
+
+		case kChannelXor32:
+			d = c ^ p;
+			break;
+
+		case kChannelDelta32:
+			d = zigzag32(c - p);
+			break;
+		}
+
+		for (int j = 0; j < 4; ++j)
+			buffer[j * buffer_stride + i] = (unsigned char)(d >> (j * 8));
+
+		p = c;
+	}
+}
+
+// encodes each group of 4 channels with the first mode_count predictors and keeps the smallest encoding; delta8_size receives the size of the block with byte deltas only
+static unsigned char* encodeChannelGroups(unsigned char* data, unsigned char* data_end, unsigned char* modes, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const unsigned char last_vertex[256], int mode_count, bool simd, size_t& delta8_size)
+{
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	// worst case encoding of 4 channels, plus the slack encodeBytes requires after each byte group
+	const size_t kChannelGroupMaxSize = 4 * ((kVertexBlockMaxSize / kByteGroupSize + 3) / 4 + kVertexBlockMaxSize) + kTailMaxSize;
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char scratch[2][kChannelGroupMaxSize];
+
+	memset(modes, 0, getChannelModeSize(vertex_size));
+	delta8_size = 0;
+
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		int best_mode = -1;
+		size_t best_size = 0;
+		int best_scratch = 0;
+
+		for (int mode = 0; mode < mode_count; ++mode)
+		{
+			encodeChannelDeltas(buffer, vertex_count_aligned, vertex_data + k, vertex_count, vertex_size, last_vertex + k, mode);
+
+			// we sometimes encode elements we didn't fill when rounding to kByteGroupSize
+			for (size_t j = 0; j < 4; ++j)
+				memset(buffer + j * vertex_count_aligned + vertex_count, 0, vertex_count_aligned - vertex_count);
+
+			// candidates are encoded into the scratch slot that doesn't hold the best encoding so far
+			int slot = best_mode < 0 ? 0 : 1 - best_scratch;
+
+			unsigned char* out = scratch[slot];
+			unsigned char* out_end = scratch[slot] + kChannelGroupMaxSize;
+
+			for (size_t j = 0; j < 4 && out; ++j)
+				out = encodeBytes(out, out_end, buffer + j * vertex_count_aligned, vertex_count_aligned, simd);
+
+			assert(out);
+
+			size_t size = out - scratch[slot];
+
+			if (mode == kChannelDelta8)
+				delta8_size += size;
+
+			// ties go to the simpler predictor, since byte deltas decode fastest
+			if (best_mode < 0 || size < best_size)
+			{
+				best_mode = mode;
+				best_size = size;
+				best_scratch = slot;
+			}
+		}
+
+		if (size_t(data_end - data) < best_size)
 			return 0;
 
-		size_t vertex_offset = k;
+		memcpy(data, scratch[best_scratch], best_size);
+		data += best_size;
 
-		unsigned char p = last_vertex[k];
+		modes[k / 16] |= (unsigned char)(best_mode << ((k / 4 % 4) * 2));
+	}
 
-		for (size_t i = 0; i < vertex_count; ++i)
+	return data;
+}
+
+static unsigned char* encodeVertexBlockLevel(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], int level, bool simd)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+	assert(vertex_size % 4 == 0);
+
+	unsigned char* modes = data;
+	size_t mode_size = getChannelModeSize(vertex_size);
+
+	if (size_t(data_end - data) < mode_size)
+		return 0;
+
+	unsigned char* groups = data + mode_size;
+
+	// level 1 only tries 16-bit deltas, which are the most common alternative for quantized data
+	int mode_count = level >= 2 ? 4 : 2;
+
+	size_t delta8_size = 0;
+	data = encodeChannelGroups(groups, data_end, modes, vertex_data, vertex_count, vertex_size, last_vertex, mode_count, simd, delta8_size);
+
+	// if the block didn't get enough smaller, re-encode it with byte deltas so that it decodes as fast as a level 0 block
+	if (data && size_t(data - groups) + delta8_size / kChannelModeMinGain > delta8_size)
+		data = encodeChannelGroups(groups, data_end, modes, vertex_data, vertex_count, vertex_size, last_vertex, 1, simd, delta8_size);
+
+	if (!data)
+		return 0;
+
+	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+
+#if defined(SIMD_FALLBACK) || !defined(SIMD_SSE)
+// reconstructs 4 channels that use a predictor other than byte deltas; buffer holds vertex_count_aligned bytes for each channel
+static void decodeDeltas4(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[4], int mode)
+{
+	unsigned int p = last_vertex[0] | (last_vertex[1] << 8) | (last_vertex[2] << 16) | (unsigned(last_vertex[3]) << 24);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int d = buffer[i] | (buffer[vertex_count_aligned + i] << 8) | (buffer[vertex_count_aligned * 2 + i] << 16) | (unsigned(buffer[vertex_count_aligned * 3 + i]) << 24);
+
+		switch (mode)
 		{
-			unsigned char v = unzigzag8(buffer[i]) + p;
+		case kChannelDelta16:
+			p = ((p + unzigzag16((unsigned short)d)) & 0xffff) | ((((p >> 16) + unzigzag16((unsigned short)(d >> 16))) & 0xffff) << 16);
+			break;
 
-			transposed[vertex_offset] = v;
-			p = v;
+		case kChannelXor32:
+			p ^= d;
+			break;
 
-			vertex_offset += vertex_size;
+		case kChannelDelta32:
+			p += unzigzag32(d);
+			break;
+
+		default:
+			assert(!"Unexpected channel mode");
+		}
+
+		unsigned char* v = transposed + i * vertex_size;
+
+		v[0] = (unsigned char)(p >> 0);
+		v[1] = (unsigned char)(p >> 8);
+		v[2] = (unsigned char)(p >> 16);
+		v[3] = (unsigned char)(p >> 24);
+	}
+}
+#endif
+
+#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON))
+static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2)
+{
+#define READ() byte = *data++
+#define NEXT(bits) enc = byte >> (8 - bits), byte <<= bits, encv = *data_var, *buffer++ = (enc == (1 << bits) - 1) ? encv : enc, data_var += (enc == (1 << bits) - 1)
+
+	unsigned char byte, enc, encv;
+	const unsigned char* data_var;
+
+	switch (bitslog2)
+	{
+	case 0:
+		memset(buffer, 0, kByteGroupSize);
+		return data;
+	case 1:
+		data_var = data + 4;
+
+		// 4 groups with 4 2-bit values in each byte
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+		READ(), NEXT(2), NEXT(2), NEXT(2), NEXT(2);
+
+		return data_var;
+	case 2:
+		data_var = data + 8;
+
+		// 8 groups with 2 4-bit values in each byte
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+		READ(), NEXT(4), NEXT(4);
+
+		return data_var;
+	case 3:
+		memcpy(buffer, data, kByteGroupSize);
+		return data + kByteGroupSize;
+	default:
+		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
+		return data;
+	}
+
+#undef READ
+#undef NEXT
+}
+
+static const unsigned char* decodeBytes(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroup(data, buffer + i, bitslog2);
+	}
+
+	return data;
+}
+
+static const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_stride, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], const unsigned char* modes)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = decodeBytes(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+
+		int mode = getChannelMode(modes, k);
+
+		if (mode != kChannelDelta8)
+		{
+			decodeDeltas4(buffer, transposed + k, vertex_count, vertex_count_aligned, vertex_size, last_vertex + k, mode);
+			continue;
+		}
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			size_t vertex_offset = k + j;
+
+			unsigned char p = last_vertex[k + j];
+
+			for (size_t i = 0; i < vertex_count; ++i)
+			{
+				unsigned char v = unzigzag8(buffer[j * vertex_count_aligned + i]) + p;
+
+				transposed[vertex_offset] = v;
+				p = v;
+
+				vertex_offset += vertex_size;
+			}
 		}
 	}
 
-	memcpy(vertex_data, transposed, vertex_count * vertex_size);
+	writeVertices(vertex_data, vertex_stride, transposed, vertex_count, vertex_size);
 
 	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
 
@@ -365,6 +1050,7 @@ static bool gDecodeBytesGroupInitialized = decodeBytesGroupBuildTables();
 #endif
 
 #ifdef SIMD_SSE
+SIMD_TARGET
 static __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 {
 	__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeBytesGroupShuffle[mask0]));
@@ -376,6 +1062,7 @@ static __m128i decodeShuffleMask(unsigned char mask0, unsigned char mask1)
 	return _mm_unpacklo_epi64(sm0, sm1r);
 }
 
+SIMD_TARGET
 static void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
 {
 	__m128i t0 = _mm_unpacklo_epi8(x0, x1);
@@ -389,6 +1076,7 @@ static void transpose8(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3)
 	x3 = _mm_unpackhi_epi16(t1, t3);
 }
 
+SIMD_TARGET
 static __m128i unzigzag8(__m128i v)
 {
 	__m128i xl = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1)));
@@ -397,6 +1085,7 @@ static __m128i unzigzag8(__m128i v)
 	return _mm_xor_si128(xl, xr);
 }
 
+SIMD_TARGET
 static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsigned char* buffer, int bitslog2)
 {
 	switch (bitslog2)
@@ -599,6 +1288,7 @@ static const unsigned char* decodeBytesGroupSimd(const unsigned char* data, unsi
 #endif
 
 #if defined(SIMD_SSE) || defined(SIMD_NEON)
+SIMD_TARGET
 static const unsigned char* decodeBytesSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
 {
 	assert(buffer_size % kByteGroupSize == 0);
@@ -644,24 +1334,9 @@ static const unsigned char* decodeBytesSimd(const unsigned char* data, const uns
 	return data;
 }
 
-static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+SIMD_TARGET
+static void decodeDeltas4Simd(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[4])
 {
-	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
-
-	unsigned char buffer[kVertexBlockMaxSize * 4];
-	unsigned char transposed[kVertexBlockSizeBytes];
-
-	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
-
-	for (size_t k = 0; k < vertex_size; k += 4)
-	{
-		for (size_t j = 0; j < 4; ++j)
-		{
-			data = decodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
-			if (!data)
-				return 0;
-		}
-
 #ifdef SIMD_SSE
 #define TEMP __m128i
 #define LOAD(i) __m128i r##i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))
@@ -679,195 +1354,1602 @@ static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, con
 #endif
 
 #ifdef SIMD_SSE
-		__m128i pi = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(last_vertex + k));
+	__m128i pi = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(last_vertex));
 #endif
 #ifdef SIMD_NEON
-		uint8x8_t pi = vreinterpret_u8_u32(vld1_lane_u32(reinterpret_cast<uint32_t*>(last_vertex + k), vdup_n_u32(0), 0));
+	uint8x8_t pi = vreinterpret_u8_u32(vld1_lane_u32(reinterpret_cast<uint32_t*>(last_vertex), vdup_n_u32(0), 0));
 #endif
 
-		unsigned char* savep = transposed + k;
+	unsigned char* savep = transposed;
 
-		for (size_t j = 0; j < vertex_count_aligned; j += 16)
-		{
-			LOAD(0);
-			LOAD(1);
-			LOAD(2);
-			LOAD(3);
+	for (size_t j = 0; j < vertex_count_aligned; j += 16)
+	{
+		LOAD(0);
+		LOAD(1);
+		LOAD(2);
+		LOAD(3);
 
-			r0 = unzigzag8(r0);
-			r1 = unzigzag8(r1);
-			r2 = unzigzag8(r2);
-			r3 = unzigzag8(r3);
+		r0 = unzigzag8(r0);
+		r1 = unzigzag8(r1);
+		r2 = unzigzag8(r2);
+		r3 = unzigzag8(r3);
 
-			transpose8(r0, r1, r2, r3);
+		transpose8(r0, r1, r2, r3);
 
-			TEMP t0, t1, t2, t3;
+		TEMP t0, t1, t2, t3;
 
-			GRP4(0);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
-			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+		GRP4(0);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
 
-			GRP4(1);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
-			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+		GRP4(1);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
 
-			GRP4(2);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
-			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+		GRP4(2);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
 
-			GRP4(3);
-			FIXD(0), FIXD(1), FIXD(2), FIXD(3);
-			SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+		GRP4(3);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+	}
 
 #undef TEMP
 #undef LOAD
 #undef GRP4
 #undef FIXD
 #undef SAVE
-		}
-	}
-
-	memcpy(vertex_data, transposed, vertex_count * vertex_size);
-
-	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
-
-	return data;
 }
-#endif
 
-} // namespace meshopt
+#ifdef SIMD_SSE
+// unzigzag runs after the transpose, when each 32-bit lane holds 4 bytes of one vertex
+template <int Mode>
+SIMD_TARGET static __m128i decodeUnzigzag(__m128i v)
+{
+	switch (Mode)
+	{
+	case kChannelDelta8:
+		return unzigzag8(v);
+	case kChannelDelta16:
+		return _mm_xor_si128(_mm_srli_epi16(v, 1), _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi16(1))));
+	case kChannelXor32:
+		return v;
+	default:
+		return _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi32(1))));
+	}
+}
+
+template <int Mode>
+SIMD_TARGET static __m128i decodeDelta(__m128i p, __m128i v)
+{
+	switch (Mode)
+	{
+	case kChannelDelta8:
+		return _mm_add_epi8(p, v);
+	case kChannelDelta16:
+		return _mm_add_epi16(p, v);
+	case kChannelXor32:
+		return _mm_xor_si128(p, v);
+	default:
+		return _mm_add_epi32(p, v);
+	}
+}
+
+// same as decodeDeltas4Simd, but reconstructs vertices using the given predictor
+template <int Mode>
+SIMD_TARGET static void decodeDeltas4ModeSimd(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[4])
+{
+#define LOAD(i) __m128i r##i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))
+#define GRP4(i) t0 = _mm_shuffle_epi32(r##i, 0), t1 = _mm_shuffle_epi32(r##i, 1), t2 = _mm_shuffle_epi32(r##i, 2), t3 = _mm_shuffle_epi32(r##i, 3)
+#define FIXD(i) t##i = pi = decodeDelta<Mode>(pi, t##i)
+#define SAVE(i) *reinterpret_cast<int*>(savep) = _mm_cvtsi128_si32(t##i), savep += vertex_size
+
+	__m128i pi = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(last_vertex));
+
+	unsigned char* savep = transposed;
+
+	for (size_t j = 0; j < vertex_count_aligned; j += 16)
+	{
+		LOAD(0);
+		LOAD(1);
+		LOAD(2);
+		LOAD(3);
+
+		transpose8(r0, r1, r2, r3);
+
+		r0 = decodeUnzigzag<Mode>(r0);
+		r1 = decodeUnzigzag<Mode>(r1);
+		r2 = decodeUnzigzag<Mode>(r2);
+		r3 = decodeUnzigzag<Mode>(r3);
+
+		__m128i t0, t1, t2, t3;
+
+		GRP4(0);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(1);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(2);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(3);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+	}
+
+#undef LOAD
+#undef GRP4
+#undef FIXD
+#undef SAVE
+}
+
+SIMD_TARGET
+static void decodeDeltas4ModeSimd(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[4], int mode)
+{
+	switch (mode)
+	{
+	case kChannelDelta8:
+		decodeDeltas4ModeSimd<kChannelDelta8>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+
+	case kChannelDelta16:
+		decodeDeltas4ModeSimd<kChannelDelta16>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+
+	case kChannelXor32:
+		decodeDeltas4ModeSimd<kChannelXor32>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+
+	default:
+		decodeDeltas4ModeSimd<kChannelDelta32>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+	}
+}
+#endif
+
+SIMD_TARGET
+static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_stride, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], const unsigned char* modes)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = decodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+
+		int mode = getChannelMode(modes, k);
+
+		if (mode == kChannelDelta8)
+			decodeDeltas4Simd(buffer, transposed + k, vertex_count_aligned, vertex_size, last_vertex + k);
+		else
+#ifdef SIMD_SSE
+			decodeDeltas4ModeSimd(buffer, transposed + k, vertex_count_aligned, vertex_size, last_vertex + k, mode);
+#else
+			decodeDeltas4(buffer, transposed + k, vertex_count, vertex_count_aligned, vertex_size, last_vertex + k, mode);
+#endif
+	}
+
+	writeVertices(vertex_data, vertex_stride, transposed, vertex_count, vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+#ifdef SIMD_AVX2
+SIMD_TARGET_AVX2
+static void transpose8(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3)
+{
+	__m256i t0 = _mm256_unpacklo_epi8(x0, x1);
+	__m256i t1 = _mm256_unpackhi_epi8(x0, x1);
+	__m256i t2 = _mm256_unpacklo_epi8(x2, x3);
+	__m256i t3 = _mm256_unpackhi_epi8(x2, x3);
+
+	x0 = _mm256_unpacklo_epi16(t0, t2);
+	x1 = _mm256_unpackhi_epi16(t0, t2);
+	x2 = _mm256_unpacklo_epi16(t1, t3);
+	x3 = _mm256_unpackhi_epi16(t1, t3);
+}
+
+SIMD_TARGET_AVX2
+static __m256i unzigzag8(__m256i v)
+{
+	__m256i xl = _mm256_sub_epi8(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi8(1)));
+	__m256i xr = _mm256_and_si256(_mm256_srli_epi16(v, 1), _mm256_set1_epi8(127));
+
+	return _mm256_xor_si256(xl, xr);
+}
+
+// decodes deltas for 8 byte channels at once: channels k..k+3 go to the low 128-bit lane and k+4..k+7 to the high lane
+// this halves the length of the serial prefix sum chain compared to decodeDeltas4Simd
+SIMD_TARGET_AVX2
+static void decodeDeltas8Avx2(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[8])
+{
+#define LOAD(i) __m256i r##i = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + (i + 4) * vertex_count_aligned)), 1)
+#define GRP4(i) lo = _mm256_castsi256_si128(r##i), hi = _mm256_extracti128_si256(r##i, 1), t0 = _mm_unpacklo_epi32(lo, hi), t1 = _mm_unpackhi_epi64(t0, t0), t2 = _mm_unpackhi_epi32(lo, hi), t3 = _mm_unpackhi_epi64(t2, t2)
+#define FIXD(i) t##i = pi = _mm_add_epi8(pi, t##i)
+#define SAVE(i) _mm_storel_epi64(reinterpret_cast<__m128i*>(savep), t##i), savep += vertex_size
+
+	__m128i pi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(last_vertex));
+
+	unsigned char* savep = transposed;
+
+	for (size_t j = 0; j < vertex_count_aligned; j += 16)
+	{
+		LOAD(0);
+		LOAD(1);
+		LOAD(2);
+		LOAD(3);
+
+		r0 = unzigzag8(r0);
+		r1 = unzigzag8(r1);
+		r2 = unzigzag8(r2);
+		r3 = unzigzag8(r3);
+
+		transpose8(r0, r1, r2, r3);
+
+		__m128i lo, hi, t0, t1, t2, t3;
+
+		GRP4(0);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(1);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(2);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(3);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+	}
+
+#undef LOAD
+#undef GRP4
+#undef FIXD
+#undef SAVE
+}
+
+template <int Mode>
+SIMD_TARGET_AVX2 static __m256i decodeUnzigzag(__m256i v)
+{
+	switch (Mode)
+	{
+	case kChannelDelta8:
+		return unzigzag8(v);
+	case kChannelDelta16:
+		return _mm256_xor_si256(_mm256_srli_epi16(v, 1), _mm256_sub_epi16(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi16(1))));
+	case kChannelXor32:
+		return v;
+	default:
+		return _mm256_xor_si256(_mm256_srli_epi32(v, 1), _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi32(1))));
+	}
+}
+
+// same as decodeDeltas8Avx2, but reconstructs channels k..k+3 and k+4..k+7 using the given predictors
+// when the predictors differ, each runs its own chain over the whole vertex and the matching 32-bit half is kept, which keeps the blend off the chain
+template <int Mode0, int Mode1>
+SIMD_TARGET_AVX2 static void decodeDeltas8ModeAvx2(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[8])
+{
+#define LOAD(i) __m256i r##i = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + i * vertex_count_aligned))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + j + (i + 4) * vertex_count_aligned)), 1)
+#define UNZZ(i) r##i = (Mode0 == Mode1) ? decodeUnzigzag<Mode0>(r##i) : _mm256_blend_epi32(decodeUnzigzag<Mode0>(r##i), decodeUnzigzag<Mode1>(r##i), 0xf0)
+#define GRP4(i) lo = _mm256_castsi256_si128(r##i), hi = _mm256_extracti128_si256(r##i, 1), t0 = _mm_unpacklo_epi32(lo, hi), t1 = _mm_unpackhi_epi64(t0, t0), t2 = _mm_unpackhi_epi32(lo, hi), t3 = _mm_unpackhi_epi64(t2, t2)
+#define FIXD(i) t##i = (Mode0 == Mode1) ? (p0 = decodeDelta<Mode0>(p0, t##i)) : _mm_blend_epi32(p0 = decodeDelta<Mode0>(p0, t##i), p1 = decodeDelta<Mode1>(p1, t##i), 0xa)
+#define SAVE(i) _mm_storel_epi64(reinterpret_cast<__m128i*>(savep), t##i), savep += vertex_size
+
+	__m128i p0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(last_vertex));
+	__m128i p1 = p0;
+
+	unsigned char* savep = transposed;
+
+	for (size_t j = 0; j < vertex_count_aligned; j += 16)
+	{
+		LOAD(0);
+		LOAD(1);
+		LOAD(2);
+		LOAD(3);
+
+		transpose8(r0, r1, r2, r3);
+
+		UNZZ(0);
+		UNZZ(1);
+		UNZZ(2);
+		UNZZ(3);
+
+		__m128i lo, hi, t0, t1, t2, t3;
+
+		GRP4(0);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(1);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(2);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+
+		GRP4(3);
+		FIXD(0), FIXD(1), FIXD(2), FIXD(3);
+		SAVE(0), SAVE(1), SAVE(2), SAVE(3);
+	}
+
+#undef LOAD
+#undef UNZZ
+#undef GRP4
+#undef FIXD
+#undef SAVE
+}
+
+template <int Mode0>
+SIMD_TARGET_AVX2 static void decodeDeltas8ModeAvx2(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[8], int mode1)
+{
+	switch (mode1)
+	{
+	case kChannelDelta8:
+		decodeDeltas8ModeAvx2<Mode0, kChannelDelta8>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+
+	case kChannelDelta16:
+		decodeDeltas8ModeAvx2<Mode0, kChannelDelta16>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+
+	case kChannelXor32:
+		decodeDeltas8ModeAvx2<Mode0, kChannelXor32>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+
+	default:
+		decodeDeltas8ModeAvx2<Mode0, kChannelDelta32>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex);
+		break;
+	}
+}
+
+SIMD_TARGET_AVX2
+static void decodeDeltas8ModeAvx2(const unsigned char* buffer, unsigned char* transposed, size_t vertex_count_aligned, size_t vertex_size, unsigned char last_vertex[8], int mode0, int mode1)
+{
+	switch (mode0)
+	{
+	case kChannelDelta8:
+		decodeDeltas8ModeAvx2<kChannelDelta8>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex, mode1);
+		break;
+
+	case kChannelDelta16:
+		decodeDeltas8ModeAvx2<kChannelDelta16>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex, mode1);
+		break;
+
+	case kChannelXor32:
+		decodeDeltas8ModeAvx2<kChannelXor32>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex, mode1);
+		break;
+
+	default:
+		decodeDeltas8ModeAvx2<kChannelDelta32>(buffer, transposed, vertex_count_aligned, vertex_size, last_vertex, mode1);
+		break;
+	}
+}
+
+typedef const unsigned char* (*DecodeBytesFn)(const unsigned char*, const unsigned char*, unsigned char*, size_t);
+
+SIMD_TARGET_AVX2
+static const unsigned char* decodeVertexBlockAvx2(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_stride, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], const unsigned char* modes, DecodeBytesFn decode)
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 8];
+	unsigned char transposed[kVertexBlockSizeBytes];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+	for (size_t k = 0; k < vertex_size;)
+	{
+		// vertex size is a multiple of 4, so we might need to process the last 4 channels separately
+		size_t channels = (k + 8 <= vertex_size) ? 8 : 4;
+
+		for (size_t j = 0; j < channels; ++j)
+		{
+			data = decode(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return 0;
+		}
+
+		int mode0 = getChannelMode(modes, k);
+		int mode1 = channels == 8 ? getChannelMode(modes, k + 4) : kChannelDelta8;
+
+		if (channels == 8 && mode0 == kChannelDelta8 && mode1 == kChannelDelta8)
+			decodeDeltas8Avx2(buffer, transposed + k, vertex_count_aligned, vertex_size, last_vertex + k);
+		else if (channels == 8)
+			decodeDeltas8ModeAvx2(buffer, transposed + k, vertex_count_aligned, vertex_size, last_vertex + k, mode0, mode1);
+		else if (mode0 == kChannelDelta8)
+			decodeDeltas4Simd(buffer, transposed + k, vertex_count_aligned, vertex_size, last_vertex + k);
+		else
+			decodeDeltas4ModeSimd(buffer, transposed + k, vertex_count_aligned, vertex_size, last_vertex + k, mode0);
+
+		k += channels;
+	}
+
+	writeVertices(vertex_data, vertex_stride, transposed, vertex_count, vertex_size);
+
+	memcpy(last_vertex, &transposed[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+
+SIMD_TARGET_AVX2
+static const unsigned char* decodeVertexBlockAvx2(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_stride, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], const unsigned char* modes)
+{
+	return decodeVertexBlockAvx2(data, data_end, vertex_data, vertex_stride, vertex_count, vertex_size, last_vertex, modes, decodeBytesSimd);
+}
+#endif
+
+#ifdef SIMD_AVX512
+// byte groups are expanded directly using the decoded selector mask, which removes the shuffle table lookups
+SIMD_TARGET_AVX512
+static const unsigned char* decodeBytesGroupAvx512(const unsigned char* data, unsigned char* buffer, int bitslog2)
+{
+	switch (bitslog2)
+	{
+	case 0:
+	{
+		__m128i result = _mm_setzero_si128();
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data;
+	}
+
+	case 1:
+	{
+		__m128i sel2 = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(data));
+		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4));
+
+		__m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+		__m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+		__m128i sel = _mm_and_si128(sel2222, _mm_set1_epi8(3));
+
+		__mmask16 mask = _mm_cmpeq_epi8_mask(sel, _mm_set1_epi8(3));
+
+		__m128i result = _mm_mask_expand_epi8(sel, mask, rest);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data + 4 + _mm_popcnt_u32(mask);
+	}
+
+	case 2:
+	{
+		__m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8));
+
+		__m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+		__m128i sel = _mm_and_si128(sel44, _mm_set1_epi8(15));
+
+		__mmask16 mask = _mm_cmpeq_epi8_mask(sel, _mm_set1_epi8(15));
+
+		__m128i result = _mm_mask_expand_epi8(sel, mask, rest);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data + 8 + _mm_popcnt_u32(mask);
+	}
+
+	case 3:
+	{
+		__m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+		__m128i result = rest;
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+		return data + 16;
+	}
+
+	default:
+		assert(!"Unexpected bit length"); // This can never happen since bitslog2 is a 2-bit value
+		return data;
+	}
+}
+
+SIMD_TARGET_AVX512
+static const unsigned char* decodeBytesAvx512(const unsigned char* data, const unsigned char* data_end, unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
+
+	const unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return 0;
+
+	data += header_size;
+
+	size_t i = 0;
+
+	// fast-path: process 4 groups at a time, do a shared bounds check - each group reads <=32b
+	for (; i + kByteGroupSize * 4 <= buffer_size && size_t(data_end - data) >= kTailMaxSize * 4; i += kByteGroupSize * 4)
+	{
+		size_t header_offset = i / kByteGroupSize;
+		unsigned char header_byte = header[header_offset / 4];
+
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 0, (header_byte >> 0) & 3);
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 1, (header_byte >> 2) & 3);
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 2, (header_byte >> 4) & 3);
+		data = decodeBytesGroupAvx512(data, buffer + i + kByteGroupSize * 3, (header_byte >> 6) & 3);
+	}
+
+	// slow-path: process remaining groups
+	for (; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kTailMaxSize)
+			return 0;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		int bitslog2 = (header[header_offset / 4] >> ((header_offset % 4) * 2)) & 3;
+
+		data = decodeBytesGroupAvx512(data, buffer + i, bitslog2);
+	}
+
+	return data;
+}
+
+SIMD_TARGET_AVX2
+static const unsigned char* decodeVertexBlockAvx512(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_stride, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], const unsigned char* modes)
+{
+	return decodeVertexBlockAvx2(data, data_end, vertex_data, vertex_stride, vertex_count, vertex_size, last_vertex, modes, decodeBytesAvx512);
+}
+#endif
+
+#ifdef SIMD_SSE
+static void getCpuInfo(int info[4], int level)
+{
+#if defined(_MSC_VER) && defined(SIMD_AVX2)
+	__cpuidex(info, level, 0);
+#elif defined(_MSC_VER)
+	__cpuid(info, level);
+#else
+	__cpuid_count(level, 0, info[0], info[1], info[2], info[3]);
+#endif
+}
+#endif
+
+#ifdef SIMD_AVX2
+static unsigned int getXcr0()
+{
+#ifdef _MSC_VER
+	return unsigned(_xgetbv(0));
+#else
+	unsigned int eax, edx;
+	__asm__ __volatile__("xgetbv"
+	                     : "=a"(eax), "=d"(edx)
+	                     : "c"(0));
+	return eax;
+#endif
+}
+#endif
+
+typedef const unsigned char* (*DecodeVertexBlockFn)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, size_t, unsigned char[256], const unsigned char*);
+typedef void (*DecodeFilterFn)(void*, size_t, size_t);
+
+struct DecodeVertexKernel
+{
+	DecodeVertexBlockFn decode;
+	const char* name;
+};
+
+struct DecodeVertexKernels
+{
+	DecodeVertexKernel kernels[4];
+	size_t count;
+};
+
+static void addDecodeVertexKernel(DecodeVertexKernels& result, DecodeVertexBlockFn decode, const char* name)
+{
+	assert(result.count < sizeof(result.kernels) / sizeof(result.kernels[0]));
+
+	DecodeVertexKernel kernel = {decode, name};
+	result.kernels[result.count++] = kernel;
+}
+
+// returns all implementations supported by the current CPU, best first; each one is compiled only when it can be selected
+static DecodeVertexKernels selectDecodeVertexKernels()
+{
+	DecodeVertexKernels result = {};
+
+#ifdef SIMD_SSE
+	int cpuinfo[4] = {};
+	getCpuInfo(cpuinfo, 0);
+
+	int max_level = cpuinfo[0];
+
+	getCpuInfo(cpuinfo, 1);
+
+	bool ssse3 = (cpuinfo[2] & (1 << 9)) != 0;
+
+#ifdef SIMD_AVX2
+	// AVX requires OS support for saving YMM state (OSXSAVE + XCR0 bits 1-2); AVX-512 additionally needs opmask/ZMM state (XCR0 bits 5-7)
+	bool osavx = (cpuinfo[2] & (1 << 27)) && (cpuinfo[2] & (1 << 28));
+	unsigned int xcr0 = osavx ? getXcr0() : 0;
+
+	int cpuinfo7[4] = {};
+	if (max_level >= 7)
+		getCpuInfo(cpuinfo7, 7);
+
+	bool avx2 = (xcr0 & 0x6) == 0x6 && (cpuinfo7[1] & (1 << 5));
+
+#ifdef SIMD_AVX512
+	unsigned int avx512_ebx = (1u << 16) | (1u << 30) | (1u << 31); // AVX512F, AVX512BW, AVX512VL
+	unsigned int avx512_ecx = 1u << 6;                              // AVX512_VBMI2
+
+	bool avx512 = avx2 && (xcr0 & 0xe6) == 0xe6 && (unsigned(cpuinfo7[1]) & avx512_ebx) == avx512_ebx && (unsigned(cpuinfo7[2]) & avx512_ecx) == avx512_ecx;
+
+	if (avx512)
+		addDecodeVertexKernel(result, decodeVertexBlockAvx512, "avx512");
+#endif
+
+	if (avx2)
+		addDecodeVertexKernel(result, decodeVertexBlockAvx2, "avx2");
+#else
+	(void)max_level;
+#endif
+
+#ifdef SIMD_FALLBACK
+	if (ssse3)
+		addDecodeVertexKernel(result, decodeVertexBlockSimd, "ssse3");
+
+	addDecodeVertexKernel(result, decodeVertexBlock, "scalar");
+#else
+	(void)ssse3;
+
+	addDecodeVertexKernel(result, decodeVertexBlockSimd, "ssse3");
+#endif
+#elif defined(SIMD_NEON)
+	addDecodeVertexKernel(result, decodeVertexBlockSimd, "neon");
+#else
+	addDecodeVertexKernel(result, decodeVertexBlock, "scalar");
+#endif
+
+	return result;
+}
+
+static const DecodeVertexKernels gDecodeVertexKernels = selectDecodeVertexKernels();
+
+static size_t getVertexSegmentSize(size_t vertex_size)
+{
+	return getVertexBlockSize(vertex_size) * kVertexSegmentBlocks;
+}
+
+// segment sizes are stored as 32-bit values; returns false instead of truncating values that don't fit
+static bool writeUint32(unsigned char* data, size_t value)
+{
+	if (value != unsigned(value))
+		return false;
+
+	data[0] = (unsigned char)(value >> 0);
+	data[1] = (unsigned char)(value >> 8);
+	data[2] = (unsigned char)(value >> 16);
+	data[3] = (unsigned char)(value >> 24);
+
+	return true;
+}
+
+static size_t readUint32(const unsigned char* data)
+{
+	return size_t(data[0]) | (size_t(data[1]) << 8) | (size_t(data[2]) << 16) | (size_t(data[3]) << 24);
+}
+
+static unsigned char* encodeVertexBlocks(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], int level, bool simd)
+{
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		if (level > 0)
+			data = encodeVertexBlockLevel(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex, level, simd);
+#if defined(SIMD_SSE2) || defined(SIMD_NEON)
+		else if (simd)
+			data = encodeVertexBlockSimd(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+#endif
+		else
+			data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+
+		if (!data)
+			return 0;
+
+		vertex_offset += block_size;
+	}
+
+	return data;
+}
+
+static unsigned char* encodeVertexTail(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_size)
+{
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (size_t(data_end - data) < tail_size)
+		return 0;
+
+	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
+	if (vertex_size < kTailMaxSize)
+	{
+		memset(data, 0, kTailMaxSize - vertex_size);
+		data += kTailMaxSize - vertex_size;
+	}
+
+	memcpy(data, vertex_data, vertex_size);
+	data += vertex_size;
+
+	return data;
+}
+
+static const unsigned char* decodeVertexBlocks(const unsigned char* data, const unsigned char* data_end, unsigned char* vertex_data, size_t vertex_stride, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256], DecodeVertexBlockFn decode, DecodeFilterFn filter, int version)
+{
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t mode_size = (version == 2) ? getChannelModeSize(vertex_size) : 0;
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		const unsigned char* modes = 0;
+
+		if (mode_size)
+		{
+			if (size_t(data_end - data) < mode_size)
+				return 0;
+
+			modes = data;
+			data += mode_size;
+		}
+
+		data = decode(data, data_end, vertex_data + vertex_offset * vertex_stride, vertex_stride, block_size, vertex_size, last_vertex, modes);
+		if (!data)
+			return 0;
+
+		// filters run on each block right after it's decoded, while it's still in cache; delta decoding doesn't read the output back
+		if (filter)
+			filter(vertex_data + vertex_offset * vertex_stride, block_size, vertex_size);
+
+		vertex_offset += block_size;
+	}
+
+	return data;
+}
+
+struct VertexSegmentDecoder
+{
+	unsigned char* vertex_data;
+	size_t vertex_stride;
+	size_t vertex_count;
+	size_t vertex_size;
+	size_t segment_size;
+	size_t segment_count;
+
+	const unsigned char* buffer;
+	size_t buffer_size;
+	const size_t* segment_ends; // offset of the size field that terminates each segment
+
+	DecodeVertexBlockFn decode;
+	DecodeFilterFn filter;
+
+	int* results;
+};
+
+static int decodeVertexSegment(const VertexSegmentDecoder& decoder, size_t index)
+{
+	assert(index < decoder.segment_count);
+
+	// first segment immediately follows the header and the first vertex; other segments follow the size field of the previous segment
+	size_t begin = (index == 0) ? 1 + decoder.vertex_size : decoder.segment_ends[index - 1] + 4;
+	size_t end = decoder.segment_ends[index];
+
+	// each segment restarts delta coding from the first vertex of the stream
+	unsigned char last_vertex[256];
+	memcpy(last_vertex, decoder.buffer + 1, decoder.vertex_size);
+
+	size_t vertex_offset = index * decoder.segment_size;
+	size_t segment_vertices = (vertex_offset + decoder.segment_size < decoder.vertex_count) ? decoder.segment_size : decoder.vertex_count - vertex_offset;
+
+	// note: blocks are allowed to read past the segment end since the stream always has enough trailing data
+	const unsigned char* data = decodeVertexBlocks(decoder.buffer + begin, decoder.buffer + decoder.buffer_size, decoder.vertex_data + vertex_offset * decoder.vertex_stride, decoder.vertex_stride, segment_vertices, decoder.vertex_size, last_vertex, decoder.decode, decoder.filter, 1);
+	if (!data)
+		return -2;
+
+	if (data != decoder.buffer + end)
+		return -3;
+
+	return 0;
+}
+
+static void decodeVertexSegmentTask(void* task_data, size_t index)
+{
+	VertexSegmentDecoder* decoder = static_cast<VertexSegmentDecoder*>(task_data);
+
+	decoder->results[index] = decodeVertexSegment(*decoder, index);
+}
+
+static int decodeVertexBufferData(void* destination, size_t vertex_stride, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_ParallelFor parallel_for, void* context, DecodeFilterFn filter, DecodeVertexBlockFn decode)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(vertex_stride >= vertex_size);
+	assert(!filter || vertex_stride == vertex_size);
+	assert(decode);
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+	assert(gDecodeBytesGroupInitialized);
+#endif
+
+	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return -2;
+
+	unsigned char header = *data++;
+
+	if ((header & 0xf0) != kVertexHeader)
+		return -1;
+
+	int version = header & 0x0f;
+	if (version > 2)
+		return -1;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	// version 2 streams use the version 0 layout, with predictor modes at the start of each block
+	if (version != 1)
+	{
+		unsigned char last_vertex[256];
+		memcpy(last_vertex, data_end - vertex_size, vertex_size);
+
+		data = decodeVertexBlocks(data, data_end, vertex_data, vertex_stride, vertex_count, vertex_size, last_vertex, decode, filter, version);
+		if (!data)
+			return -2;
+
+		if (size_t(data_end - data) != tail_size)
+			return -3;
+
+		return 0;
+	}
+
+	// the first vertex follows the header so that the stream can be decoded before the tail arrives
+	if (size_t(data_end - data) < vertex_size + tail_size)
+		return -2;
+
+	const unsigned char* first_vertex = data;
+	data += vertex_size;
+
+	size_t segment_size = getVertexSegmentSize(vertex_size);
+	size_t segment_count = (vertex_count + segment_size - 1) / segment_size;
+
+	if (parallel_for && segment_count > 1)
+	{
+		// segment sizes are stored after each segment, so segment boundaries are recovered by walking the sizes back from the tail
+		meshopt_Buffer<size_t> segment_ends(segment_count);
+
+		size_t data_begin = 1 + vertex_size;
+		size_t offset = buffer_size - tail_size;
+
+		for (size_t i = segment_count; i > 0; --i)
+		{
+			if (offset < data_begin + 4)
+				return -3;
+
+			size_t segment_bytes = readUint32(buffer + offset - 4);
+
+			if (segment_bytes > offset - 4 - data_begin)
+				return -3;
+
+			segment_ends[i - 1] = offset - 4;
+			offset -= 4 + segment_bytes;
+		}
+
+		if (offset != data_begin)
+			return -3;
+
+		meshopt_Buffer<int> results(segment_count);
+		memset(results.data, 0, segment_count * sizeof(int));
+
+		VertexSegmentDecoder decoder = {};
+		decoder.vertex_data = vertex_data;
+		decoder.vertex_stride = vertex_stride;
+		decoder.vertex_count = vertex_count;
+		decoder.vertex_size = vertex_size;
+		decoder.segment_size = segment_size;
+		decoder.segment_count = segment_count;
+		decoder.buffer = buffer;
+		decoder.buffer_size = buffer_size;
+		decoder.segment_ends = segment_ends.data;
+		decoder.decode = decode;
+		decoder.filter = filter;
+		decoder.results = results.data;
+
+		parallel_for(context, decodeVertexSegmentTask, &decoder, segment_count);
+
+		for (size_t i = 0; i < segment_count; ++i)
+			if (results[i] != 0)
+				return results[i];
+
+		return 0;
+	}
+
+	for (size_t i = 0; i < segment_count; ++i)
+	{
+		size_t vertex_offset = i * segment_size;
+		size_t segment_vertices = (vertex_offset + segment_size < vertex_count) ? segment_size : vertex_count - vertex_offset;
+
+		// each segment restarts delta coding from the first vertex of the stream
+		unsigned char last_vertex[256];
+		memcpy(last_vertex, first_vertex, vertex_size);
+
+		const unsigned char* segment = data;
+
+		data = decodeVertexBlocks(data, data_end, vertex_data + vertex_offset * vertex_stride, vertex_stride, segment_vertices, vertex_size, last_vertex, decode, filter, version);
+		if (!data)
+			return -2;
+
+		if (size_t(data_end - data) < 4 + tail_size)
+			return -2;
+
+		if (readUint32(data) != size_t(data - segment))
+			return -3;
+
+		data += 4;
+	}
+
+	if (size_t(data_end - data) != tail_size)
+		return -3;
+
+	return 0;
+}
+
+static int decodeVertexBufferImpl(void* destination, size_t vertex_stride, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_ParallelFor parallel_for, void* context, DecodeFilterFn filter)
+{
+	meshopt_Instrumentation<void>::report("decodeVertexBuffer", "start", vertex_count);
+
+	int rc = decodeVertexBufferData(destination, vertex_stride, vertex_count, vertex_size, buffer, buffer_size, parallel_for, context, filter, gDecodeVertexKernels.kernels[0].decode);
+
+	if (rc == 0)
+		meshopt_Instrumentation<void>::report("decodeVertexBuffer", "decode", vertex_count, 0, 0, buffer_size, vertex_count * vertex_size);
+
+	return rc;
+}
+
+static size_t encodeVertexBufferLevel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level, const EncodeVertexKernel& kernel)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(level >= 0 && level <= 2);
+
+	meshopt_Instrumentation<void>::report("encodeVertexBuffer", "start", vertex_count);
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return 0;
+
+	// level 0 output is a version 0 stream; other levels need version 2 to store the predictor modes
+	*data++ = (unsigned char)(kVertexHeader | (level > 0 ? 2 : 0));
+
+	unsigned char last_vertex[256] = {};
+	if (vertex_count > 0)
+		memcpy(last_vertex, vertex_data, vertex_size);
+
+	data = encodeVertexBlocks(data, data_end, vertex_data, vertex_count, vertex_size, last_vertex, level, kernel.simd);
+	if (!data)
+		return 0;
+
+	data = encodeVertexTail(data, data_end, vertex_data, vertex_size);
+	if (!data)
+		return 0;
+
+	assert(data <= buffer + buffer_size);
+
+	meshopt_Instrumentation<void>::report("encodeVertexBuffer", "encode", vertex_count, 0, 0, vertex_count * vertex_size, data - buffer);
+
+	return data - buffer;
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	return meshopt_encodeVertexBufferLevel(buffer, buffer_size, vertices, vertex_count, vertex_size, 0);
+}
+
+size_t meshopt_encodeVertexBufferLevel(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level)
+{
+	using namespace meshopt;
+
+	return encodeVertexBufferLevel(buffer, buffer_size, vertices, vertex_count, vertex_size, level, kEncodeVertexKernels[0]);
+}
+
+size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
+	size_t vertex_block_data_size = vertex_block_size;
+
+	// version 2 blocks additionally store predictor modes; the bound covers all encoding levels
+	size_t vertex_block_mode_size = getChannelModeSize(vertex_size);
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	return 1 + vertex_block_count * (vertex_size * (vertex_block_header_size + vertex_block_data_size) + vertex_block_mode_size) + tail_size;
+}
+
+size_t meshopt_encodeVertexBufferSegmented(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	size_t segment_size = getVertexSegmentSize(vertex_size);
+	size_t segment_count = (vertex_count + segment_size - 1) / segment_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return 0;
+
+	*data++ = kVertexHeader | 1;
+
+	// the first vertex is stored upfront so that decoding can start before the entire stream is available
+	unsigned char first_vertex[256] = {};
+	if (vertex_count > 0)
+		memcpy(first_vertex, vertex_data, vertex_size);
+
+	memcpy(data, first_vertex, vertex_size);
+	data += vertex_size;
+
+	for (size_t i = 0; i < segment_count; ++i)
+	{
+		size_t vertex_offset = i * segment_size;
+		size_t segment_vertices = (vertex_offset + segment_size < vertex_count) ? segment_size : vertex_count - vertex_offset;
+
+		// each segment restarts delta coding from the first vertex so that segments can be decoded independently
+		unsigned char last_vertex[256];
+		memcpy(last_vertex, first_vertex, vertex_size);
+
+		unsigned char* segment = data;
+
+		data = encodeVertexBlocks(data, data_end, vertex_data + vertex_offset * vertex_size, segment_vertices, vertex_size, last_vertex, 0, kEncodeVertexKernels[0].simd);
+		if (!data)
+			return 0;
+
+		// segment size follows the segment data so that the encoder never needs to revisit the output
+		if (size_t(data_end - data) < 4)
+			return 0;
+
+		if (!writeUint32(data, data - segment))
+			return 0;
+
+		data += 4;
+	}
+
+	data = encodeVertexTail(data, data_end, first_vertex, vertex_size);
+	if (!data)
+		return 0;
+
+	assert(data <= buffer + buffer_size);
+
+	return data - buffer;
+}
 
-size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+size_t meshopt_encodeVertexBufferSegmentedBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	size_t segment_size = getVertexSegmentSize(vertex_size);
+	size_t segment_count = (vertex_count + segment_size - 1) / segment_size;
+
+	return meshopt_encodeVertexBufferBound(vertex_count, vertex_size) + vertex_size + segment_count * 4;
+}
+
+int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	return decodeVertexBufferImpl(destination, vertex_size, vertex_count, vertex_size, buffer, buffer_size, 0, 0, 0);
+}
+
+int meshopt_decodeVertexBufferStrided(void* destination, size_t vertex_count, size_t vertex_size, size_t destination_stride, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	return decodeVertexBufferImpl(destination, destination_stride, vertex_count, vertex_size, buffer, buffer_size, 0, 0, 0);
+}
+
+int meshopt_decodeVertexBufferParallel(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	return decodeVertexBufferImpl(destination, vertex_size, vertex_count, vertex_size, buffer, buffer_size, parallel_for, context, 0);
+}
+
+int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, unsigned int filter, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	DecodeFilterFn fn = 0;
+
+	switch (filter)
+	{
+	case meshopt_FilterNone:
+		break;
+
+	case meshopt_FilterOct:
+		assert(vertex_size == 4 || vertex_size == 8);
+		fn = meshopt_decodeFilterOct;
+		break;
+
+	case meshopt_FilterQuat:
+		assert(vertex_size == 8);
+		fn = meshopt_decodeFilterQuat;
+		break;
+
+	case meshopt_FilterExp:
+		fn = meshopt_decodeFilterExp;
+		break;
+
+	default:
+		return -1;
+	}
+
+	return decodeVertexBufferImpl(destination, vertex_size, vertex_count, vertex_size, buffer, buffer_size, parallel_for, context, fn);
+}
+
+const char* meshopt_getVertexDecoderKernel()
+{
+	using namespace meshopt;
+
+	return gDecodeVertexKernels.kernels[0].name;
+}
+
+const char* meshopt_getVertexEncoderKernel()
+{
+	using namespace meshopt;
+
+	return kEncodeVertexKernels[0].name;
+}
+
+size_t meshopt_getVertexEncoderKernels(const char** names, size_t capacity)
+{
+	using namespace meshopt;
+
+	size_t count = sizeof(kEncodeVertexKernels) / sizeof(kEncodeVertexKernels[0]);
+
+	for (size_t i = 0; i < count && i < capacity; ++i)
+		names[i] = kEncodeVertexKernels[i].name;
+
+	return count;
+}
+
+size_t meshopt_encodeVertexBufferKernel(const char* kernel, unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level)
+{
+	using namespace meshopt;
+
+	for (size_t i = 0; i < sizeof(kEncodeVertexKernels) / sizeof(kEncodeVertexKernels[0]); ++i)
+		if (strcmp(kernel, kEncodeVertexKernels[i].name) == 0)
+			return encodeVertexBufferLevel(buffer, buffer_size, vertices, vertex_count, vertex_size, level, kEncodeVertexKernels[i]);
+
+	return 0;
+}
+
+size_t meshopt_getVertexDecoderKernels(const char** names, size_t capacity)
+{
+	using namespace meshopt;
+
+	for (size_t i = 0; i < gDecodeVertexKernels.count && i < capacity; ++i)
+		names[i] = gDecodeVertexKernels.kernels[i].name;
+
+	return gDecodeVertexKernels.count;
+}
+
+int meshopt_decodeVertexBufferKernel(const char* kernel, void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
 {
 	using namespace meshopt;
 
+	for (size_t i = 0; i < gDecodeVertexKernels.count; ++i)
+		if (strcmp(kernel, gDecodeVertexKernels.kernels[i].name) == 0)
+			return decodeVertexBufferData(destination, vertex_size, vertex_count, vertex_size, buffer, buffer_size, 0, 0, 0, gDecodeVertexKernels.kernels[i].decode);
+
+	return -4;
+}
+
+void meshopt_encodeVertexStreamBegin(meshopt_VertexEncoderState* state, size_t vertex_size)
+{
 	assert(vertex_size > 0 && vertex_size <= 256);
 	assert(vertex_size % 4 == 0);
 
-	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+	memset(state, 0, sizeof(meshopt_VertexEncoderState));
+	state->vertex_size = vertex_size;
+}
 
-	unsigned char* data = buffer;
-	unsigned char* data_end = buffer + buffer_size;
+namespace meshopt
+{
 
-	if (size_t(data_end - data) < 1 + vertex_size)
-		return 0;
+static unsigned char* encodeVertexStreamBlock(meshopt_VertexEncoderState* state, unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count)
+{
+	size_t vertex_size = state->vertex_size;
 
-	*data++ = kVertexHeader;
+	// each segment restarts delta coding from the first vertex, matching meshopt_encodeVertexBufferSegmented
+	if (state->segment_blocks == 0)
+		memcpy(state->last_vertex, state->first_vertex, vertex_size);
 
-	unsigned char last_vertex[256] = {};
-	if (vertex_count > 0)
-		memcpy(last_vertex, vertex_data, vertex_size);
+	unsigned char* block = data;
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	data = encodeVertexBlocks(data, data_end, vertex_data, vertex_count, vertex_size, state->last_vertex, 0, kEncodeVertexKernels[0].simd);
+	if (!data)
+		return 0;
 
-	size_t vertex_offset = 0;
+	state->segment_bytes += data - block;
+	state->segment_blocks++;
 
-	while (vertex_offset < vertex_count)
+	if (state->segment_blocks == kVertexSegmentBlocks)
 	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+		if (size_t(data_end - data) < 4)
+			return 0;
 
-		data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
+		if (!writeUint32(data, state->segment_bytes))
 			return 0;
 
-		vertex_offset += block_size;
+		data += 4;
+
+		state->segment_blocks = 0;
+		state->segment_bytes = 0;
 	}
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	return data;
+}
 
-	if (size_t(data_end - data) < tail_size)
+static unsigned char* encodeVertexStreamHeader(meshopt_VertexEncoderState* state, unsigned char* data, unsigned char* data_end)
+{
+	if (size_t(data_end - data) < 1 + state->vertex_size)
 		return 0;
 
-	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
-	if (vertex_size < kTailMaxSize)
+	*data++ = kVertexHeader | 1;
+
+	memcpy(data, state->first_vertex, state->vertex_size);
+	data += state->vertex_size;
+
+	return data;
+}
+
+} // namespace meshopt
+
+int meshopt_encodeVertexStream(meshopt_VertexEncoderState* state, unsigned char* buffer, size_t buffer_size, size_t* buffer_written, const void* vertices, size_t vertex_count)
+{
+	using namespace meshopt;
+
+	assert(state->vertex_size > 0);
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+	size_t vertex_size = state->vertex_size;
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	*buffer_written = 0;
+
+	if (vertex_count == 0)
+		return 0;
+
+	if (state->vertex_count == 0)
 	{
-		memset(data, 0, kTailMaxSize - vertex_size);
-		data += kTailMaxSize - vertex_size;
+		memcpy(state->first_vertex, vertex_data, vertex_size);
+
+		data = encodeVertexStreamHeader(state, data, data_end);
+		if (!data)
+			return -2;
 	}
 
-	memcpy(data, vertex_data, vertex_size);
-	data += vertex_size;
+	state->vertex_count += vertex_count;
+
+	while (vertex_count > 0)
+	{
+		// full blocks are encoded directly from the input; partial blocks are accumulated until the next call fills them
+		if (state->block_size == 0 && vertex_count >= vertex_block_size)
+		{
+			data = encodeVertexStreamBlock(state, data, data_end, vertex_data, vertex_block_size);
+			if (!data)
+				return -2;
+
+			vertex_data += vertex_block_size * vertex_size;
+			vertex_count -= vertex_block_size;
+			continue;
+		}
+
+		size_t count = vertex_block_size - state->block_size;
+		if (count > vertex_count)
+			count = vertex_count;
+
+		memcpy(state->block + state->block_size * vertex_size, vertex_data, count * vertex_size);
+		state->block_size += count;
+
+		vertex_data += count * vertex_size;
+		vertex_count -= count;
+
+		if (state->block_size == vertex_block_size)
+		{
+			data = encodeVertexStreamBlock(state, data, data_end, state->block, vertex_block_size);
+			if (!data)
+				return -2;
+
+			state->block_size = 0;
+		}
+	}
 
-	assert(data >= buffer + tail_size);
 	assert(data <= buffer + buffer_size);
 
-	return data - buffer;
+	*buffer_written = data - buffer;
+	return 0;
 }
 
-size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+int meshopt_encodeVertexStreamEnd(meshopt_VertexEncoderState* state, unsigned char* buffer, size_t buffer_size, size_t* buffer_written)
 {
 	using namespace meshopt;
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	assert(state->vertex_size > 0);
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
-	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
 
-	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
-	size_t vertex_block_data_size = vertex_block_size;
+	*buffer_written = 0;
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+	// empty streams still need the header
+	if (state->vertex_count == 0)
+	{
+		data = encodeVertexStreamHeader(state, data, data_end);
+		if (!data)
+			return -2;
+	}
+
+	if (state->block_size > 0)
+	{
+		data = encodeVertexStreamBlock(state, data, data_end, state->block, state->block_size);
+		if (!data)
+			return -2;
+
+		state->block_size = 0;
+	}
+
+	// the last segment may be incomplete, but it still needs to be terminated with its size
+	if (state->segment_blocks > 0)
+	{
+		if (size_t(data_end - data) < 4)
+			return -2;
+
+		if (!writeUint32(data, state->segment_bytes))
+			return -2;
+
+		data += 4;
+
+		state->segment_blocks = 0;
+		state->segment_bytes = 0;
+	}
+
+	data = encodeVertexTail(data, data_end, state->first_vertex, state->vertex_size);
+	if (!data)
+		return -2;
+
+	assert(data <= buffer + buffer_size);
 
-	return 1 + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + tail_size;
+	*buffer_written = data - buffer;
+	return 0;
 }
 
-int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+size_t meshopt_encodeVertexStreamBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	// a single call can flush vertices that were accumulated by previous calls, which adds at most one block to the output
+	return meshopt_encodeVertexBufferSegmentedBound(vertex_count + getVertexBlockSize(vertex_size), vertex_size);
+}
+
+namespace meshopt
+{
+
+enum
+{
+	kVertexStreamHeader,
+	kVertexStreamBlocks,
+	kVertexStreamSegmentEnd,
+	kVertexStreamTail,
+	kVertexStreamDone
+};
+
+} // namespace meshopt
+
+void meshopt_decodeVertexStreamBegin(meshopt_VertexDecoderState* state, size_t vertex_count, size_t vertex_size)
 {
 	using namespace meshopt;
 
 	assert(vertex_size > 0 && vertex_size <= 256);
 	assert(vertex_size % 4 == 0);
 
-	const unsigned char* (*decode)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]) = 0;
+	memset(state, 0, sizeof(meshopt_VertexDecoderState));
+	state->vertex_count = vertex_count;
+	state->vertex_size = vertex_size;
+	state->stage = kVertexStreamHeader;
+}
+
+int meshopt_decodeVertexStream(meshopt_VertexDecoderState* state, void* destination, size_t destination_count, size_t* destination_written, const unsigned char* buffer, size_t buffer_size, size_t* buffer_consumed)
+{
+	using namespace meshopt;
 
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-	int cpuinfo[4] = {};
-	__cpuid(cpuinfo, 1);
-	decode = (cpuinfo[2] & (1 << 9)) ? decodeVertexBlockSimd : decodeVertexBlock;
-#elif defined(SIMD_SSE) || defined(SIMD_NEON)
-	decode = decodeVertexBlockSimd;
-#else
-	decode = decodeVertexBlock;
-#endif
+	assert(state->vertex_size > 0);
+
+	DecodeVertexBlockFn decode = gDecodeVertexKernels.kernels[0].decode;
+	assert(decode);
 
 #if defined(SIMD_SSE) || defined(SIMD_NEON)
 	assert(gDecodeBytesGroupInitialized);
 #endif
 
 	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+	size_t vertex_size = state->vertex_size;
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
 
 	const unsigned char* data = buffer;
 	const unsigned char* data_end = buffer + buffer_size;
 
-	if (size_t(data_end - data) < 1 + vertex_size)
-		return -2;
+	size_t written = 0;
+	int result = 0;
 
-	if (*data++ != kVertexHeader)
-		return -1;
+	for (;;)
+	{
+		// vertices are decoded into the state one block at a time, and copied out to the destination as space permits
+		if (state->block_offset < state->block_size)
+		{
+			size_t count = state->block_size - state->block_offset;
+			if (count > destination_count - written)
+				count = destination_count - written;
 
-	unsigned char last_vertex[256];
-	memcpy(last_vertex, data_end - vertex_size, vertex_size);
+			memcpy(vertex_data + written * vertex_size, state->block + state->block_offset * vertex_size, count * vertex_size);
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+			written += count;
+			state->block_offset += count;
 
-	size_t vertex_offset = 0;
+			if (state->block_offset < state->block_size)
+				break;
+		}
 
-	while (vertex_offset < vertex_count)
-	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+		if (state->stage == kVertexStreamHeader)
+		{
+			if (size_t(data_end - data) < 1 + vertex_size)
+				break;
 
-		data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
-			return -2;
+			if (data[0] != (kVertexHeader | 1))
+			{
+				result = -1;
+				break;
+			}
 
-		vertex_offset += block_size;
-	}
+			memcpy(state->first_vertex, data + 1, vertex_size);
+			data += 1 + vertex_size;
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+			state->stage = kVertexStreamBlocks;
+		}
+		else if (state->stage == kVertexStreamBlocks)
+		{
+			if (state->vertex_offset == state->vertex_count)
+			{
+				state->stage = state->segment_blocks > 0 ? kVertexStreamSegmentEnd : kVertexStreamTail;
+				continue;
+			}
 
-	if (size_t(data_end - data) != tail_size)
-		return -3;
+			size_t block_size = (state->vertex_offset + vertex_block_size < state->vertex_count) ? vertex_block_size : state->vertex_count - state->vertex_offset;
 
-	return 0;
+			if (state->segment_blocks == 0)
+				memcpy(state->last_vertex, state->first_vertex, vertex_size);
+
+			// block decoders fail without modifying last_vertex when data is truncated, so the block can be retried after more data arrives
+			const unsigned char* next = decode(data, data_end, state->block, vertex_size, block_size, vertex_size, state->last_vertex, 0);
+
+			if (!next)
+			{
+				size_t block_size_aligned = (block_size + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+				size_t block_bound = vertex_size * ((block_size_aligned / kByteGroupSize + 3) / 4 + block_size_aligned) + kTailMaxSize;
+
+				if (size_t(data_end - data) >= block_bound)
+					result = -2;
+
+				break;
+			}
+
+			state->segment_bytes += next - data;
+			data = next;
+
+			state->vertex_offset += block_size;
+			state->block_size = block_size;
+			state->block_offset = 0;
+
+			if (++state->segment_blocks == kVertexSegmentBlocks)
+				state->stage = kVertexStreamSegmentEnd;
+		}
+		else if (state->stage == kVertexStreamSegmentEnd)
+		{
+			if (size_t(data_end - data) < 4)
+				break;
+
+			if (readUint32(data) != state->segment_bytes)
+			{
+				result = -3;
+				break;
+			}
+
+			data += 4;
+
+			state->segment_blocks = 0;
+			state->segment_bytes = 0;
+			state->stage = kVertexStreamBlocks;
+		}
+		else if (state->stage == kVertexStreamTail)
+		{
+			if (size_t(data_end - data) < tail_size)
+				break;
+
+			data += tail_size;
+
+			state->stage = kVertexStreamDone;
+		}
+		else
+		{
+			assert(state->stage == kVertexStreamDone);
+
+			result = 1;
+			break;
+		}
+	}
+
+	*destination_written = written;
+	*buffer_consumed = data - buffer;
+
+	return result;
 }
@@ -0,0 +1,34 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#ifndef MESHOPTIMIZER_VERTEXCODEC_H
+#define MESHOPTIMIZER_VERTEXCODEC_H
+
+#include "meshoptimizer.h"
+
+// Internal interface that lets tests run every vertex codec implementation side by side; it isn't part of the public API and may change between versions
+// Implementations are selected per call, so this is safe to use concurrently with the regular encode/decode functions
+
+/**
+ * Writes the names of the vertex encoder implementations to names (up to capacity entries), starting with the one meshopt_encodeVertexBuffer uses
+ * Returns the total number of implementations; "scalar" is always among them
+ */
+MESHOPTIMIZER_API size_t meshopt_getVertexEncoderKernels(const char** names, size_t capacity);
+
+/**
+ * Encodes vertex data like meshopt_encodeVertexBufferLevel, using the named encoder implementation
+ * Returns 0 if the implementation isn't available, or if the buffer is too small
+ */
+MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferKernel(const char* kernel, unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int level);
+
+/**
+ * Writes the names of the vertex decoder implementations supported by the current CPU to names (up to capacity entries), starting with the one meshopt_decodeVertexBuffer uses
+ * Returns the total number of supported implementations
+ */
+MESHOPTIMIZER_API size_t meshopt_getVertexDecoderKernels(const char** names, size_t capacity);
+
+/**
+ * Decodes vertex data like meshopt_decodeVertexBuffer, using the named decoder implementation
+ * Returns the same error codes as meshopt_decodeVertexBuffer, or -4 if the implementation isn't supported by the current CPU
+ */
+MESHOPTIMIZER_API int meshopt_decodeVertexBufferKernel(const char* kernel, void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
+
+#endif
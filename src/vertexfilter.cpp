@@ -0,0 +1,464 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2
+#endif
+
+#ifdef SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// Scalar and SIMD decoders perform the same sequence of IEEE operations, so they produce identical results; SIMD paths fall back to scalar code for the last few elements
+namespace meshopt
+{
+
+// 1/sqrt(2); the three smallest components of a unit quaternion are in [-1/sqrt(2)..1/sqrt(2)] range
+const float kQuatScale = 0.70710677f;
+
+static float clamp1(float v)
+{
+	v = (v >= -1.f) ? v : -1.f;
+	v = (v <= +1.f) ? v : +1.f;
+
+	return v;
+}
+
+static int roundSigned(float v)
+{
+	return int(v + (v >= 0 ? 0.5f : -0.5f));
+}
+
+template <typename T>
+static void decodeFilterOct(T* data, size_t count)
+{
+	const float max = float((1 << (sizeof(T) * 8 - 1)) - 1);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		// the third component stores the quantized 1.0, so the encoding precision doesn't need to be known
+		float x = float(data[i * 4 + 0]);
+		float y = float(data[i * 4 + 1]);
+		float z = float(data[i * 4 + 2]) - (fabsf(x) + fabsf(y));
+
+		// unfold lower hemisphere
+		float t = (z < 0) ? z : 0;
+
+		x += (x >= 0) ? t : -t;
+		y += (y >= 0) ? t : -t;
+
+		float ll = x * x + y * y + z * z;
+		float s = max / sqrtf(ll > 1 ? ll : 1);
+
+		data[i * 4 + 0] = T(roundSigned(x * s));
+		data[i * 4 + 1] = T(roundSigned(y * s));
+		data[i * 4 + 2] = T(roundSigned(z * s));
+	}
+}
+
+static void decodeFilterQuat(short* data, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		int range = data[i * 4 + 3] >> 2;
+		int qc = data[i * 4 + 3] & 3;
+
+		float fr = float(range);
+		float s = kQuatScale / (fr > 1 ? fr : 1);
+
+		// clamping keeps malformed data from overflowing the integer conversion below
+		float a = clamp1(float(data[i * 4 + 0]) * s);
+		float b = clamp1(float(data[i * 4 + 1]) * s);
+		float c = clamp1(float(data[i * 4 + 2]) * s);
+
+		// reconstruct the largest component from the unit length constraint
+		float ww = 1.f - a * a - b * b - c * c;
+		float w = sqrtf(ww > 0 ? ww : 0);
+
+		data[i * 4 + ((qc + 1) & 3)] = short(roundSigned(a * 32767.f));
+		data[i * 4 + ((qc + 2) & 3)] = short(roundSigned(b * 32767.f));
+		data[i * 4 + ((qc + 3) & 3)] = short(roundSigned(c * 32767.f));
+		data[i * 4 + qc] = short(roundSigned(w * 32767.f));
+	}
+}
+
+static void decodeFilterExp(unsigned int* data, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		unsigned int v = data[i];
+
+		// sign-extend the 24-bit mantissa and the 8-bit exponent
+		int m = int(v << 8) >> 8;
+		int e = int(v) >> 24;
+
+		// the encoder keeps the exponent in a range that results in a normal float
+		unsigned int su = unsigned(e + 127) << 23;
+		float s;
+		memcpy(&s, &su, sizeof(s));
+
+		float r = float(m) * s;
+		memcpy(&data[i], &r, sizeof(r));
+	}
+}
+
+#ifdef SIMD_SSE2
+static __m128 absSimd(__m128 v)
+{
+	return _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+}
+
+static __m128 clamp1Simd(__m128 v)
+{
+	return _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.f)), _mm_set1_ps(1.f));
+}
+
+static __m128i roundSignedSimd(__m128 v)
+{
+	__m128 round = _mm_or_ps(_mm_set1_ps(0.5f), _mm_and_ps(v, _mm_set1_ps(-0.f)));
+
+	return _mm_cvttps_epi32(_mm_add_ps(v, round));
+}
+
+static void decodeOctSimd(__m128& x, __m128& y, __m128& z, float max)
+{
+	z = _mm_sub_ps(z, _mm_add_ps(absSimd(x), absSimd(y)));
+
+	// unfold lower hemisphere: x += (x >= 0) ? t : -t
+	__m128 t = _mm_min_ps(z, _mm_setzero_ps());
+	__m128 sign = _mm_set1_ps(-0.f);
+
+	x = _mm_add_ps(x, _mm_xor_ps(t, _mm_and_ps(x, sign)));
+	y = _mm_add_ps(y, _mm_xor_ps(t, _mm_and_ps(y, sign)));
+
+	__m128 ll = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	__m128 s = _mm_div_ps(_mm_set1_ps(max), _mm_sqrt_ps(_mm_max_ps(ll, _mm_set1_ps(1.f))));
+
+	x = _mm_mul_ps(x, s);
+	y = _mm_mul_ps(y, s);
+	z = _mm_mul_ps(z, s);
+}
+
+static void decodeFilterOctSimd(signed char* data, size_t count)
+{
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128i n4 = _mm_loadu_si128(reinterpret_cast<__m128i*>(&data[i * 4]));
+
+		// sign-extend each byte of every 32-bit element
+		__m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n4, 24), 24));
+		__m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n4, 16), 24));
+		__m128 z = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n4, 8), 24));
+
+		decodeOctSimd(x, y, z, 127.f);
+
+		__m128i mask = _mm_set1_epi32(0xff);
+
+		__m128i xr = _mm_and_si128(roundSignedSimd(x), mask);
+		__m128i yr = _mm_slli_epi32(_mm_and_si128(roundSignedSimd(y), mask), 8);
+		__m128i zr = _mm_slli_epi32(_mm_and_si128(roundSignedSimd(z), mask), 16);
+
+		// preserve the 4th component
+		__m128i res = _mm_or_si128(_mm_or_si128(xr, yr), _mm_or_si128(zr, _mm_andnot_si128(_mm_set1_epi32(0xffffff), n4)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[i * 4]), res);
+	}
+}
+
+static void decodeFilterOctSimd(short* data, size_t count)
+{
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 n4_0 = _mm_loadu_ps(reinterpret_cast<float*>(&data[(i + 0) * 4]));
+		__m128 n4_1 = _mm_loadu_ps(reinterpret_cast<float*>(&data[(i + 2) * 4]));
+
+		// gather xy and zw pairs of 4 elements into separate registers
+		__m128i xy = _mm_castps_si128(_mm_shuffle_ps(n4_0, n4_1, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i zw = _mm_castps_si128(_mm_shuffle_ps(n4_0, n4_1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		__m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16));
+		__m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(xy, 16));
+		__m128 z = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(zw, 16), 16));
+
+		decodeOctSimd(x, y, z, 32767.f);
+
+		__m128i mask = _mm_set1_epi32(0xffff);
+
+		__m128i xyr = _mm_or_si128(_mm_and_si128(roundSignedSimd(x), mask), _mm_slli_epi32(roundSignedSimd(y), 16));
+		__m128i zwr = _mm_or_si128(_mm_and_si128(roundSignedSimd(z), mask), _mm_andnot_si128(mask, zw));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[(i + 0) * 4]), _mm_unpacklo_epi32(xyr, zwr));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[(i + 2) * 4]), _mm_unpackhi_epi32(xyr, zwr));
+	}
+}
+
+static __m128i selectQuat(__m128i qc, __m128i v0, __m128i v1, __m128i v2, __m128i v3)
+{
+	// returns v[qc] for each lane
+	__m128i r0 = _mm_and_si128(_mm_cmpeq_epi32(qc, _mm_setzero_si128()), v0);
+	__m128i r1 = _mm_and_si128(_mm_cmpeq_epi32(qc, _mm_set1_epi32(1)), v1);
+	__m128i r2 = _mm_and_si128(_mm_cmpeq_epi32(qc, _mm_set1_epi32(2)), v2);
+	__m128i r3 = _mm_and_si128(_mm_cmpeq_epi32(qc, _mm_set1_epi32(3)), v3);
+
+	return _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3));
+}
+
+static void decodeFilterQuatSimd(short* data, size_t count)
+{
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128 q4_0 = _mm_loadu_ps(reinterpret_cast<float*>(&data[(i + 0) * 4]));
+		__m128 q4_1 = _mm_loadu_ps(reinterpret_cast<float*>(&data[(i + 2) * 4]));
+
+		__m128i xy = _mm_castps_si128(_mm_shuffle_ps(q4_0, q4_1, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i zw = _mm_castps_si128(_mm_shuffle_ps(q4_0, q4_1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		__m128i w = _mm_srai_epi32(zw, 16);
+
+		__m128 fr = _mm_cvtepi32_ps(_mm_srai_epi32(w, 2));
+		__m128 s = _mm_div_ps(_mm_set1_ps(kQuatScale), _mm_max_ps(fr, _mm_set1_ps(1.f)));
+
+		__m128 a = clamp1Simd(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16)), s));
+		__m128 b = clamp1Simd(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(xy, 16)), s));
+		__m128 c = clamp1Simd(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(zw, 16), 16)), s));
+
+		__m128 ww = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(a, a)), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+		__m128 d = _mm_sqrt_ps(_mm_max_ps(ww, _mm_setzero_ps()));
+
+		__m128 scale = _mm_set1_ps(32767.f);
+
+		__m128i ar = roundSignedSimd(_mm_mul_ps(a, scale));
+		__m128i br = roundSignedSimd(_mm_mul_ps(b, scale));
+		__m128i cr = roundSignedSimd(_mm_mul_ps(c, scale));
+		__m128i dr = roundSignedSimd(_mm_mul_ps(d, scale));
+
+		// component k receives a if qc = k - 1, b if qc = k - 2, c if qc = k - 3 and the reconstructed component if qc = k (mod 4)
+		__m128i qc = _mm_and_si128(w, _mm_set1_epi32(3));
+
+		__m128i r0 = selectQuat(qc, dr, cr, br, ar);
+		__m128i r1 = selectQuat(qc, ar, dr, cr, br);
+		__m128i r2 = selectQuat(qc, br, ar, dr, cr);
+		__m128i r3 = selectQuat(qc, cr, br, ar, dr);
+
+		__m128i mask = _mm_set1_epi32(0xffff);
+
+		__m128i xyr = _mm_or_si128(_mm_and_si128(r0, mask), _mm_slli_epi32(r1, 16));
+		__m128i zwr = _mm_or_si128(_mm_and_si128(r2, mask), _mm_slli_epi32(r3, 16));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[(i + 0) * 4]), _mm_unpacklo_epi32(xyr, zwr));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[(i + 2) * 4]), _mm_unpackhi_epi32(xyr, zwr));
+	}
+}
+
+static void decodeFilterExpSimd(unsigned int* data, size_t count)
+{
+	for (size_t i = 0; i < count; i += 4)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<__m128i*>(&data[i]));
+
+		__m128i m = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+		__m128i e = _mm_srai_epi32(v, 24);
+
+		__m128 s = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127)), 23));
+		__m128 r = _mm_mul_ps(_mm_cvtepi32_ps(m), s);
+
+		_mm_storeu_ps(reinterpret_cast<float*>(&data[i]), r);
+	}
+}
+#endif
+
+} // namespace meshopt
+
+void meshopt_encodeFilterOct(void* destination, size_t count, size_t stride, int bits, const float* data)
+{
+	assert(stride == 4 || stride == 8);
+	assert(bits >= 2 && bits <= int(stride * 2));
+
+	signed char* d8 = static_cast<signed char*>(destination);
+	short* d16 = static_cast<short*>(destination);
+
+	int bits_w = int(stride * 2);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* n = &data[i * 4];
+
+		// octahedral projection: project onto |x|+|y|+|z|=1 and fold the lower hemisphere over the diagonals
+		float nl = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+		float ns = nl == 0.f ? 0.f : 1.f / nl;
+
+		float nx = n[0] * ns;
+		float ny = n[1] * ns;
+
+		float u = (n[2] >= 0.f) ? nx : (1 - fabsf(ny)) * (nx >= 0.f ? 1.f : -1.f);
+		float v = (n[2] >= 0.f) ? ny : (1 - fabsf(nx)) * (ny >= 0.f ? 1.f : -1.f);
+
+		int fu = meshopt_quantizeSnorm(u, bits);
+		int fv = meshopt_quantizeSnorm(v, bits);
+		int fo = meshopt_quantizeSnorm(1.f, bits);
+		int fw = meshopt_quantizeSnorm(n[3], bits_w);
+
+		if (stride == 4)
+		{
+			d8[i * 4 + 0] = static_cast<signed char>(fu);
+			d8[i * 4 + 1] = static_cast<signed char>(fv);
+			d8[i * 4 + 2] = static_cast<signed char>(fo);
+			d8[i * 4 + 3] = static_cast<signed char>(fw);
+		}
+		else
+		{
+			d16[i * 4 + 0] = static_cast<short>(fu);
+			d16[i * 4 + 1] = static_cast<short>(fv);
+			d16[i * 4 + 2] = static_cast<short>(fo);
+			d16[i * 4 + 3] = static_cast<short>(fw);
+		}
+	}
+}
+
+void meshopt_encodeFilterQuat(void* destination, size_t count, size_t stride, int bits, const float* data)
+{
+	using namespace meshopt;
+
+	assert(stride == 8);
+	assert(bits >= 4 && bits <= 14);
+	(void)stride;
+
+	short* d = static_cast<short*>(destination);
+
+	int range = (1 << (bits - 1)) - 1;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* q = &data[i * 4];
+
+		// the largest component is reconstructed by the decoder; q and -q are the same rotation, so it can always be positive
+		int qc = 0;
+		for (int k = 1; k < 4; ++k)
+			qc = fabsf(q[k]) > fabsf(q[qc]) ? k : qc;
+
+		float sign = q[qc] < 0.f ? -1.f : 1.f;
+		float scale = sign / kQuatScale;
+
+		d[i * 4 + 0] = static_cast<short>(meshopt_quantizeSnorm(q[(qc + 1) & 3] * scale, bits));
+		d[i * 4 + 1] = static_cast<short>(meshopt_quantizeSnorm(q[(qc + 2) & 3] * scale, bits));
+		d[i * 4 + 2] = static_cast<short>(meshopt_quantizeSnorm(q[(qc + 3) & 3] * scale, bits));
+		d[i * 4 + 3] = static_cast<short>((range << 2) | qc);
+	}
+}
+
+void meshopt_encodeFilterExp(void* destination, size_t count, size_t stride, int bits, const float* data)
+{
+	assert(stride > 0 && stride <= 256 && stride % 4 == 0);
+	assert(bits >= 2 && bits <= 24);
+
+	unsigned int* d = static_cast<unsigned int*>(destination);
+
+	size_t components = stride / 4;
+
+	const int kMantissaMax = (1 << 23) - 1;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* v = &data[i * components];
+
+		float vmax = 0.f;
+		for (size_t k = 0; k < components; ++k)
+			vmax = fabsf(v[k]) > vmax ? fabsf(v[k]) : vmax;
+
+		// the exponent is shared by all components and is chosen so that the largest one fits into the requested number of mantissa bits
+		int exp = 0;
+		frexp(vmax, &exp);
+
+		int e = exp - (bits - 1);
+
+		// keep 2^e a normal float so that the decoder can construct it directly
+		e = e < -100 ? -100 : e;
+		assert(e <= 127);
+
+		float scale = float(ldexp(1.0, -e));
+
+		for (size_t k = 0; k < components; ++k)
+		{
+			float mf = v[k] * scale;
+			int m = int(mf + (mf >= 0 ? 0.5f : -0.5f));
+
+			// rounding can reach 2^23 for 24-bit mantissas
+			m = m > kMantissaMax ? kMantissaMax : (m < -kMantissaMax ? -kMantissaMax : m);
+
+			d[i * components + k] = (unsigned(e) << 24) | (unsigned(m) & 0xffffff);
+		}
+	}
+}
+
+void meshopt_decodeFilterOct(void* buffer, size_t count, size_t stride)
+{
+	using namespace meshopt;
+
+	assert(stride == 4 || stride == 8);
+
+	size_t offset = 0;
+
+	if (stride == 4)
+	{
+		signed char* data = static_cast<signed char*>(buffer);
+
+#ifdef SIMD_SSE2
+		offset = count & ~size_t(3);
+		decodeFilterOctSimd(data, offset);
+#endif
+
+		decodeFilterOct(data + offset * 4, count - offset);
+	}
+	else
+	{
+		short* data = static_cast<short*>(buffer);
+
+#ifdef SIMD_SSE2
+		offset = count & ~size_t(3);
+		decodeFilterOctSimd(data, offset);
+#endif
+
+		decodeFilterOct(data + offset * 4, count - offset);
+	}
+}
+
+void meshopt_decodeFilterQuat(void* buffer, size_t count, size_t stride)
+{
+	using namespace meshopt;
+
+	assert(stride == 8);
+	(void)stride;
+
+	short* data = static_cast<short*>(buffer);
+	size_t offset = 0;
+
+#ifdef SIMD_SSE2
+	offset = count & ~size_t(3);
+	decodeFilterQuatSimd(data, offset);
+#endif
+
+	decodeFilterQuat(data + offset * 4, count - offset);
+}
+
+void meshopt_decodeFilterExp(void* buffer, size_t count, size_t stride)
+{
+	using namespace meshopt;
+
+	assert(stride > 0 && stride <= 256 && stride % 4 == 0);
+
+	unsigned int* data = static_cast<unsigned int*>(buffer);
+
+	size_t total = count * (stride / 4);
+	size_t offset = 0;
+
+#ifdef SIMD_SSE2
+	offset = total & ~size_t(3);
+	decodeFilterExpSimd(data, offset);
+#endif
+
+	decodeFilterExp(data + offset, total - offset);
+}
@@ -54,3 +54,91 @@ meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const unsigned int* ind
 
 	return result;
 }
+
+meshopt_VertexFetchStatistics meshopt_analyzeVertexFetchPasses(const meshopt_VertexFetchPass* passes, size_t pass_count, size_t vertex_count, const size_t* stream_strides, size_t stream_count, size_t cache_line_size)
+{
+	assert(stream_count > 0 && stream_count <= 32);
+	assert(cache_line_size > 0 && cache_line_size <= 4096);
+
+	meshopt_VertexFetchStatistics result = {};
+
+	// streams are placed in separate address ranges so that they compete for the same cache without aliasing
+	size_t stream_base[32] = {};
+	size_t base = 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		assert(stream_strides[k] > 0 && stream_strides[k] <= 256);
+
+		stream_base[k] = base;
+		base += (vertex_count * stream_strides[k] + cache_line_size - 1) / cache_line_size * cache_line_size;
+	}
+
+	meshopt_Buffer<char> vertex_visited(vertex_count);
+
+	const size_t kCacheSize = 128 * 1024;
+
+	// same direct mapped model as meshopt_analyzeVertexFetch, with a configurable line size
+	meshopt_Buffer<size_t> cache(kCacheSize / cache_line_size);
+
+	size_t expected_bytes = 0;
+
+	for (size_t i = 0; i < pass_count; ++i)
+	{
+		const meshopt_VertexFetchPass& pass = passes[i];
+
+		assert(pass.index_count % 3 == 0);
+		assert(stream_count == 32 || (pass.stream_mask >> stream_count) == 0);
+
+		// passes are separate draw calls that are usually far apart, so each pass starts with a cold cache
+		memset(vertex_visited.data, 0, vertex_count);
+		memset(cache.data, 0, cache.size * sizeof(size_t));
+
+		for (size_t j = 0; j < pass.index_count; ++j)
+		{
+			unsigned int index = pass.indices[j];
+			assert(index < vertex_count);
+
+			vertex_visited[index] = 1;
+
+			for (size_t k = 0; k < stream_count; ++k)
+			{
+				if ((pass.stream_mask & (1u << k)) == 0)
+					continue;
+
+				size_t start_address = stream_base[k] + index * stream_strides[k];
+				size_t end_address = start_address + stream_strides[k];
+
+				size_t start_tag = start_address / cache_line_size;
+				size_t end_tag = (end_address + cache_line_size - 1) / cache_line_size;
+
+				assert(start_tag < end_tag);
+
+				for (size_t tag = start_tag; tag < end_tag; ++tag)
+				{
+					size_t line = tag % cache.size;
+
+					// we store +1 since cache is filled with 0 by default
+					result.bytes_fetched += (cache[line] != tag + 1) * cache_line_size;
+					cache[line] = tag + 1;
+				}
+			}
+		}
+
+		size_t pass_stride = 0;
+
+		for (size_t k = 0; k < stream_count; ++k)
+			pass_stride += (pass.stream_mask & (1u << k)) ? stream_strides[k] : 0;
+
+		size_t unique_vertex_count = 0;
+
+		for (size_t j = 0; j < vertex_count; ++j)
+			unique_vertex_count += vertex_visited[j];
+
+		expected_bytes += unique_vertex_count * pass_stride;
+	}
+
+	result.overfetch = expected_bytes == 0 ? 0 : float(result.bytes_fetched) / float(expected_bytes);
+
+	return result;
+}
@@ -72,3 +72,207 @@ size_t meshopt_optimizeVertexFetch(void* destination, unsigned int* indices, siz
 
 	return next_vertex;
 }
+
+namespace meshopt
+{
+
+// fills sequence with the indices of all passes in the order they are visited by the candidate order; segments receive segment boundaries
+// candidate c < pass_count visits pass c first and then the remaining passes; candidate pass_count visits all passes in lockstep as one segment
+static size_t fillSequence(unsigned int* sequence, size_t* segments, const meshopt_VertexFetchPass* passes, size_t pass_count, size_t candidate, size_t* cursors)
+{
+	size_t offset = 0;
+
+	if (candidate < pass_count)
+	{
+		segments[0] = 0;
+
+		for (size_t i = 0; i < pass_count; ++i)
+		{
+			const meshopt_VertexFetchPass& pass = passes[(candidate + i) % pass_count];
+
+			memcpy(sequence + offset, pass.indices, pass.index_count * sizeof(unsigned int));
+			offset += pass.index_count;
+
+			segments[i + 1] = offset;
+		}
+
+		return pass_count;
+	}
+
+	memset(cursors, 0, pass_count * sizeof(size_t));
+
+	for (;;)
+	{
+		size_t best = ~size_t(0);
+
+		for (size_t i = 0; i < pass_count; ++i)
+		{
+			if (cursors[i] == passes[i].index_count)
+				continue;
+
+			// pick the pass with the least relative progress, comparing cursors[i] / index_count without division
+			if (best == ~size_t(0) || cursors[i] * passes[best].index_count < cursors[best] * passes[i].index_count)
+				best = i;
+		}
+
+		if (best == ~size_t(0))
+			break;
+
+		memcpy(sequence + offset, passes[best].indices + cursors[best], 3 * sizeof(unsigned int));
+		offset += 3;
+		cursors[best] += 3;
+	}
+
+	segments[0] = 0;
+	segments[1] = offset;
+
+	return 1;
+}
+
+// computes first-use order of the sequence; last_use receives the position of the last use of each vertex within the segment where it was first used
+static size_t computeFirstUseOrder(unsigned int* order, unsigned int* last_use, unsigned int* first_segment, const unsigned int* sequence, const size_t* segments, size_t segment_count, size_t vertex_count)
+{
+	memset(first_segment, -1, vertex_count * sizeof(unsigned int));
+
+	size_t order_count = 0;
+
+	for (size_t s = 0; s < segment_count; ++s)
+	{
+		for (size_t i = segments[s]; i < segments[s + 1]; ++i)
+		{
+			unsigned int index = sequence[i];
+
+			if (first_segment[index] == ~0u)
+			{
+				first_segment[index] = unsigned(s);
+				order[order_count++] = index;
+			}
+
+			if (first_segment[index] == s)
+				last_use[index] = unsigned(i);
+		}
+	}
+
+	return order_count;
+}
+
+// sorts each window of the order by last use; this keeps the first-use locality at the window scale, but places vertices that are not reused later on the same cache lines
+// as a result, lines that are fetched again once the traversal comes back to the vertices contain fewer dead vertices
+static void sortWindows(unsigned int* order, size_t order_count, const unsigned int* last_use, size_t window)
+{
+	for (size_t start = 0; start < order_count; start += window)
+	{
+		size_t end = start + window < order_count ? start + window : order_count;
+
+		// insertion sort is fast enough for small windows
+		for (size_t i = start + 1; i < end; ++i)
+		{
+			unsigned int index = order[i];
+			size_t j = i;
+
+			while (j > start && last_use[order[j - 1]] > last_use[index])
+			{
+				order[j] = order[j - 1];
+				j--;
+			}
+
+			order[j] = index;
+		}
+	}
+}
+
+} // namespace meshopt
+
+size_t meshopt_optimizeVertexFetchPassesRemap(unsigned int* destination, const meshopt_VertexFetchPass* passes, size_t pass_count, size_t vertex_count, const size_t* stream_strides, size_t stream_count, size_t cache_line_size)
+{
+	using namespace meshopt;
+
+	assert(stream_count > 0 && stream_count <= 32);
+	assert(cache_line_size > 0 && cache_line_size <= 4096);
+
+	size_t total_index_count = 0;
+
+	for (size_t i = 0; i < pass_count; ++i)
+	{
+		assert(passes[i].index_count % 3 == 0);
+
+		for (size_t j = 0; j < passes[i].index_count; ++j)
+			assert(passes[i].indices[j] < vertex_count);
+
+		total_index_count += passes[i].index_count;
+	}
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	if (total_index_count == 0)
+		return 0;
+
+	meshopt_Buffer<unsigned int> sequence(total_index_count);
+	meshopt_Buffer<unsigned int> remapped_indices(total_index_count);
+	meshopt_Buffer<meshopt_VertexFetchPass> remapped_passes(pass_count);
+	meshopt_Buffer<size_t> segments(pass_count + 1);
+	meshopt_Buffer<size_t> cursors(pass_count);
+
+	meshopt_Buffer<unsigned int> first_use_order(vertex_count);
+	meshopt_Buffer<unsigned int> order(vertex_count);
+	meshopt_Buffer<unsigned int> last_use(vertex_count);
+	meshopt_Buffer<unsigned int> first_segment(vertex_count);
+	meshopt_Buffer<unsigned int> remap(vertex_count);
+
+	unsigned int* remapped_data = remapped_indices.data;
+
+	for (size_t i = 0; i < pass_count; ++i)
+	{
+		remapped_passes[i] = passes[i];
+		remapped_passes[i].indices = remapped_data;
+		remapped_data += passes[i].index_count;
+	}
+
+	// window size 0 produces plain first-use order; larger windows trade first-use locality for grouping vertices by lifetime
+	const size_t kWindows[] = {0, 16, 64, 256};
+	const size_t window_count = sizeof(kWindows) / sizeof(kWindows[0]);
+
+	// with a single pass, the first candidate matches meshopt_optimizeVertexFetchRemap; ties keep the earlier candidate
+	size_t candidate_count = pass_count > 1 ? pass_count + 1 : 1;
+
+	size_t result = 0;
+	size_t best_bytes = ~size_t(0);
+
+	for (size_t c = 0; c < candidate_count; ++c)
+	{
+		size_t segment_count = fillSequence(sequence.data, segments.data, passes, pass_count, c, cursors.data);
+		size_t order_count = computeFirstUseOrder(first_use_order.data, last_use.data, first_segment.data, sequence.data, segments.data, segment_count, vertex_count);
+
+		for (size_t w = 0; w < window_count; ++w)
+		{
+			memcpy(order.data, first_use_order.data, order_count * sizeof(unsigned int));
+
+			if (kWindows[w])
+				sortWindows(order.data, order_count, last_use.data, kWindows[w]);
+
+			memset(remap.data, -1, vertex_count * sizeof(unsigned int));
+
+			for (size_t i = 0; i < order_count; ++i)
+				remap[order[i]] = unsigned(i);
+
+			remapped_data = remapped_indices.data;
+
+			for (size_t i = 0; i < pass_count; ++i)
+			{
+				meshopt_remapIndexBuffer(remapped_data, passes[i].indices, passes[i].index_count, remap.data);
+				remapped_data += passes[i].index_count;
+			}
+
+			size_t bytes = meshopt_analyzeVertexFetchPasses(remapped_passes.data, pass_count, order_count, stream_strides, stream_count, cache_line_size).bytes_fetched;
+
+			if (bytes < best_bytes)
+			{
+				memcpy(destination, remap.data, vertex_count * sizeof(unsigned int));
+				best_bytes = bytes;
+				result = order_count;
+			}
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,521 @@
+// Throughput benchmark for the library entry points
+// Runs every benchmark over a corpus of synthetic meshes and .obj files from the command line, and reports percentiles of the run time
+// Results are only comparable between runs on the same machine; use -j to produce a baseline and -b to compare against it
+#include "../demo/objparser.h"
+#include "../src/meshoptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#if defined(__linux__)
+double timestamp()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return double(ts.tv_sec) + 1e-9 * double(ts.tv_nsec);
+}
+#elif defined(_WIN32)
+struct LARGE_INTEGER
+{
+	__int64 QuadPart;
+};
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceCounter(LARGE_INTEGER* lpPerformanceCount);
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceFrequency(LARGE_INTEGER* lpFrequency);
+
+double timestamp()
+{
+	LARGE_INTEGER freq, counter;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&counter);
+	return double(counter.QuadPart) / double(freq.QuadPart);
+}
+#else
+double timestamp()
+{
+	return double(clock()) / double(CLOCKS_PER_SEC);
+}
+#endif
+
+struct Vertex
+{
+	float px, py, pz;
+	float nx, ny, nz;
+	float tx, ty;
+};
+
+struct Mesh
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+};
+
+Mesh parseObj(const char* path)
+{
+	ObjFile file;
+
+	if (!objParseFile(file, path))
+	{
+		fprintf(stderr, "Error loading %s: file not found\n", path);
+		return Mesh();
+	}
+
+	if (!objValidate(file))
+	{
+		fprintf(stderr, "Error loading %s: invalid file data\n", path);
+		return Mesh();
+	}
+
+	objTriangulate(file);
+
+	size_t total_indices = file.f.size() / 3;
+
+	std::vector<Vertex> vertices;
+	vertices.reserve(total_indices);
+
+	for (size_t i = 0; i < file.f.size(); i += 3)
+	{
+		int vi = file.f[i + 0];
+		int vti = file.f[i + 1];
+		int vni = file.f[i + 2];
+
+		Vertex v =
+		    {
+		        file.v[vi * 3 + 0],
+		        file.v[vi * 3 + 1],
+		        file.v[vi * 3 + 2],
+
+		        vni >= 0 ? file.vn[vni * 3 + 0] : 0,
+		        vni >= 0 ? file.vn[vni * 3 + 1] : 0,
+		        vni >= 0 ? file.vn[vni * 3 + 2] : 0,
+
+		        vti >= 0 ? file.vt[vti * 3 + 0] : 0,
+		        vti >= 0 ? file.vt[vti * 3 + 1] : 0,
+		    };
+
+		vertices.push_back(v);
+	}
+
+	Mesh result;
+
+	std::vector<unsigned int> remap(total_indices);
+
+	size_t total_vertices = meshopt_generateVertexRemap(&remap[0], NULL, total_indices, &vertices[0], total_indices, sizeof(Vertex));
+
+	result.indices.resize(total_indices);
+	meshopt_remapIndexBuffer(&result.indices[0], NULL, total_indices, &remap[0]);
+
+	result.vertices.resize(total_vertices);
+	meshopt_remapVertexBuffer(&result.vertices[0], &vertices[0], total_indices, sizeof(Vertex), &remap[0]);
+
+	return result;
+}
+
+// height field with smooth normals; the grid order is a good case for the vertex cache optimizer
+Mesh generateTerrain(unsigned int N)
+{
+	Mesh result;
+
+	for (unsigned int y = 0; y <= N; ++y)
+		for (unsigned int x = 0; x <= N; ++x)
+		{
+			float h = sinf(float(x) * 0.1f) * cosf(float(y) * 0.13f) * 10;
+			Vertex v = {float(x), float(y), h, 0, 0, 1, float(x) / float(N), float(y) / float(N)};
+
+			result.vertices.push_back(v);
+		}
+
+	for (unsigned int y = 0; y < N; ++y)
+		for (unsigned int x = 0; x < N; ++x)
+		{
+			unsigned int i0 = y * (N + 1) + x;
+			unsigned int i1 = i0 + 1;
+			unsigned int i2 = i0 + N + 1;
+			unsigned int i3 = i2 + 1;
+
+			unsigned int quad[] = {i0, i1, i2, i2, i1, i3};
+			result.indices.insert(result.indices.end(), quad, quad + 6);
+		}
+
+	return result;
+}
+
+// UV sphere with a texture seam and degenerate poles, with triangles in pseudo-random order
+Mesh generateSphere(unsigned int N)
+{
+	Mesh result;
+
+	const float kPi = 3.14159265f;
+
+	for (unsigned int y = 0; y <= N; ++y)
+		for (unsigned int x = 0; x <= N * 2; ++x)
+		{
+			float u = float(x) / float(N * 2), v = float(y) / float(N);
+			float nx = cosf(u * 2 * kPi) * sinf(v * kPi), ny = sinf(u * 2 * kPi) * sinf(v * kPi), nz = cosf(v * kPi);
+			Vertex vertex = {nx, ny, nz, nx, ny, nz, u, v};
+
+			result.vertices.push_back(vertex);
+		}
+
+	for (unsigned int y = 0; y < N; ++y)
+		for (unsigned int x = 0; x < N * 2; ++x)
+		{
+			unsigned int i0 = y * (N * 2 + 1) + x;
+			unsigned int i1 = i0 + 1;
+			unsigned int i2 = i0 + N * 2 + 1;
+			unsigned int i3 = i2 + 1;
+
+			unsigned int quad[] = {i0, i1, i2, i2, i1, i3};
+			result.indices.insert(result.indices.end(), quad, quad + 6);
+		}
+
+	// fixed seed so that every run sees the same triangle order
+	unsigned int seed = 42;
+	size_t triangle_count = result.indices.size() / 3;
+
+	for (size_t i = triangle_count - 1; i > 0; --i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		size_t j = (seed >> 8) % (i + 1);
+
+		for (int k = 0; k < 3; ++k)
+			std::swap(result.indices[i * 3 + k], result.indices[j * 3 + k]);
+	}
+
+	return result;
+}
+
+// inputs and outputs shared by all benchmarks for one mesh; outputs are allocated once so that runs don't measure allocation
+struct Data
+{
+	Mesh mesh;      // source mesh
+	Mesh optimized; // optimized for vertex cache and vertex fetch, which is the expected input for codecs and stripification
+
+	std::vector<Vertex> soup;
+
+	std::vector<unsigned int> indices;
+	std::vector<unsigned int> remap;
+	std::vector<unsigned char> buffer;
+	std::vector<Vertex> vertices;
+
+	std::vector<unsigned char> encoded_indices;
+	std::vector<unsigned char> encoded_vertices;
+};
+
+void prepareData(Data& data, const Mesh& mesh)
+{
+	data.mesh = mesh;
+
+	data.optimized = mesh;
+	meshopt_optimizeVertexCache(&data.optimized.indices[0], &data.optimized.indices[0], mesh.indices.size(), mesh.vertices.size());
+	meshopt_optimizeVertexFetch(&data.optimized.vertices[0], &data.optimized.indices[0], mesh.indices.size(), &data.optimized.vertices[0], mesh.vertices.size(), sizeof(Vertex));
+
+	data.soup.resize(mesh.indices.size());
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+		data.soup[i] = mesh.vertices[mesh.indices[i]];
+
+	// stripify needs up to 4 indices per triangle
+	data.indices.resize(mesh.indices.size() / 3 * 4);
+	data.remap.resize(data.soup.size());
+	data.vertices.resize(mesh.vertices.size());
+
+	size_t ibound = meshopt_encodeIndexBufferBound(mesh.indices.size(), mesh.vertices.size());
+	size_t vbound = meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(Vertex));
+
+	data.buffer.resize(std::max(ibound, vbound));
+
+	data.encoded_indices.resize(ibound);
+	data.encoded_indices.resize(meshopt_encodeIndexBuffer(&data.encoded_indices[0], ibound, &data.optimized.indices[0], mesh.indices.size()));
+
+	data.encoded_vertices.resize(vbound);
+	data.encoded_vertices.resize(meshopt_encodeVertexBuffer(&data.encoded_vertices[0], vbound, &data.optimized.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+}
+
+void runEncodeIndex(Data& data)
+{
+	meshopt_encodeIndexBuffer(&data.buffer[0], data.buffer.size(), &data.optimized.indices[0], data.optimized.indices.size());
+}
+
+void runDecodeIndex(Data& data)
+{
+	int rc = meshopt_decodeIndexBuffer(&data.indices[0], data.optimized.indices.size(), sizeof(unsigned int), &data.encoded_indices[0], data.encoded_indices.size());
+	(void)rc;
+}
+
+void runEncodeVertex(Data& data)
+{
+	meshopt_encodeVertexBuffer(&data.buffer[0], data.buffer.size(), &data.optimized.vertices[0], data.optimized.vertices.size(), sizeof(Vertex));
+}
+
+void runDecodeVertex(Data& data)
+{
+	int rc = meshopt_decodeVertexBuffer(&data.vertices[0], data.optimized.vertices.size(), sizeof(Vertex), &data.encoded_vertices[0], data.encoded_vertices.size());
+	(void)rc;
+}
+
+void runSimplify(Data& data)
+{
+	size_t target_index_count = data.mesh.indices.size() / 12 * 3;
+
+	meshopt_simplify(&data.indices[0], &data.mesh.indices[0], data.mesh.indices.size(), &data.mesh.vertices[0].px, data.mesh.vertices.size(), sizeof(Vertex), target_index_count, 1e-2f);
+}
+
+void runVertexCache(Data& data)
+{
+	meshopt_optimizeVertexCache(&data.indices[0], &data.mesh.indices[0], data.mesh.indices.size(), data.mesh.vertices.size());
+}
+
+void runVertexCacheFifo(Data& data)
+{
+	meshopt_optimizeVertexCacheFifo(&data.indices[0], &data.mesh.indices[0], data.mesh.indices.size(), data.mesh.vertices.size(), 16);
+}
+
+void runOverdraw(Data& data)
+{
+	meshopt_optimizeOverdraw(&data.indices[0], &data.optimized.indices[0], data.optimized.indices.size(), &data.optimized.vertices[0].px, data.optimized.vertices.size(), sizeof(Vertex), 1.05f);
+}
+
+void runAnalyzeOverdraw(Data& data)
+{
+	meshopt_analyzeOverdraw(&data.optimized.indices[0], data.optimized.indices.size(), &data.optimized.vertices[0].px, data.optimized.vertices.size(), sizeof(Vertex));
+}
+
+void runVertexFetch(Data& data)
+{
+	meshopt_optimizeVertexFetchRemap(&data.remap[0], &data.mesh.indices[0], data.mesh.indices.size(), data.mesh.vertices.size());
+}
+
+void runRemap(Data& data)
+{
+	meshopt_generateVertexRemap(&data.remap[0], NULL, data.soup.size(), &data.soup[0], data.soup.size(), sizeof(Vertex));
+}
+
+void runStripify(Data& data)
+{
+	meshopt_stripify(&data.indices[0], &data.optimized.indices[0], data.optimized.indices.size(), data.optimized.vertices.size());
+}
+
+void runStripifyCache(Data& data)
+{
+	meshopt_stripifyCache(&data.indices[0], &data.optimized.indices[0], data.optimized.indices.size(), data.optimized.vertices.size(), ~0u, 16, 1.05f);
+}
+
+enum Unit
+{
+	Unit_Bytes,
+	Unit_Triangles,
+};
+
+struct Benchmark
+{
+	const char* name;
+	void (*run)(Data& data);
+	Unit unit;
+};
+
+// codecs are measured by the size of the uncompressed data; everything else is measured by the number of source triangles
+const Benchmark kBenchmarks[] = {
+    {"encodeIndex", runEncodeIndex, Unit_Bytes},
+    {"decodeIndex", runDecodeIndex, Unit_Bytes},
+    {"encodeVertex", runEncodeVertex, Unit_Bytes},
+    {"decodeVertex", runDecodeVertex, Unit_Bytes},
+    {"simplify", runSimplify, Unit_Triangles},
+    {"vcache", runVertexCache, Unit_Triangles},
+    {"vcacheFifo", runVertexCacheFifo, Unit_Triangles},
+    {"overdraw", runOverdraw, Unit_Triangles},
+    {"analyzeOverdraw", runAnalyzeOverdraw, Unit_Triangles},
+    {"fetch", runVertexFetch, Unit_Triangles},
+    {"remap", runRemap, Unit_Triangles},
+    {"stripify", runStripify, Unit_Triangles},
+    {"stripifyCache", runStripifyCache, Unit_Triangles},
+};
+
+double getWork(const Benchmark& benchmark, const Data& data)
+{
+	if (benchmark.unit == Unit_Triangles)
+		return double(data.mesh.indices.size() / 3);
+
+	if (benchmark.run == runEncodeIndex || benchmark.run == runDecodeIndex)
+		return double(data.mesh.indices.size() * sizeof(unsigned int));
+	else
+		return double(data.mesh.vertices.size() * sizeof(Vertex));
+}
+
+struct Options
+{
+	int warmup;
+	int runs;
+	const char* filter;
+	bool json;
+	const char* baseline;
+	double threshold;
+};
+
+struct Result
+{
+	char mesh[256];
+	char benchmark[64];
+	double throughput; // millions of units per second, based on the median run time
+};
+
+// nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p)
+{
+	size_t rank = size_t(ceil(p * double(sorted.size())));
+
+	return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+void runBenchmarks(std::vector<Result>& results, const char* name, const Mesh& mesh, const Options& options)
+{
+	if (mesh.vertices.empty())
+		return;
+
+	Data data;
+	prepareData(data, mesh);
+
+	if (!options.json)
+		printf("# %s: %d vertices, %d triangles\n", name, int(mesh.vertices.size()), int(mesh.indices.size() / 3));
+
+	for (size_t i = 0; i < sizeof(kBenchmarks) / sizeof(kBenchmarks[0]); ++i)
+	{
+		const Benchmark& benchmark = kBenchmarks[i];
+
+		if (options.filter && !strstr(benchmark.name, options.filter))
+			continue;
+
+		for (int r = 0; r < options.warmup; ++r)
+			benchmark.run(data);
+
+		std::vector<double> times;
+
+		for (int r = 0; r < options.runs; ++r)
+		{
+			double start = timestamp();
+			benchmark.run(data);
+			double end = timestamp();
+
+			times.push_back(end - start);
+		}
+
+		std::sort(times.begin(), times.end());
+
+		double p50 = percentile(times, 0.5);
+		double p90 = percentile(times, 0.9);
+		double throughput = p50 > 0 ? getWork(benchmark, data) / p50 * 1e-6 : 0;
+
+		const char* unit = benchmark.unit == Unit_Bytes ? "MB/s" : "Mtri/s";
+
+		if (options.json)
+			printf("{\"mesh\":\"%s\",\"benchmark\":\"%s\",\"unit\":\"%s\",\"throughput\":%.3f,\"min_ms\":%.4f,\"p50_ms\":%.4f,\"p90_ms\":%.4f,\"runs\":%d}\n",
+			       name, benchmark.name, unit, throughput, times[0] * 1000, p50 * 1000, p90 * 1000, options.runs);
+		else
+			printf("%-16s: %9.2f %-6s (min %.3f ms, p50 %.3f ms, p90 %.3f ms)\n",
+			       benchmark.name, throughput, unit, times[0] * 1000, p50 * 1000, p90 * 1000);
+
+		Result result = {};
+		strncpy(result.mesh, name, sizeof(result.mesh) - 1);
+		strncpy(result.benchmark, benchmark.name, sizeof(result.benchmark) - 1);
+		result.throughput = throughput;
+
+		results.push_back(result);
+	}
+}
+
+// reads results written with -j; returns the number of regressions, or -1 if the baseline can't be read
+int compareBaseline(const std::vector<Result>& results, const char* path, double threshold)
+{
+	FILE* file = fopen(path, "r");
+
+	if (!file)
+	{
+		fprintf(stderr, "Error loading baseline %s\n", path);
+		return -1;
+	}
+
+	int regressions = 0;
+	char line[1024];
+
+	while (fgets(line, sizeof(line), file))
+	{
+		Result baseline = {};
+		char unit[16];
+
+		if (sscanf(line, "{\"mesh\":\"%255[^\"]\",\"benchmark\":\"%63[^\"]\",\"unit\":\"%15[^\"]\",\"throughput\":%lf", baseline.mesh, baseline.benchmark, unit, &baseline.throughput) != 4)
+			continue;
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& result = results[i];
+
+			if (strcmp(result.mesh, baseline.mesh) != 0 || strcmp(result.benchmark, baseline.benchmark) != 0)
+				continue;
+
+			double change = baseline.throughput > 0 ? result.throughput / baseline.throughput - 1 : 0;
+
+			if (change < -threshold)
+			{
+				fprintf(stderr, "Regression: %s %s %.2f => %.2f %s (%+.1f%%)\n", result.mesh, result.benchmark, baseline.throughput, result.throughput, unit, change * 100);
+				regressions++;
+			}
+		}
+	}
+
+	fclose(file);
+
+	return regressions;
+}
+
+int main(int argc, char** argv)
+{
+	Options options = {2, 15, NULL, false, NULL, 0.1};
+	std::vector<const char*> paths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+
+		if (strcmp(arg, "-w") == 0 && i + 1 < argc)
+			options.warmup = atoi(argv[++i]);
+		else if (strcmp(arg, "-n") == 0 && i + 1 < argc)
+			options.runs = std::max(1, atoi(argv[++i]));
+		else if (strcmp(arg, "-f") == 0 && i + 1 < argc)
+			options.filter = argv[++i];
+		else if (strcmp(arg, "-j") == 0)
+			options.json = true;
+		else if (strcmp(arg, "-b") == 0 && i + 1 < argc)
+			options.baseline = argv[++i];
+		else if (strcmp(arg, "-t") == 0 && i + 1 < argc)
+			options.threshold = atof(argv[++i]) / 100;
+		else if (arg[0] == '-')
+		{
+			printf("Usage: %s [-w warmup runs] [-n runs] [-f benchmark filter] [-j] [-b baseline.json] [-t threshold %%] [.obj files]\n", argv[0]);
+			printf("-j prints one JSON object per line; -b compares throughput against a previous -j output and fails if it drops by more than the threshold (10%% by default)\n");
+			return 1;
+		}
+		else
+			paths.push_back(arg);
+	}
+
+	std::vector<Result> results;
+
+	runBenchmarks(results, "terrain", generateTerrain(300), options);
+	runBenchmarks(results, "sphere", generateSphere(128), options);
+
+	for (size_t i = 0; i < paths.size(); ++i)
+		runBenchmarks(results, paths[i], parseObj(paths[i]), options);
+
+	if (options.baseline)
+	{
+		int regressions = compareBaseline(results, options.baseline, options.threshold);
+
+		if (regressions != 0)
+			return 1;
+	}
+
+	return 0;
+}
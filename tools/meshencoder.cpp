@@ -10,6 +10,7 @@
 #include <cfloat>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <vector>
 
@@ -175,6 +176,23 @@ void packMesh(std::vector<PackedVertexOct>& pv, const std::vector<Vertex>& verti
 	}
 }
 
+void computeBounds(float* minp, float* maxp, const std::vector<Vertex>& vertices)
+{
+	minp[0] = minp[1] = minp[2] = +FLT_MAX;
+	maxp[0] = maxp[1] = maxp[2] = -FLT_MAX;
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		minp[0] = std::min(minp[0], vertices[i].px);
+		minp[1] = std::min(minp[1], vertices[i].py);
+		minp[2] = std::min(minp[2], vertices[i].pz);
+
+		maxp[0] = std::max(maxp[0], vertices[i].px);
+		maxp[1] = std::max(maxp[1], vertices[i].py);
+		maxp[2] = std::max(maxp[2], vertices[i].pz);
+	}
+}
+
 #ifdef WITH_ZSTD
 template <typename T>
 std::vector<unsigned char> compress(const std::vector<T>& v)
@@ -189,17 +207,29 @@ int main(int argc, char** argv)
 {
 	if (argc == 1)
 	{
-		printf("Usage: %s [.obj file]\n", argv[0]);
+		printf("Usage: %s [-o container] [.obj file]\n", argv[0]);
 		return 1;
 	}
 
 	int bitsp = 14;
 	int bitst = 12;
 
+	const char* output = NULL;
+
+	// encoded buffers of all meshes are collected into one container so that each mesh can be decoded on demand
+	std::vector<meshopt_ContainerChunk> chunks;
+	std::vector<std::vector<unsigned char> > chunk_data;
+
 	for (int i = 1; i < argc; ++i)
 	{
 		const char* path = argv[i];
 
+		if (strcmp(path, "-o") == 0 && i + 1 < argc)
+		{
+			output = argv[++i];
+			continue;
+		}
+
 		Mesh mesh = parseObj(path);
 
 		if (mesh.vertices.empty())
@@ -253,7 +283,7 @@ int main(int argc, char** argv)
 		{
 			double start = timestamp();
 			int dvb = meshopt_decodeVertexBuffer(&vbd[0], vbd.size(), sizeof(PV), &vbuf[0], vbuf.size());
-			int dib = meshopt_decodeIndexBuffer(&ibd[0], ibd.size(), &ibuf[0], ibuf.size());
+			int dib = meshopt_decodeIndexBuffer(&ibd[0], ibd.size(), sizeof(unsigned int), &ibuf[0], ibuf.size());
 			assert(dvb == 0 && dib == 0);
 			double end = timestamp();
 
@@ -275,7 +305,7 @@ int main(int argc, char** argv)
 			ZSTD_decompress(&scratch[0], scratch.size(), &vbz[0], vbz.size());
 			int dvbz = meshopt_decodeVertexBuffer(&vbd[0], vbd.size(), sizeof(PV), &scratch[0], vbuf.size());
 			ZSTD_decompress(&scratch[0], scratch.size(), &ibz[0], ibz.size());
-			int dibz = meshopt_decodeIndexBuffer(&ibd[0], ibd.size(), &scratch[0], ibuf.size());
+			int dibz = meshopt_decodeIndexBuffer(&ibd[0], ibd.size(), sizeof(unsigned int), &scratch[0], ibuf.size());
 			assert(dvbz == 0 && dibz == 0);
 			double end = timestamp();
 
@@ -286,5 +316,37 @@ int main(int argc, char** argv)
 			       (end - start) * 1000);
 		}
 #endif
+
+		meshopt_ContainerChunk vc = {meshopt_ChunkVertexBuffer, 0, unsigned(pv.size()), sizeof(PV), 0, unsigned(vbuf.size()), {}, {}};
+		meshopt_ContainerChunk ic = {meshopt_ChunkIndexBuffer, 0, unsigned(mesh.indices.size()), 0, 0, unsigned(ibuf.size()), {}, {}};
+
+		computeBounds(vc.bounds_min, vc.bounds_max, mesh.vertices);
+		computeBounds(ic.bounds_min, ic.bounds_max, mesh.vertices);
+
+		chunks.push_back(vc);
+		chunk_data.push_back(vbuf);
+		chunks.push_back(ic);
+		chunk_data.push_back(ibuf);
+	}
+
+	if (output && !chunks.empty())
+	{
+		std::vector<const unsigned char*> data(chunks.size());
+		for (size_t i = 0; i < chunks.size(); ++i)
+			data[i] = &chunk_data[i][0];
+
+		std::vector<unsigned char> container(meshopt_encodeContainerBound(&chunks[0], chunks.size()));
+		container.resize(meshopt_encodeContainer(&container[0], container.size(), &chunks[0], &data[0], chunks.size()));
+
+		FILE* file = fopen(output, "wb");
+		if (!file || fwrite(&container[0], 1, container.size(), file) != container.size())
+		{
+			printf("Error writing %s\n", output);
+			return 2;
+		}
+
+		fclose(file);
+
+		printf("container  : %s, %d chunks, %d bytes\n", output, int(chunks.size()), int(container.size()));
 	}
 }